@@ -0,0 +1,299 @@
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "object3D.h"
+#include "adjacency.h"
+
+// Smallest number of vertices ordered by each thread.
+#define MIN_VERTICES_PER_THREAD		4096
+
+// A range of vertices whose faces are ordered by one thread.
+typedef struct
+{
+	objectPtr	object_data;
+	int			first;
+	int			last;
+} adjacencyChunkStruct;
+
+typedef adjacencyChunkStruct* adjacencyChunkPtr;
+
+
+// Get the faces around a vertex, as indices into the faceArray.
+int* get_vertex_face_indices (objectPtr object_data, int vertex_index)
+{
+	return (&object_data->vertexFaceIndices[object_data->vertexFaceOffsets[vertex_index]]);
+}
+
+
+// Order an array of faces around a vertex in CCW orientation.
+// Begins with the first face in the array, and then adds the
+//  faces that continue the fan after its last face or before
+//  its first one, searching cyclically through the faces left.
+// Faces that can not be joined to the fan (around non manifold
+//  vertices) are left at the end, in their original order.
+void order_vertex_faces (int* face_indices, int num_faces, facePtr face_array, int vertex_index)
+{
+	int*		remaining = NULL;
+	int*		ordered = NULL;
+	int			num_remaining = num_faces - 1;
+	int			first = num_faces;
+	int			last = num_faces;
+	int			position;
+	int			misses = 0;
+	int			next_vertex;
+	int			previous_vertex;
+	int			i;
+	faceStruct	face;
+
+	if (num_faces < 2)
+		return;
+
+	// The fan grows in both directions inside an array
+	//  twice as long as the number of faces.
+	remaining = (int*) xmalloc (sizeof (int) * 3 * num_faces);
+	ordered = remaining + num_faces;
+
+	memcpy (remaining, face_indices + 1, sizeof (int) * num_remaining);
+
+	// Insert a face to begin with.
+	face = face_array[face_indices[0]];
+	reorderFace (&face, vertex_index);
+	ordered[first] = face_indices[0];
+	last++;
+
+	// Set the variables for the faces that should
+	//  be inserted before or after the current fan.
+	next_vertex = face.vertex[2];
+	previous_vertex = face.vertex[1];
+
+	for (i=0; num_remaining > 0 && misses < num_remaining; i++)
+	{
+		position = i % num_remaining;
+		face = face_array[remaining[position]];
+		reorderFace (&face, vertex_index);
+
+		// Insert a face at the end of the fan.
+		if (face.vertex[1] == next_vertex)
+		{
+			next_vertex = face.vertex[2];
+			ordered[last++] = remaining[position];
+		}
+		// Insert a face at the beginning of the fan.
+		else if (face.vertex[2] == previous_vertex)
+		{
+			previous_vertex = face.vertex[1];
+			ordered[--first] = remaining[position];
+		}
+		else
+		{
+			misses++;
+			continue;
+		}
+
+		num_remaining--;
+		memmove (&remaining[position], &remaining[position+1], sizeof (int) * (num_remaining - position));
+		misses = 0;
+	}
+
+	memcpy (face_indices, &ordered[first], sizeof (int) * (last - first));
+	memcpy (face_indices + (last - first), remaining, sizeof (int) * num_remaining);
+
+	free (remaining);
+}
+
+
+// Rotate the vertices of the faces around a vertex, so that
+//  it is the first vertex of each of them.
+void rotate_faces_to_vertex (int* face_indices, int num_faces, facePtr face_array, int vertex_index)
+{
+	int			i;
+
+	for (i=0; i<num_faces; i++)
+		reorderFace (&face_array[face_indices[i]], vertex_index);
+}
+
+
+// Thread function to order the faces of a range of vertices.
+static void* orderChunk (void* argument)
+{
+	adjacencyChunkPtr	chunk = (adjacencyChunkPtr) argument;
+	objectPtr			object_data = chunk->object_data;
+	int					i;
+
+	for (i=chunk->first; i<=chunk->last; i++)
+		order_vertex_faces (get_vertex_face_indices (object_data, i), object_data->facesPerVertex[i], object_data->faceArray, i);
+
+	return (NULL);
+}
+
+
+// Build the compressed array of the faces around each vertex.
+// The faces of vertex 'i' are stored one after the other,
+//  beginning at 'vertexFaceOffsets[i]'.
+// They are first stored in the opposite order of their
+//  definition, and then ordered in CCW orientation.
+// The vertices are ordered in parallel, since the faces
+//  are not modified.
+void build_vertex_face_adjacency (objectPtr object_data)
+{
+	int					num_vertices = object_data->numVertices;
+	int					num_faces = object_data->numFaces;
+	int*				offsets = NULL;
+	int*				counts = NULL;
+	int*				indices = NULL;
+	int					num_chunks;
+	int					i;
+	int					j;
+	int					vertex_index;
+	facePtr				face = NULL;
+	adjacencyChunkPtr	chunks = NULL;
+
+	counts = (int*) xmalloc (sizeof (int) * (num_vertices + 1));
+	offsets = (int*) xmalloc (sizeof (int) * (num_vertices + 2));
+	memset (counts, 0, sizeof (int) * (num_vertices + 1));
+
+	for (i=1; i<=num_faces; i++)
+	{
+		face = &object_data->faceArray[i];
+		for (j=0; j<face->faceVertices; j++)
+			counts[face->vertex[j]]++;
+	}
+
+	offsets[0] = 0;
+	offsets[1] = 0;
+	for (i=1; i<=num_vertices; i++)
+		offsets[i+1] = offsets[i] + counts[i];
+
+	indices = (int*) xmalloc (sizeof (int) * (offsets[num_vertices+1] + 1));
+
+	// Fill each vertex from the end, so that the last
+	//  face defined comes first.
+	for (i=1; i<=num_faces; i++)
+	{
+		face = &object_data->faceArray[i];
+		for (j=0; j<face->faceVertices; j++)
+		{
+			vertex_index = face->vertex[j];
+			indices[offsets[vertex_index] + (--counts[vertex_index])] = face->faceId;
+		}
+	}
+
+	for (i=1; i<=num_vertices; i++)
+		counts[i] = offsets[i+1] - offsets[i];
+
+	object_data->vertexFaceOffsets = offsets;
+	object_data->vertexFaceIndices = indices;
+	object_data->vertexFaceLength = offsets[num_vertices+1];
+	object_data->vertexFaceCapacity = offsets[num_vertices+1] + 1;
+	object_data->facesPerVertex = counts;
+	object_data->vertexFaceArray = NULL;
+
+	num_chunks = getNumThreads ();
+	if (num_chunks > num_vertices / MIN_VERTICES_PER_THREAD)
+		num_chunks = num_vertices / MIN_VERTICES_PER_THREAD;
+	if (num_chunks < 1)
+		num_chunks = 1;
+
+	chunks = (adjacencyChunkPtr) xmalloc (sizeof (adjacencyChunkStruct) * num_chunks);
+	for (i=0; i<num_chunks; i++)
+	{
+		chunks[i].object_data = object_data;
+		chunks[i].first = 1 + (int) ((long long) num_vertices * i / num_chunks);
+		chunks[i].last = (int) ((long long) num_vertices * (i + 1) / num_chunks);
+	}
+
+	runInThreads (orderChunk, chunks, sizeof (adjacencyChunkStruct), num_chunks);
+
+	free (chunks);
+}
+
+
+// Replace the faces around a vertex with those in a list.
+// The faces are stored in the same place when they fit, or
+//  else at the end of the array, which grows as needed.
+// The number of faces of the vertex is updated.
+void set_vertex_faces (objectPtr object_data, int vertex_index, nodePtr face_list)
+{
+	int			num_faces = getListLength (face_list);
+	int*		indices = NULL;
+	nodePtr		pointer = NULL;
+
+	if (num_faces > object_data->facesPerVertex[vertex_index])
+	{
+		if (object_data->vertexFaceLength + num_faces > object_data->vertexFaceCapacity)
+		{
+			object_data->vertexFaceCapacity = 2 * object_data->vertexFaceCapacity + num_faces;
+			object_data->vertexFaceIndices = (int*) realloc (object_data->vertexFaceIndices, sizeof (int) * object_data->vertexFaceCapacity);
+			if (object_data->vertexFaceIndices == NULL)
+			{
+				printf ("Unable to allocate memory. Exiting.\n");
+				exit (1);
+			}
+		}
+
+		object_data->vertexFaceOffsets[vertex_index] = object_data->vertexFaceLength;
+		object_data->vertexFaceLength += num_faces;
+	}
+
+	indices = get_vertex_face_indices (object_data, vertex_index);
+	for (pointer = face_list; pointer != NULL; pointer = pointer->next)
+		*(indices++) = *(int*) pointer->data;
+
+	object_data->facesPerVertex[vertex_index] = num_faces;
+}
+
+
+// Create the lists of faces around each vertex, in the
+//  same order as in the compressed array.
+// Returns an array of lists, indexed beginning with 1.
+nodePtr* build_vertex_face_lists (objectPtr object_data)
+{
+	nodePtr*	vertex_face_array = NULL;
+	nodePtr		tail = NULL;
+	int*		indices = NULL;
+	int			i;
+	int			j;
+
+	vertex_face_array = (nodePtr*) xmalloc (sizeof (nodePtr) * (object_data->numVertices + 1));
+	vertex_face_array[0] = NULL;
+
+	for (i=1; i<=object_data->numVertices; i++)
+	{
+		vertex_face_array[i] = NULL;
+		tail = NULL;
+		indices = get_vertex_face_indices (object_data, i);
+		for (j=0; j<object_data->facesPerVertex[i]; j++)
+		{
+			tail = addNode (tail, createIntPointer (indices[j]));
+			if (vertex_face_array[i] == NULL)
+				vertex_face_array[i] = tail;
+		}
+	}
+
+	return (vertex_face_array);
+}
+
+
+// Release the memory of the adjacency arrays and lists.
+void free_vertex_face_adjacency (objectPtr object_data)
+{
+	int			i;
+
+	if (object_data->vertexFaceArray != NULL)
+	{
+		for (i=1; i<=object_data->numVertices; i++)
+			freeList (object_data->vertexFaceArray[i]);
+		free (object_data->vertexFaceArray);
+	}
+
+	free (object_data->vertexFaceOffsets);
+	free (object_data->vertexFaceIndices);
+	free (object_data->facesPerVertex);
+
+	object_data->vertexFaceArray = NULL;
+	object_data->vertexFaceOffsets = NULL;
+	object_data->vertexFaceIndices = NULL;
+	object_data->facesPerVertex = NULL;
+}
@@ -0,0 +1,25 @@
+// Build the compressed array of the faces around each vertex,
+//  with the faces of every vertex in CCW order.
+// Also fills the array 'facesPerVertex'.
+void build_vertex_face_adjacency (objectPtr object_data);
+
+// Get the faces around a vertex, as indices into the faceArray.
+// There are 'facesPerVertex[vertex_index]' of them.
+int* get_vertex_face_indices (objectPtr object_data, int vertex_index);
+
+// Order an array of faces around a vertex in CCW orientation.
+void order_vertex_faces (int* face_indices, int num_faces, facePtr face_array, int vertex_index);
+
+// Rotate the vertices of the faces around a vertex, so that
+//  it is the first vertex of each of them.
+void rotate_faces_to_vertex (int* face_indices, int num_faces, facePtr face_array, int vertex_index);
+
+// Replace the faces around a vertex with those in a list.
+void set_vertex_faces (objectPtr object_data, int vertex_index, nodePtr face_list);
+
+// Create the lists of faces around each vertex, used
+//  where the faces around vertices change.
+nodePtr* build_vertex_face_lists (objectPtr object_data);
+
+// Release the memory of the adjacency arrays and lists.
+void free_vertex_face_adjacency (objectPtr object_data);
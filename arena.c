@@ -0,0 +1,147 @@
+#include "tools.h"
+#include "arena.h"
+
+// Size of the first block of an arena.
+#define ARENA_BLOCK_SIZE	(64 * 1024)
+
+// Alignment of the memory handed out.
+#define ARENA_ALIGNMENT		16
+
+
+// Arena for the temporary memory.
+// Each thread selects its own.
+static __thread arenaPtr	ScratchArena = NULL;
+
+
+// Add an empty block in front of the others.
+// Its size is at least the size requested, and
+//  twice the size of the previous block.
+static arenaBlockPtr add_arena_block (arenaPtr arena, size_t size)
+{
+	arenaBlockPtr	block = NULL;
+	size_t			block_size = ARENA_BLOCK_SIZE;
+
+	if (arena->blocks != NULL)
+		block_size = 2 * arena->blocks->size;
+	if (block_size < size)
+		block_size = size;
+
+	block = (arenaBlockPtr) xmalloc (sizeof (arenaBlockStruct));
+	block->data = (char*) xmalloc (block_size);
+	block->size = block_size;
+	block->used = 0;
+	block->next = arena->blocks;
+	arena->blocks = block;
+
+	return (block);
+}
+
+
+// Get memory from an arena.
+// Adds a new block when the current one is full.
+void* arena_alloc (arenaPtr arena, size_t size)
+{
+	arenaBlockPtr	block = arena->blocks;
+	void*			pointer = NULL;
+
+	size = (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+
+	if ( (block == NULL) || (block->used + size > block->size) )
+		block = add_arena_block (arena, size);
+
+	pointer = block->data + block->used;
+	block->used += size;
+	arena->total += size;
+
+	return (pointer);
+}
+
+
+// Check whether a pointer was given by an arena.
+boolean arena_contains (arenaPtr arena, void* pointer)
+{
+	arenaBlockPtr	block = NULL;
+
+	for (block=arena->blocks; block!=NULL; block=block->next)
+	{
+		if ( ((char*) pointer >= block->data) && ((char*) pointer < block->data + block->size) )
+			return (TRUE);
+	}
+
+	return (FALSE);
+}
+
+
+// Release all the memory given by an arena, so
+//  that it can be handed out again.
+// When more than one block was needed, they are replaced
+//  by a single one large enough for all the memory used.
+void arena_reset (arenaPtr arena)
+{
+	size_t		total = arena->total;
+
+	if ( (arena->blocks != NULL) && (arena->blocks->next != NULL) )
+	{
+		arena_free (arena);
+		add_arena_block (arena, total);
+	}
+	else if (arena->blocks != NULL)
+		arena->blocks->used = 0;
+
+	arena->total = 0;
+}
+
+
+// Return the blocks of an arena to the system.
+void arena_free (arenaPtr arena)
+{
+	arenaBlockPtr	block = arena->blocks;
+	arenaBlockPtr	next = NULL;
+
+	while (block != NULL)
+	{
+		next = block->next;
+		free (block->data);
+		free (block);
+		block = next;
+	}
+
+	arena->blocks = NULL;
+	arena->total = 0;
+}
+
+
+// Select the arena used for temporary memory.
+// With NULL, temporary memory comes from the heap.
+// Returns the arena selected before.
+arenaPtr set_scratch_arena (arenaPtr arena)
+{
+	arenaPtr	previous = ScratchArena;
+
+	ScratchArena = arena;
+
+	return (previous);
+}
+
+
+// Get temporary memory, from the arena selected,
+//  or from the heap if there is none.
+void* scratch_malloc (size_t size)
+{
+	if (ScratchArena != NULL)
+		return (arena_alloc (ScratchArena, size));
+	else
+		return (xmalloc (size));
+}
+
+
+// Release memory from 'scratch_malloc', or from 'xmalloc'.
+// Memory of the arena selected is kept until the arena
+//  is reset.
+void scratch_free (void* pointer)
+{
+	if ( (ScratchArena != NULL) && arena_contains (ScratchArena, pointer) )
+		return;
+
+	free (pointer);
+}
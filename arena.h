@@ -0,0 +1,58 @@
+// Data structures
+
+// BLOCK OF MEMORY OF AN ARENA
+typedef struct arenaBlockStruct
+{
+	struct arenaBlockStruct*	next;
+	size_t						size;
+	size_t						used;
+	char*						data;
+} arenaBlockStruct;
+
+typedef arenaBlockStruct* arenaBlockPtr;
+
+// ARENA
+// Memory handed out in order from large blocks,
+//  and released all at once.
+// An arena filled with zeros is empty and ready to use.
+typedef struct arenaStruct
+{
+	// The block in use is the first one.
+	arenaBlockPtr	blocks;
+	// Memory used in all the blocks.
+	size_t			total;
+} arenaStruct;
+
+typedef arenaStruct* arenaPtr;
+
+
+// Function declarations
+
+// Get memory from an arena.
+// Adds a new block when the current one is full.
+void* arena_alloc (arenaPtr arena, size_t size);
+
+// Check whether a pointer was given by an arena.
+boolean arena_contains (arenaPtr arena, void* pointer);
+
+// Release all the memory given by an arena, so
+//  that it can be handed out again.
+void arena_reset (arenaPtr arena);
+
+// Return the blocks of an arena to the system.
+void arena_free (arenaPtr arena);
+
+// Select the arena used for temporary memory by the
+//  calling thread.
+// With NULL, temporary memory comes from the heap.
+// Returns the arena selected before.
+arenaPtr set_scratch_arena (arenaPtr arena);
+
+// Get temporary memory, from the arena selected,
+//  or from the heap if there is none.
+void* scratch_malloc (size_t size);
+
+// Release memory from 'scratch_malloc', or from 'xmalloc'.
+// Memory of the arena selected is kept until the arena
+//  is reset.
+void scratch_free (void* pointer);
@@ -2,6 +2,7 @@
 #include <math.h>
 
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 #include "vertices.h"
 #include "geometry.h"
@@ -21,7 +22,7 @@ nodePtr compute_3D_Convex_Hull (vertexPtr vertexArray, int numVertices)
 	vertexPtr		tempVertexArray = NULL;
 
 	// Copy the array of vertices.
-	tempVertexArray = (vertexPtr) xmalloc (sizeof (vertexStruct) * (numVertices + 1));
+	tempVertexArray = (vertexPtr) scratch_malloc (sizeof (vertexStruct) * (numVertices + 1));
 	memcpy (tempVertexArray, vertexArray, sizeof (vertexStruct) * (numVertices + 1));
 
 	// Order the vertices by X, Y and Z coordinates.
@@ -29,7 +30,7 @@ nodePtr compute_3D_Convex_Hull (vertexPtr vertexArray, int numVertices)
 	// Make simple convex hull with only 4 vertices.
 	convexHull = compute_initial_hull (tempVertexArray, numVertices, vertexArray);
 	// Sorted array no longer needed.
-	free (tempVertexArray);
+	scratch_free (tempVertexArray);
 
 	// Add the rest of the vertices to the hull.
 	// Skip the first and last vertices, since they
@@ -92,9 +93,8 @@ int add_vertex_to_convex_hull (int vertex_index, vertexPtr vertexArray, nodePtr
 	int			outside = 0;
 	double		dot;
 	facePtr		face = NULL;
-	vectorPtr	faceNormal = NULL;
-	vectorPtr	vertexVector = NULL;
-	// vectorPtr	vertexVector = (vectorPtr) xmalloc (sizeof (vectorStruct));
+	vectorStruct	faceNormal;
+	vectorStruct	vertexVector;
 	nodePtr		edgeList = NULL;
 
 	for (i=0; i<listLenght; i++)
@@ -103,13 +103,11 @@ int add_vertex_to_convex_hull (int vertex_index, vertexPtr vertexArray, nodePtr
 		v1 = face->vertex[0];
 		v2 = face->vertex[1];
 		v3 = face->vertex[2];
-		faceNormal = getTriangleNormal (vertexArray[v1], vertexArray[v2], vertexArray[v3]);
+		faceNormal = triangle_normal (&vertexArray[v1], &vertexArray[v2], &vertexArray[v3]);
 
-		vertexVector = vectorFromVertices (&(vertexArray[v1]), &vertexArray[vertex_index]);
+		vertexVector = vector_from_vertices (&(vertexArray[v1]), &vertexArray[vertex_index]);
 
-		dot = dotProduct (faceNormal, vertexVector);
-		free (faceNormal);
-		free (vertexVector);
+		dot = dotProduct (&faceNormal, &vertexVector);
 
 		// If the dot product is positive, then the new vertex
 		//  is outside of the hull and can see this face.
@@ -122,7 +120,7 @@ int add_vertex_to_convex_hull (int vertex_index, vertexPtr vertexArray, nodePtr
 
 			// Remove the face that will lie inside of the C.H.
 			face = removeNode (convexHull, i);
-			free (face);
+			scratch_free (face);
 			listLenght--;
 			i--;
 		}
@@ -192,7 +190,7 @@ void update_visible_edges (nodePtr* edgeList, int v1, int v2, int v3)
 		if (delete)
 		{
 			edge = removeNode (edgeList, i);
-			free (edge);
+			scratch_free (edge);
 			edgeListLength--;
 			i--;
 		}
@@ -229,8 +227,8 @@ nodePtr compute_initial_hull (vertexPtr vertexArray, int numVertices, vertexPtr
 	vertexStruct	vertex_N;
 	vertexStruct	vertex_S;
 	vertexStruct	real_vertex;
-	vectorPtr		testVector1 = NULL;
-	vectorPtr		testVector2 = NULL;
+	vectorStruct	testVector1;
+	vectorStruct	testVector2;
 	facePtr			face1;
 	facePtr			face2;
 	facePtr			face3;
@@ -275,13 +273,10 @@ nodePtr compute_initial_hull (vertexPtr vertexArray, int numVertices, vertexPtr
 	vertex_N = vertexArray[N_index];
 	vertex_S = vertexArray[S_index];
 
-	testVector1 = vectorFromVertices (&vertex_W, &vertex_E);
-	testVector2 = getTriangleNormal (vertex_E, vertex_N, vertex_S);
+	testVector1 = vector_from_vertices (&vertex_W, &vertex_E);
+	testVector2 = triangle_normal (&vertex_E, &vertex_N, &vertex_S);
 
-	dot = dotProduct (testVector1, testVector2);
-
-	free (testVector1);
-	free (testVector2);
+	dot = dotProduct (&testVector1, &testVector2);
 
 	if (dot < 0)
 	{
@@ -379,7 +374,7 @@ int* newTuple (int one, int two)
 {
 	int*			tuple;
 
-	tuple = (int*) xmalloc (sizeof (int) * 2);
+	tuple = (int*) scratch_malloc (sizeof (int) * 2);
 
 	tuple[0] = one;
 	tuple[1] = two;
@@ -1,16 +1,19 @@
 #include <stdio.h>
 
 #include "gaussMap.h"
+#include "decimator.h"
 
 #define CURVATURE	curvature
 // #define CURVATURE	angle_deficit
 
+#ifndef HEADLESS
 // External functions
 extern int glMain ();
 
 void gl_remove_lists (int removed_vertex_id);
 void gl_update_lists (int removed_vertex_id);
 void gl_create_display_lists ();
+#endif
 
 // External variables
 extern objectStruct			ObjectData;
@@ -20,17 +23,21 @@ extern int					ShowVertex;
 // Function declarations
 void get_file_name (char* input_file);
 void usage (char* programName);
-void sort_vertices_by_decimation_parameter (void);
 void update_sorted_decimation_array (int vertex_index);
 double get_vertex_decimation_parameter (int vertex_index);
 int get_vertex_with_minimum_curvature (void);
 void visual_vertex_decimation (void);
+void write_decimated_files (void);
 int remove_minimal_curvature_vertex (void);
 
 // New functions for half edge collapse.
 int find_closest_vertex (int removed_vertex_id, vertexDataStruct current_vertex_data);
 nodePtr update_neighbour_triangles (int merge_vertex_id, int removed_vertex_id, vertexDataStruct current_vertex_data);
 
+// Functions to find the edges around a removed vertex.
+nodePtr get_inner_edge_list (nodePtr triangle_list, int num_triangles, int* num_edges);
+void clear_half_edge_edges (nodePtr triangle_list, int num_triangles);
+
 // Functions to check the initial triangulation.
 void validate_edges (nodePtr* triangle_list, int num_triangles);
 boolean validate_edge_flip (edgePtr edge, facePtr face_1, facePtr face_2);
@@ -40,25 +47,16 @@ void minimise_triangulation_curvature (nodePtr triangle_list, int num_triangles,
 // void minimise_triangulation_curvature (nodePtr triangle_list, int num_triangles);
 double get_edge_curvature (edgePtr edge, faceStruct face_1, faceStruct face_2);
 void execute_edge_flip (edgePtr edge, facePtr face_1, facePtr face_2, boolean inverted);
-boolean check_existing_faces (int test_vertex, edgePtr edge);
+boolean check_existing_faces (edgePtr edge);
 void update_face_normal_vector (facePtr face);
+void update_flipped_edges (faceStruct face_1, faceStruct face_2);
+void update_flipped_edge (edgePtr edge, int face_id, int opposite_vertex, faceStruct face_1, faceStruct face_2);
 void update_flip_vertex_data (edgePtr edge);
 void recompute_edge_vertex_curvature (edgePtr edge);
 void register_face_changes (facePtr face);
 
 double get_link_curvature (int vertexId, vertexDataStruct current_vertex_data);
 
-
-// Data structure to hold decimation parameter
-typedef struct decimationDataStruct
-{
-	int		vertexId;
-	double	decimation_parameter;
-} decimationDataStruct;
-
-typedef decimationDataStruct* decimationDataPtr;
-
-
 // Global variables
 char*				File_Name = NULL;
 int					Removal_count = 0;
@@ -67,13 +65,24 @@ int*				Sorted_vertex_index_array = NULL;
 double				Max_parameter = 0.0;
 decimationDataPtr	Curvature_sorted_array = NULL;
 
+// Topology of the mesh, kept up to date with each
+//  removal and edge flip.
+halfEdgeMeshStruct	Half_edge_mesh;
+// Edge of the current list of edges to flip that
+//  lies on each half edge, or NULL.
+edgePtr*			Half_edge_edges = NULL;
+
 
+#ifndef GAUSSMAP_LIBRARY
 // Program entry point
 int main (int argc, char* argv[])
 {
 	char		inputFile[60];
 	time_t		start;
 	time_t		stop;
+#ifdef HEADLESS
+	double		remaining_percent = 50.0;
+#endif
 
 	if (argc < 2)
 	{
@@ -83,8 +92,13 @@ int main (int argc, char* argv[])
 
 	strcpy (inputFile, argv[1]);
 
+#ifdef HEADLESS
+	if (argc == 3)
+		remaining_percent = atof(argv[2]);
+#else
 	if (argc == 3)
 		ShowVertex = atoi(argv[2]);
+#endif
 
 	get_file_name (inputFile);
 
@@ -102,6 +116,8 @@ int main (int argc, char* argv[])
 	(void) time (&stop);
 	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
 
+	start_decimation ();
+
 	if (ShowVertex == 0)
 	{
 		////////	SORT VERTICES BY CURVATURE	////////
@@ -114,13 +130,24 @@ int main (int argc, char* argv[])
 
 // remove_minimal_curvature_vertex ();
 
+#ifdef HEADLESS
+	////////	DECIMATION WITHOUT DISPLAY	////////
+	printf ("\n[STAGE 4] -- DECIMATING TO %.2lf%% OF THE VERTICES\n", remaining_percent); fflush (stdout);
+	(void) time (&start);
+	headless_vertex_decimation (remaining_percent);
+	write_decimated_files ();
+	(void) time (&stop);
+	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
+#else
 	////////	RENDERING WITH OpenGL	////////
 	printf ("\n[STAGE 4] -- GRAPHICAL DISPLAY\n"); fflush (stdout);
 	(void) time (&start);
 	glMain ();
 	(void) time (&stop);
 	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
+#endif
 
+	free_decimation ();
 	freeObjectMemory ();
 
 	return (0);
@@ -130,22 +157,103 @@ int main (int argc, char* argv[])
 // Prints information about the arguments to supply to the program.
 void usage (char* programName)
 {
+#ifdef HEADLESS
+	printf ("Usage: %s [input file name] [percentage of vertices to keep]\n", programName);
+#else
 	printf ("Usage: %s [input file name]\n", programName);
+#endif
 	exit (1);
 }
 
 void get_file_name (char* input_file)
 {
 	size_t			length;
+	char*			extension;
+
+	// Data read from stdin has no name to use.
+	if (!strcmp (input_file, "-"))
+		input_file = "stdin.obj";
 
 	length = strlen (input_file);
 	File_Name = (char*) xmalloc (sizeof (char) * (length + 1));
+	strcpy (File_Name, input_file);
+
+	// Remove the '.gz' suffix of compressed files,
+	//  and then the extension.
+	if ( (length > 3) && !strcasecmp (File_Name + length - 3, ".gz") )
+		File_Name[length - 3] = '\0';
+
+	extension = strrchr (File_Name, '.');
+	if ( (extension != NULL) && (strchr (extension, '/') == NULL) )
+		*extension = '\0';
+}
+#endif
+
+
+// Build the structures used to remove vertices from the object.
+void start_decimation (void)
+{
+	Removal_count = 0;
+	Removal_index = 1;
+
+	// The faces around the vertices change with each removal,
+	//  so they are also kept in lists while decimating.
+	ObjectData.vertexFaceArray = build_vertex_face_lists (&ObjectData);
+
+	// The half edges are used to find the edges around
+	//  the removed vertices, and to update them after flips.
+	Half_edge_mesh = build_half_edge_mesh (ObjectData);
+	Half_edge_edges = (edgePtr*) xmalloc (sizeof (edgePtr) * 3 * (ObjectData.numFaces + 1));
+	memset (Half_edge_edges, 0, sizeof (edgePtr) * 3 * (ObjectData.numFaces + 1));
+}
+
+
+// Release the memory used for the decimation.
+void free_decimation (void)
+{
+	free_half_edge_mesh (&Half_edge_mesh);
+	free (Half_edge_edges);
+	free (Curvature_sorted_array);
+	free (Sorted_vertex_index_array);
+
+	Half_edge_edges = NULL;
+	Curvature_sorted_array = NULL;
+	Sorted_vertex_index_array = NULL;
+}
+
+
+// Move the state of the decimation into a structure,
+//  leaving the global variables empty.
+void save_decimator_state (decimatorStatePtr state)
+{
+	state->removal_count = Removal_count;
+	state->removal_index = Removal_index;
+	state->sorted_vertex_index_array = Sorted_vertex_index_array;
+	state->curvature_sorted_array = Curvature_sorted_array;
+	state->half_edge_mesh = Half_edge_mesh;
+	state->half_edge_edges = Half_edge_edges;
+
+	Removal_count = 0;
+	Removal_index = 1;
+	Sorted_vertex_index_array = NULL;
+	Curvature_sorted_array = NULL;
+	memset (&Half_edge_mesh, 0, sizeof (halfEdgeMeshStruct));
+	Half_edge_edges = NULL;
+}
 
-	// Copy the filename minus the extension
-	// (Assuming a 3 letter extension).
-	strncpy (File_Name, input_file, length-4);
+
+// Make the decimation in a structure the current one.
+void restore_decimator_state (decimatorStatePtr state)
+{
+	Removal_count = state->removal_count;
+	Removal_index = state->removal_index;
+	Sorted_vertex_index_array = state->sorted_vertex_index_array;
+	Curvature_sorted_array = state->curvature_sorted_array;
+	Half_edge_mesh = state->half_edge_mesh;
+	Half_edge_edges = state->half_edge_edges;
 }
 
+
 // Make a list sorting all of the vertices by increasing curvature.
 void sort_vertices_by_decimation_parameter (void)
 {
@@ -387,7 +495,7 @@ double get_vertex_decimation_parameter (int vertex_index)
 
 	// Get the length of the link around the vertex
 	// (the border of the vertex star).
-	link_length = get_link_length (ObjectData.vertexFaceArray[vertex_index], ObjectData.vertexArray, ObjectData.faceArray, vertex_index);
+	link_length = get_link_length (get_vertex_face_indices (&ObjectData, vertex_index), ObjectData.facesPerVertex[vertex_index], ObjectData.vertexArray, ObjectData.faceArray, vertex_index);
 
 	// Get the area of the polygon defined
 	//  by the projected neighbours.
@@ -401,7 +509,7 @@ double get_vertex_decimation_parameter (int vertex_index)
 		polygon_area *= -1;
 	// Get the area of the triangles
 	//  that form the cone.
-	cone_area = area3D_cone (ObjectData.vertexFaceArray[vertex_index], ObjectData.vertexArray, ObjectData.faceArray);
+	cone_area = area3D_cone (get_vertex_face_indices (&ObjectData, vertex_index), ObjectData.facesPerVertex[vertex_index], ObjectData.vertexArray, ObjectData.faceArray);
 	area_ratio = polygon_area / cone_area;
 
 	curvature_parameter = fabs (current_vertex_data.CURVATURE);
@@ -476,7 +584,7 @@ void remove_vertex_face (int vertex_index, int removed_face_id)
 	}
 
 	ObjectData.vertexFaceArray[vertex_index] = vertex_faces_list;
-	ObjectData.facesPerVertex[vertex_index]--;
+	set_vertex_faces (&ObjectData, vertex_index, vertex_faces_list);
 }
 
 
@@ -493,7 +601,7 @@ void add_vertex_face (int vertex_index, int new_face_id)
 	vertex_faces_list = addFrontNode (vertex_faces_list, new_face_index);
 
 	ObjectData.vertexFaceArray[vertex_index] = vertex_faces_list;
-	ObjectData.facesPerVertex[vertex_index]++;
+	set_vertex_faces (&ObjectData, vertex_index, vertex_faces_list);
 }
 
 
@@ -504,27 +612,25 @@ void add_vertex_face (int vertex_index, int new_face_id)
 void compute_vertex_normal (int update_vertex_id)
 {
 	int				i;
-	int				list_length;
-	int*			face_index;
+	int				num_faces;
+	int*			face_indices;
 	double			xSquared;
 	double			ySquared;
 	double			zSquared;
 	double			vectorLength;
 	faceStruct		face;
-	nodePtr			vertex_faces_list;
 	vertexStruct	vertex_normal;
 
 	vertex_normal.x = 0.0;
 	vertex_normal.y = 0.0;
 	vertex_normal.z = 0.0;
 
-	vertex_faces_list = ObjectData.vertexFaceArray[update_vertex_id];
-	list_length = getListLength (vertex_faces_list);
+	face_indices = get_vertex_face_indices (&ObjectData, update_vertex_id);
+	num_faces = ObjectData.facesPerVertex[update_vertex_id];
 
-	for (i=0; i<list_length; i++)
+	for (i=0; i<num_faces; i++)
 	{
-		face_index = (int*) getNodeData (vertex_faces_list, i);
-		face = ObjectData.faceArray[*face_index];
+		face = ObjectData.faceArray[face_indices[i]];
 
 		vertex_normal.x += face.faceNormal->i;
 		vertex_normal.y += face.faceNormal->j;
@@ -532,9 +638,9 @@ void compute_vertex_normal (int update_vertex_id)
 	}
 
 	vertex_normal.vertexId = update_vertex_id;
-	vertex_normal.x /= list_length;
-	vertex_normal.y /= list_length;
-	vertex_normal.z /= list_length;
+	vertex_normal.x /= num_faces;
+	vertex_normal.y /= num_faces;
+	vertex_normal.z /= num_faces;
 
 	xSquared = vertex_normal.x * vertex_normal.x;
 	ySquared = vertex_normal.y * vertex_normal.y;
@@ -560,8 +666,6 @@ void update_neighbours_data (int removed_vertex_id, boolean border_vertex)
 	{
 		update_vertex_id = VertexDataArray[removed_vertex_id].vertex_neighbour_index[i];
 
-		ObjectData.facesPerVertex[update_vertex_id] = getListLength (ObjectData.vertexFaceArray[update_vertex_id]);
-
 		freeVertexDataStructure ( &VertexDataArray[update_vertex_id] );
 		initializeVertexDataStructure ( &VertexDataArray[update_vertex_id] );
 #if (DEBUG >= 1)
@@ -620,11 +724,9 @@ printf ("REMOVING # %5d: VERTEX: %7d\tCURVATURE: %lf\n", Removal_count, removed_
 		triangle_list = update_neighbour_triangles (merge_vertex_id, removed_vertex_id, current_vertex_data);
 		num_triangles = getListLength (triangle_list);
 
-		// Get the list of edges within the polygon.
-		edge_list = get_edge_list (triangle_list, num_triangles);
-		num_edges = getListLength (edge_list);
-		// Remove edges on the borders.
-		remove_border_edges (&edge_list, &num_edges);
+		// Get the list of edges within the polygon,
+		//  without the edges on its border.
+		edge_list = get_inner_edge_list (triangle_list, num_triangles, &num_edges);
 
 		// Check for duplicate faces that may be produced
 		//  from the initial triangulation or future edge flips.
@@ -638,6 +740,8 @@ printf ("REMOVING # %5d: VERTEX: %7d\tCURVATURE: %lf\n", Removal_count, removed_
 		if (num_triangles > 1)
 			minimise_triangulation_curvature (edge_list, num_edges, removed_vertex_id, current_vertex_data, old_curvature);
 			// minimise_triangulation_curvature (edge_list, num_edges);
+
+		clear_half_edge_edges (triangle_list, num_triangles);
 	}
 
 	else	// No new faces to add.
@@ -750,10 +854,138 @@ nodePtr update_neighbour_triangles (int merge_vertex_id, int removed_vertex_id,
 		}
 	}
 
+	// Update the half edges of the faces around the removed vertex.
+	update_half_edge_faces (&Half_edge_mesh, ObjectData.faceArray, get_vertex_face_indices (&ObjectData, removed_vertex_id), ObjectData.facesPerVertex[removed_vertex_id]);
+
 	return (triangle_list);
 }
 
 
+// Get the edges shared by two of the triangles in a list,
+//  with their faces and opposite vertices.
+// The other triangle of each edge is found through the half
+//  edges of the mesh. The edges are numbered in the order
+//  they are first found, and the list begins with the edges
+//  found last, as when each edge is moved to the front of the
+//  list every time that a triangle with it is visited.
+// Each edge is stored in 'Half_edge_edges' for its two half edges.
+nodePtr get_inner_edge_list (nodePtr triangle_list, int num_triangles, int* num_edges)
+{
+	int					i;
+	int					k;
+	int					visit;
+	int					num_visits = 3 * num_triangles;
+	int					num_created = 0;
+	int					half_edge;
+	int					twin;
+	int*				visit_edges = NULL;
+	int*				visit_half_edges = NULL;
+	int*				last_visits = NULL;
+	edgePtr*			edges = NULL;
+	edgePtr				edge = NULL;
+	facePtr				face = NULL;
+	nodePtr				pointer = NULL;
+	nodePtr				edge_list = NULL;
+	nodePtr				edge_list_tail = NULL;
+
+	visit_edges = (int*) xmalloc (sizeof (int) * 3 * num_visits);
+	visit_half_edges = visit_edges + num_visits;
+	last_visits = visit_half_edges + num_visits;
+	edges = (edgePtr*) xmalloc (sizeof (edgePtr) * num_visits);
+
+	for (i=0, pointer = triangle_list; i<num_triangles; i++, pointer = pointer->next)
+	{
+		face = (facePtr) pointer->data;
+
+		for (k=0; k<3; k++)
+		{
+			visit = 3 * i + k;
+			edge = NULL;
+
+			half_edge = get_face_half_edge (&Half_edge_mesh, face->faceId, face->vertex[k]);
+			if ( (half_edge >= 0) && (half_edge_destination (&Half_edge_mesh, half_edge) != face->vertex[(k+1)%3]) )
+				half_edge = -1;
+
+			// The edge was already found in another triangle.
+			twin = (half_edge >= 0) ? Half_edge_mesh.twin[half_edge] : -1;
+			if (twin >= 0)
+				edge = Half_edge_edges[twin];
+
+			if (edge != NULL)
+			{
+				edge->face2 = face->faceId;
+				edge->opposite_vertex_2 = face->vertex[(k+2)%3];
+			}
+			else
+			{
+				edge = newEdge (num_created+1, face->vertex[k], face->vertex[(k+1)%3]);
+				edge->face1 = face->faceId;
+				edge->opposite_vertex_1 = face->vertex[(k+2)%3];
+				edges[num_created++] = edge;
+			}
+
+			if (half_edge >= 0)
+				Half_edge_edges[half_edge] = edge;
+
+			visit_edges[visit] = edge->edgeId;
+			visit_half_edges[visit] = half_edge;
+			last_visits[edge->edgeId-1] = visit;
+		}
+	}
+
+	// Forget the edges with only one triangle.
+	for (visit=0; visit<num_visits; visit++)
+	{
+		edge = edges[visit_edges[visit]-1];
+		if ( (edge->face2 == -1) && (visit_half_edges[visit] >= 0) )
+			Half_edge_edges[visit_half_edges[visit]] = NULL;
+	}
+
+	// Insert each edge at the position of its last visit.
+	*num_edges = 0;
+	for (visit=num_visits-1; visit>=0; visit--)
+	{
+		edge = edges[visit_edges[visit]-1];
+		if (last_visits[edge->edgeId-1] != visit)
+			continue;
+
+		if (edge->face2 == -1)
+		{
+			free (edge);
+			continue;
+		}
+
+		edge_list_tail = addNode (edge_list_tail, edge);
+		if (edge_list == NULL)
+			edge_list = edge_list_tail;
+		*num_edges += 1;
+	}
+
+	free (visit_edges);
+	free (edges);
+
+	return (edge_list);
+}
+
+
+// Remove the edges stored in the half edges of the
+//  triangles around a removed vertex.
+void clear_half_edge_edges (nodePtr triangle_list, int num_triangles)
+{
+	int					i;
+	int					k;
+	facePtr				face = NULL;
+	nodePtr				pointer = NULL;
+
+	for (i=0, pointer = triangle_list; i<num_triangles; i++, pointer = pointer->next)
+	{
+		face = (facePtr) pointer->data;
+		for (k=0; k<3; k++)
+			Half_edge_edges[3 * face->faceId + k] = NULL;
+	}
+}
+
+
 // Check that the initial triangulation presented
 //  does not produce coplanar triangles with those
 //  outside of the retriangulated are.
@@ -782,7 +1014,7 @@ void validate_edges (nodePtr* edge_list, int num_edges)
 			// Edge rotation in normal direction, hence the FALSE value.
 			execute_edge_flip (edge, &face_1, &face_2, FALSE);
 			recompute_edge_vertex_curvature (edge);
-			*edge_list = update_neighbour_edges (face_1, face_2, *edge_list, num_edges);
+			update_flipped_edges (face_1, face_2);
 		}
 	}
 }
@@ -857,7 +1089,7 @@ void minimise_triangulation_curvature (nodePtr edge_list, int num_edges, int ver
 #endif
 			{
 				flip_counter++;
-				edge_list = update_neighbour_edges (face_1, face_2, edge_list, num_edges);
+				update_flipped_edges (face_1, face_2);
 			}
 			// Otherwise flip back to the original state.
 			else
@@ -893,6 +1125,11 @@ void minimise_triangulation_curvature (nodePtr edge_list, int num_edges, int ver
 //  direction the faces will rotate.
 void execute_edge_flip (edgePtr edge, facePtr face_1, facePtr face_2, boolean inverted)
 {
+	int			flipped_faces[2];
+	int			half_edge;
+	int			twin;
+	int			k;
+
 // printf ("DATA BEFORE:\n");
 // printEdgeData (edge, *face_1, *face_2);
 
@@ -901,6 +1138,27 @@ void execute_edge_flip (edgePtr edge, facePtr face_1, facePtr face_2, boolean in
 	register_face_changes (face_1);
 	register_face_changes (face_2);
 
+	// Update the half edges of the two faces.
+	flipped_faces[0] = face_1->faceId;
+	flipped_faces[1] = face_2->faceId;
+	update_half_edge_faces (&Half_edge_mesh, ObjectData.faceArray, flipped_faces, 2);
+
+	// Store again the edges of the list on the new half edges.
+	// The flipped edge is the one between the two faces, and
+	//  the others are found on the twins outside.
+	for (k=0; k<6; k++)
+	{
+		half_edge = 3 * flipped_faces[k/3] + k%3;
+		twin = Half_edge_mesh.twin[half_edge];
+
+		if (twin < 0)
+			Half_edge_edges[half_edge] = NULL;
+		else if ( (half_edge_face (twin) == flipped_faces[0]) || (half_edge_face (twin) == flipped_faces[1]) )
+			Half_edge_edges[half_edge] = edge;
+		else
+			Half_edge_edges[half_edge] = Half_edge_edges[twin];
+	}
+
 	update_flip_vertex_data (edge);
 
 // printf ("DATA AFTER:\n");
@@ -917,10 +1175,7 @@ boolean validate_edge_flip (edgePtr edge, facePtr face_1, facePtr face_2)
 {
 	boolean		valid;
 
-	valid = check_existing_faces (edge->vertex1, edge);
-	if (!valid)
-		return (valid);
-	valid = check_existing_faces (edge->vertex2, edge);
+	valid = check_existing_faces (edge);
 	if (!valid)
 		return (valid);
 
@@ -937,33 +1192,69 @@ boolean validate_edge_flip (edgePtr edge, facePtr face_1, facePtr face_2)
 }
 
 
-// Test if a new face is equal to any of the faces incident
-//  on the received parameter 'test_vertex'.
-boolean check_existing_faces (int test_vertex, edgePtr edge)
+// Test if a new edge is also in any face other
+//  than the two faces of the edge.
+// Looks for the same half edge around the first vertex.
+boolean check_existing_faces (edgePtr edge)
 {
-	int					i;
-	int*				face_index = NULL;
+	int					half_edge;
 	faceStruct			test_face;
 
-	// Test for duplicated triangles in vertex 1.
-	for (i=0; i<ObjectData.facesPerVertex[test_vertex]; i++)
-	{
-		face_index = getNodeData (ObjectData.vertexFaceArray[test_vertex], i);
-		test_face = ObjectData.faceArray[*face_index];
+	half_edge = find_half_edge (&Half_edge_mesh, edge->vertex1, edge->vertex2, edge->face1, edge->face2);
 
-		if (	(edge->face1 != test_face.faceId) &&
-				(edge->face2 != test_face.faceId) &&
-				find_edge_in_triangle (edge, test_face) )
-		{
+	if (half_edge >= 0)
+	{
+		test_face = ObjectData.faceArray[half_edge_face (half_edge)];
 printf ("Found DUPLICATE EDGES: edge %d = %d, %d and face %d = %d, %d, %d\n", edge->edgeId, edge->vertex1, edge->vertex2, test_face.faceId, test_face.vertex[0], test_face.vertex[1], test_face.vertex[2]);
-			return (FALSE);
-		}
+		return (FALSE);
 	}
 
 	return (TRUE);
 }
 
 
+// Modify the faces and opposite vertices of the edges
+//  around two faces, after flipping the edge between them.
+// The edges of the list are found on the half edges
+//  of the faces, instead of searching the whole list.
+void update_flipped_edges (faceStruct face_1, faceStruct face_2)
+{
+	int					half_edge;
+
+	// First and second edges of triangle 1.
+	half_edge = get_face_half_edge (&Half_edge_mesh, face_1.faceId, face_1.vertex[0]);
+	update_flipped_edge (Half_edge_edges[half_edge], face_1.faceId, face_1.vertex[2], face_1, face_2);
+	half_edge = get_face_half_edge (&Half_edge_mesh, face_1.faceId, face_1.vertex[1]);
+	update_flipped_edge (Half_edge_edges[half_edge], face_1.faceId, face_1.vertex[0], face_1, face_2);
+
+	// First and second edges of triangle 2.
+	half_edge = get_face_half_edge (&Half_edge_mesh, face_2.faceId, face_2.vertex[0]);
+	update_flipped_edge (Half_edge_edges[half_edge], face_2.faceId, face_2.vertex[2], face_1, face_2);
+	half_edge = get_face_half_edge (&Half_edge_mesh, face_2.faceId, face_2.vertex[1]);
+	update_flipped_edge (Half_edge_edges[half_edge], face_2.faceId, face_2.vertex[0], face_1, face_2);
+}
+
+
+// Set the new face and opposite vertex of one edge around a flip.
+// The face that changed is the one that was one of the two faces.
+void update_flipped_edge (edgePtr edge, int face_id, int opposite_vertex, faceStruct face_1, faceStruct face_2)
+{
+	if (edge == NULL)
+		return;
+
+	if ( (edge->face1 == face_1.faceId) || (edge->face1 == face_2.faceId) )
+	{
+		edge->face1 = face_id;
+		edge->opposite_vertex_1 = opposite_vertex;
+	}
+	else
+	{
+		edge->face2 = face_id;
+		edge->opposite_vertex_2 = opposite_vertex;
+	}
+}
+
+
 // Get the sum of the curvatures of all the
 //  vertices in the triangles on both sides
 //  of an edge.
@@ -998,22 +1289,23 @@ double get_link_curvature (int vertexId, vertexDataStruct current_vertex_data)
 
 
 // Recompute the normal of a face.
+// The vector of the face is reused when it already has one.
 void update_face_normal_vector (facePtr face)
 {
-	vertexStruct		update_vertex[3];
-	vectorPtr			normal_vector;
+	vectorStruct		normal_vector;
 
 	// Get new normals for the triangles.
-	update_vertex[0] = ObjectData.vertexArray[face->vertex[0]];
-	update_vertex[1] = ObjectData.vertexArray[face->vertex[1]];
-	update_vertex[2] = ObjectData.vertexArray[face->vertex[2]];
+	normal_vector = triangle_normal (	&(ObjectData.vertexArray[face->vertex[0]]),
+										&(ObjectData.vertexArray[face->vertex[1]]),
+										&(ObjectData.vertexArray[face->vertex[2]]) );
+	normal_vector.vectorId = face->faceId;
+	normal_vector.type = NORMAL;
+	normal_vector.num_intersections = 0;
 
-	normal_vector = getTriangleNormal (update_vertex[0], update_vertex[1], update_vertex[2]);
-	normal_vector->vectorId = face->faceId;
-	normal_vector->type = NORMAL;
-	normal_vector->num_intersections = 0;
+	if (face->faceNormal == NULL)
+		face->faceNormal = (vectorPtr) xmalloc (sizeof (vectorStruct));
 
-	face->faceNormal = normal_vector;
+	*(face->faceNormal) = normal_vector;
 }
 
 
@@ -1111,6 +1403,7 @@ void register_face_changes (facePtr face)
 }
 
 
+#ifndef HEADLESS
 // Function called from OpenGL to execute
 //  the decimation. It deletes a set
 //  number of vertices.
@@ -1149,6 +1442,64 @@ void visual_vertex_decimation (void)
 	decimation_percent = (double)remaining_vertices / (double)total_vertices * 100.0;
 	printf ("MESH NOW DECIMATED TO %d VERTICES (%.2lf%%)\n", remaining_vertices, decimation_percent);
 }
+#endif
+
+
+// Decimate the mesh without displaying it, until only the
+//  given percentage of its vertices remains, or no more
+//  vertices can be removed.
+void headless_vertex_decimation (double remaining_percent)
+{
+	int					remaining_vertices;
+	int					target_vertices;
+	int					total_vertices;
+	double				decimation_percent;
+
+	total_vertices = ObjectData.numVertices;
+	target_vertices = (int) (total_vertices * remaining_percent / 100.0);
+
+	while (total_vertices - Removal_count > target_vertices)
+	{
+		// Stop the loop if there are no more vertices to decimate.
+		if (remove_minimal_curvature_vertex () < 0)
+			break;
+	}
+
+	remaining_vertices = total_vertices - Removal_count;
+	decimation_percent = (double)remaining_vertices / (double)total_vertices * 100.0;
+	printf ("MESH NOW DECIMATED TO %d VERTICES (%.2lf%%)\n", remaining_vertices, decimation_percent);
+}
+
+
+// Write the decimated mesh in the output formats.
+// The file names are made of the name of the input file
+//  and the number of vertices removed.
+// The writers skip the vertices and faces removed
+//  by the decimation.
+void write_decimated_files (void)
+{
+	char*			filename;
+
+	filename = (char*) xmalloc (sizeof (char) * (strlen (File_Name) + 40));
+
+	// OBJ file format.
+	sprintf (filename, "%s-%d.obj", File_Name, Removal_count);
+	write_obj_file (ObjectData, filename);
+
+	// PLY file format.
+	sprintf (filename, "%s-%d.ply", File_Name, Removal_count);
+	write_ply_file (ObjectData, filename, TRUE);
+
+	// PLY file with the curvature of the vertices.
+	sprintf (filename, "%s-%d-curvature.ply", File_Name, Removal_count);
+	write_curvature_ply_file (ObjectData, VertexDataArray, filename);
+
+	// OFF file format.
+	// sprintf (filename, "%s-%d.off", File_Name, Removal_count);
+	// write_off_file (ObjectData, filename);
+
+	free (filename);
+}
 
 
 // Create a new objectStruct to contain the
@@ -0,0 +1,51 @@
+// Data structures
+
+// Data structure to hold decimation parameter
+typedef struct decimationDataStruct
+{
+	int		vertexId;
+	double	decimation_parameter;
+} decimationDataStruct;
+
+typedef decimationDataStruct* decimationDataPtr;
+
+// STATE OF THE DECIMATION
+// Everything kept about the object being decimated.
+// Like the state of the Gauss map, it can be moved out of
+//  the global variables to work on another object.
+typedef struct decimatorStateStruct
+{
+	int					removal_count;
+	int					removal_index;
+	int*				sorted_vertex_index_array;
+	decimationDataPtr	curvature_sorted_array;
+	halfEdgeMeshStruct	half_edge_mesh;
+	edgePtr*			half_edge_edges;
+} decimatorStateStruct;
+
+typedef decimatorStateStruct* decimatorStatePtr;
+
+
+// Function declarations
+
+// Build the structures used to remove vertices from the
+//  object of the Gauss map: the lists of faces around the
+//  vertices and the half edges.
+void start_decimation (void);
+
+// Release the memory used for the decimation.
+// The object itself is released by 'freeObjectMemory'.
+void free_decimation (void);
+
+// Make a list sorting all of the vertices by increasing curvature.
+void sort_vertices_by_decimation_parameter (void);
+
+// Remove vertices until only a percentage of them remain.
+void headless_vertex_decimation (double remaining_percent);
+
+// Move the state of the decimation into a structure,
+//  leaving the global variables empty.
+void save_decimator_state (decimatorStatePtr state);
+
+// Make the decimation in a structure the current one.
+void restore_decimator_state (decimatorStatePtr state);
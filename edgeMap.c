@@ -0,0 +1,122 @@
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "edges.h"
+#include "edgeMap.h"
+
+
+// Get the key of the edge between two vertices.
+static unsigned long long edge_key (int vertex1, int vertex2)
+{
+	if (vertex1 > vertex2)
+		return ( ((unsigned long long) (unsigned int) vertex2 << 32) | (unsigned int) vertex1 );
+	else
+		return ( ((unsigned long long) (unsigned int) vertex1 << 32) | (unsigned int) vertex2 );
+}
+
+
+// Get the first slot to probe for a key.
+static int edge_slot (edgeMapPtr map, unsigned long long key)
+{
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+
+	return ( (int) (key & (unsigned long long) (map->capacity - 1)) );
+}
+
+
+// Double the number of slots and place the edges again.
+static void grow_edge_map (edgeMapPtr map)
+{
+	edgeMapStruct	larger;
+	int				i;
+
+	larger = new_edge_map (map->capacity);
+
+	for (i=0; i<map->capacity; i++)
+	{
+		if (map->keys[i] != 0)
+			insert_map_edge (&larger, map->edges[i]);
+	}
+
+	free_edge_map (map);
+	*map = larger;
+}
+
+
+// Create an empty map with space for the number
+//  of edges indicated.
+// The table is kept at most half full.
+edgeMapStruct new_edge_map (int num_edges)
+{
+	edgeMapStruct	map;
+
+	map.capacity = 16;
+	while (map.capacity < 2 * num_edges)
+		map.capacity *= 2;
+	map.count = 0;
+
+	map.keys = (unsigned long long*) xmalloc (sizeof (unsigned long long) * map.capacity);
+	map.edges = (edgePtr*) xmalloc (sizeof (edgePtr) * map.capacity);
+	memset (map.keys, 0, sizeof (unsigned long long) * map.capacity);
+
+	return (map);
+}
+
+
+// Release the memory of the map.
+// The edges stored are not freed.
+void free_edge_map (edgeMapPtr map)
+{
+	free (map->keys);
+	free (map->edges);
+	map->keys = NULL;
+	map->edges = NULL;
+	map->capacity = 0;
+	map->count = 0;
+}
+
+
+// Find the edge between two vertices, in any order.
+// Returns NULL if the edge is not in the map.
+edgePtr find_map_edge (edgeMapPtr map, int vertex1, int vertex2)
+{
+	unsigned long long	key = edge_key (vertex1, vertex2);
+	int					slot = edge_slot (map, key);
+
+	while (map->keys[slot] != 0)
+	{
+		if (map->keys[slot] == key)
+			return (map->edges[slot]);
+
+		slot = (slot + 1) & (map->capacity - 1);
+	}
+
+	return (NULL);
+}
+
+
+// Store an edge in the map.
+// Replaces any other edge between the same vertices.
+void insert_map_edge (edgeMapPtr map, edgePtr edge)
+{
+	unsigned long long	key = edge_key (edge->vertex1, edge->vertex2);
+	int					slot;
+
+	if ( 2 * (map->count + 1) > map->capacity )
+		grow_edge_map (map);
+
+	slot = edge_slot (map, key);
+	while ( (map->keys[slot] != 0) && (map->keys[slot] != key) )
+		slot = (slot + 1) & (map->capacity - 1);
+
+	if (map->keys[slot] == 0)
+	{
+		map->keys[slot] = key;
+		map->count++;
+	}
+	map->edges[slot] = edge;
+}
@@ -0,0 +1,38 @@
+// Data structures
+
+// MAP OF EDGES
+// Hash table with open addressing, to find an edge from
+//  its two vertices, in any order.
+// The key of an edge packs its smaller vertex in the high
+//  32 bits and the larger one in the low 32 bits.
+// A key of 0 marks an empty slot, since the vertices are
+//  numbered from 1.
+typedef struct edgeMapStruct
+{
+	// Number of slots, always a power of two.
+	int						capacity;
+	int						count;
+	unsigned long long*		keys;
+	edgePtr*				edges;
+} edgeMapStruct;
+
+typedef edgeMapStruct* edgeMapPtr;
+
+
+// Function declarations
+
+// Create an empty map with space for the number
+//  of edges indicated.
+edgeMapStruct new_edge_map (int num_edges);
+
+// Release the memory of the map.
+// The edges stored are not freed.
+void free_edge_map (edgeMapPtr map);
+
+// Find the edge between two vertices, in any order.
+// Returns NULL if the edge is not in the map.
+edgePtr find_map_edge (edgeMapPtr map, int vertex1, int vertex2);
+
+// Store an edge in the map.
+// Replaces any other edge between the same vertices.
+void insert_map_edge (edgeMapPtr map, edgePtr edge);
@@ -5,6 +5,7 @@
 #include "geometry.h"
 #include "faces.h"
 #include "edges.h"
+#include "edgeMap.h"
 
 // Create a new edge pointer.
 edgePtr newEdge (int edgeId, int edgeVertex1, int edgeVertex2)
@@ -56,31 +57,125 @@ void printEdgeList (nodePtr edgeList, int listLength)
 }
 
 
+// Build the list of edges of a group of triangles, using
+//  a map to find the edges already created.
+// Gives the same list as inserting each edge with 'add_edge':
+//  an edge is created when no edge with the opposite direction
+//  exists, and the edges are ordered from the last one used
+//  to the first.
+static nodePtr collect_edges (facePtr* faces, int num_faces, int* num_edges)
+{
+	edgeMapStruct	map;
+	edgePtr*		used_edges = NULL;
+	int*			last_use = NULL;
+	edgePtr			edge = NULL;
+	nodePtr			edge_list = NULL;
+	int				num_uses = 0;
+	int				vertex1;
+	int				vertex2;
+	int				opposite_vertex;
+	int				i;
+	int				k;
+
+	*num_edges = 0;
+
+	map = new_edge_map (3 * num_faces / 2);
+	used_edges = (edgePtr*) xmalloc (sizeof (edgePtr) * (3 * num_faces + 1));
+	last_use = (int*) xmalloc (sizeof (int) * (3 * num_faces + 1));
+
+	for (i=0; i<num_faces; i++)
+	{
+		for (k=0; k<3; k++)
+		{
+			vertex1 = faces[i]->vertex[k];
+			vertex2 = faces[i]->vertex[(k+1)%3];
+			opposite_vertex = faces[i]->vertex[(k+2)%3];
+
+			edge = find_map_edge (&map, vertex1, vertex2);
+			// Only an edge going in the opposite direction
+			//  is shared with the face.
+			if ( (edge != NULL) && (edge->vertex1 == vertex2) && (edge->vertex2 == vertex1) )
+			{
+				edge->face2 = faces[i]->faceId;
+				edge->opposite_vertex_2 = opposite_vertex;
+			}
+			else
+			{
+				*num_edges += 1;
+				edge = newEdge (*num_edges, vertex1, vertex2);
+				edge->face1 = faces[i]->faceId;
+				edge->opposite_vertex_1 = opposite_vertex;
+				insert_map_edge (&map, edge);
+			}
+
+			used_edges[num_uses] = edge;
+			last_use[edge->edgeId] = num_uses;
+			num_uses++;
+		}
+	}
+
+	// Insert each edge at the front of the list,
+	//  at the moment it was last used.
+	for (i=0; i<num_uses; i++)
+	{
+		if (last_use[used_edges[i]->edgeId] == i)
+			edge_list = addFrontNode (edge_list, used_edges[i]);
+	}
+
+	free (used_edges);
+	free (last_use);
+	free_edge_map (&map);
+
+	return (edge_list);
+}
+
+
 // Extract the list of edges out of a list
 //  of triangles.
 nodePtr get_edge_list (nodePtr triangle_list, int num_triangles)
 {
-	int			i;
-	int			num_edges = 0;
-	int			vertex1;
-	int			vertex2;
-	int			vertex3;
-	facePtr		face = NULL;
+	facePtr*	faces = NULL;
+	nodePtr		pointer = triangle_list;
 	nodePtr		edge_list = NULL;
+	int			num_edges;
+	int			i;
 
+	faces = (facePtr*) xmalloc (sizeof (facePtr) * (num_triangles + 1));
 	for (i=0; i<num_triangles; i++)
 	{
-		face = (facePtr) getNodeData (triangle_list, i);
+		faces[i] = (facePtr) pointer->data;
+		pointer = pointer->next;
+	}
+
+	edge_list = collect_edges (faces, num_triangles, &num_edges);
 
-		vertex1 = face->vertex[0];
-		vertex2 = face->vertex[1];
-		vertex3 = face->vertex[2];
+	free (faces);
 
-		add_edge (vertex1, vertex2, vertex3, face->faceId, &num_edges, &edge_list);
-		add_edge (vertex2, vertex3, vertex1, face->faceId, &num_edges, &edge_list);
-		add_edge (vertex3, vertex1, vertex2, face->faceId, &num_edges, &edge_list);
+	return (edge_list);
+}
+
+
+// Extract the list of edges of all the faces in an array.
+// Faces with a negative faceId are skipped.
+// The array has an empty element at index 0.
+nodePtr get_face_array_edge_list (facePtr face_array, int num_faces, int* num_edges)
+{
+	facePtr*	faces = NULL;
+	nodePtr		edge_list = NULL;
+	int			count = 0;
+	int			i;
+
+	faces = (facePtr*) xmalloc (sizeof (facePtr) * (num_faces + 1));
+	for (i=1; i<=num_faces; i++)
+	{
+		if (face_array[i].faceId >= 0)
+			faces[count++] = &face_array[i];
 	}
 
+	edge_list = collect_edges (faces, count, num_edges);
+
+	free (faces);
+
 	return (edge_list);
 }
 
@@ -27,6 +27,11 @@ void printEdgeList (nodePtr edgeList, int listLength);
 //  of triangles.
 nodePtr get_edge_list (nodePtr triangle_list, int num_triangles);
 
+// Extract the list of edges of all the faces in an array,
+//  with their faces and opposite vertices.
+// Takes linear time in the number of faces.
+nodePtr get_face_array_edge_list (facePtr face_array, int num_faces, int* num_edges);
+
 // Create a new edge and insert it
 //  into the list.
 void add_edge (int vertex1, int vertex2, int opposite_vertex, int face_id, int* num_edges, nodePtr* edge_list);
@@ -1,8 +1,10 @@
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 #include "vertices.h"
 #include "geometry.h"
 #include "faces.h"
+#include "meshStorage.h"
 
 //Print the contents of a list of faces.
 void printFaceList (nodePtr list)
@@ -70,7 +72,7 @@ facePtr newFace (int faceId, int numVertices, int v1, int v2, int v3, int v4)
 {
 	facePtr		face = NULL;
 
-	face = (facePtr) xmalloc (sizeof (faceStruct));
+	face = (facePtr) scratch_malloc (sizeof (faceStruct));
 
 	face->faceId = faceId;
 	face->faceVertices = numVertices;
@@ -197,19 +199,16 @@ double area3D_face (faceStruct face, vertexPtr vertex_array)
 
 
 // Compute the area of the faces around a vertex.
-double area3D_cone (nodePtr triangle_list, vertexPtr vertex_array, facePtr face_array)
+double area3D_cone (int* face_indices, int num_faces, vertexPtr vertex_array, facePtr face_array)
 {
-	int				list_length = getListLength (triangle_list);
 	int				i;
-	int*			face_index = NULL;
 	double			cone_area = 0.0;
 	double			triangle_area = 0.0;
 	faceStruct		face;
 
-	for (i=0; i<list_length; i++)
+	for (i=0; i<num_faces; i++)
 	{
-		face_index = (int*) getNodeData (triangle_list, i);
-		face = face_array[*face_index];
+		face = face_array[face_indices[i]];
 
 		triangle_area = area3D_face (face, vertex_array);
 		cone_area += triangle_area;
@@ -222,18 +221,23 @@ double area3D_cone (nodePtr triangle_list, vertexPtr vertex_array, facePtr face_
 // Compute the surface area of a whole mesh.
 double object_surface_area (facePtr face_array, int num_faces, vertexPtr vertex_array)
 {
-	int				i;
-	double			object_area = 0.0;
-	double			triangle_area = 0.0;
-	faceStruct		face;
+	double				object_area = 0.0;
+	meshStorageStruct	storage;
+	int					num_vertices = 0;
+	int					i, j;
 
+	// Only the vertices used by the faces are needed.
 	for (i=1; i<=num_faces; i++)
-	{
-		face = face_array[i];
+		for (j=0; j<face_array[i].faceVertices && j<4; j++)
+			if (face_array[i].vertex[j] > num_vertices)
+				num_vertices = face_array[i].vertex[j];
 
-		triangle_area = area3D_face (face, vertex_array);
-		object_area += triangle_area;
-	}
+	storage = new_mesh_storage (vertex_array, num_vertices, face_array, num_faces);
+
+	mesh_face_areas (&storage);
+	object_area = mesh_surface_area (&storage);
+
+	free_mesh_storage (&storage);
 
 	return (object_area);
 }
@@ -242,21 +246,18 @@ double object_surface_area (facePtr face_array, int num_faces, vertexPtr vertex_
 
 // Compute the total length of the
 //  border of a vertex star.
-double get_link_length (nodePtr triangle_list, vertexPtr vertex_array, facePtr face_array, int vertex_index)
+double get_link_length (int* face_indices, int num_faces, vertexPtr vertex_array, facePtr face_array, int vertex_index)
 {
-	int				list_length = getListLength (triangle_list);
 	int				i;
-	int*			face_index = NULL;
 	double			segment_length = 0.0;
 	double			link_length = 0.0;
 	vertexStruct	vertex_1;
 	vertexStruct	vertex_2;
 	faceStruct		face;
 
-	for (i=0; i<list_length; i++)
+	for (i=0; i<num_faces; i++)
 	{
-		face_index = (int*) getNodeData (triangle_list, i);
-		face = face_array[*face_index];
+		face = face_array[face_indices[i]];
 
 		// Make sure the segment is the one opposite
 		//  the vertex being analysed.
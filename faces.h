@@ -52,11 +52,11 @@ boolean find_vertex_in_object (int vertex_index, nodePtr triangle_list, vertexPt
 double area3D_face (faceStruct face, vertexPtr vertex_array);
 
 // Compute the area of the faces around a vertex.
-double area3D_cone (nodePtr triangle_list, vertexPtr vertex_array, facePtr face_array);
+double area3D_cone (int* face_indices, int num_faces, vertexPtr vertex_array, facePtr face_array);
 
 // Compute the surface area of a whole mesh.
 double object_surface_area (facePtr face_array, int num_faces, vertexPtr vertex_array);
 
 // Compute the total length of the
 //  border of a vertex star.
-double get_link_length (nodePtr triangle_list, vertexPtr vertex_array, facePtr face_array, int vertex_index);
+double get_link_length (int* face_indices, int num_faces, vertexPtr vertex_array, facePtr face_array, int vertex_index);
@@ -1,7 +1,35 @@
 #include "gaussMap.h"
 
 // External functions
+#ifndef HEADLESS
 extern int glMain ();
+#endif
+
+// Number of vertices taken at a time by the threads
+//  computing the Gauss Map.
+// The totals are added by blocks, always of the same size,
+//  so they do not depend on the number of threads.
+#define VERTICES_PER_BLOCK		256
+
+// Information shared by the threads computing the Gauss Map.
+typedef struct
+{
+	int						next_block;
+	int						num_blocks;
+	int						vertices_done;
+	gaussMapTotalsPtr		block_totals;
+} gaussMapWorkStruct;
+
+typedef gaussMapWorkStruct* gaussMapWorkPtr;
+
+// Arguments of each of the threads.
+typedef struct
+{
+	gaussMapWorkPtr			work;
+	int						thread;
+} gaussMapThreadStruct;
+
+typedef gaussMapThreadStruct* gaussMapThreadPtr;
 
 // Global variables associated with the objects generated
 objectStruct	ObjectData;
@@ -24,10 +52,15 @@ double			MAX_TAC = 0.0;
 //  about each individual vertex.
 vertexDataStruct*	VertexDataArray = NULL;
 
+// File used to store the results of the Gauss Map,
+//  to avoid computing them again for the same object.
+char*			GaussMapCacheFile = NULL;
+
 
-// Variable to be used for the display of the 
-//  spherical polygons as sets of triangles.
-nodePtr			PolygonTriangles = NULL;
+// Memory for the temporary data of each vertex,
+//  released when the vertex is done.
+// Each thread processing vertices has its own.
+__thread arenaStruct	VertexArena;
 
 // Variable to keep the vertices of the 
 //  Convex Hull of the dataset.
@@ -37,18 +70,24 @@ nodePtr			ConvexHull = NULL;
 // Function declarations
 void usage (char* programName);
 void generateObject (char* inputFile);
+boolean read_object (char* inputFile, boolean use_caches);
+boolean has_extension (char* file_name, char* extension);
 void generateGaussMap ();
 void process_vertex (int vertex_index);
+void process_vertex_star (int vertex_index, int* vertexFaces, int numVertexFaces, facePtr faceArray, gaussMapTotalsPtr totals);
+void* process_vertex_blocks (void* argument);
+void process_all_vertices ();
+void restore_vertex_topology (int vertex_index);
 void classify_vertex (vertexDataStruct* current_vertex_data, int numPolygons, int positive_polys, int flat_polys, int negative_polys);
 void find_concave_vertices (vertexDataStruct* current_vertex_data, int vertex_index);
 void split_mixed_vertex (int vertex_index, vertexPtr coneVertexArray, int coneVertexArrayLength);
 nodePtr faces_per_vertex (objectStruct objectData);
 nodePtr get_vertex_faces (vertexStruct currentVertex, objectStruct objectData);
-nodePtr order_faces_around_vertex (nodePtr tempList, facePtr faceArray, int vertex_index);
-double getAngleAroundVertex (nodePtr faceIndexList, facePtr faceArray, vertexPtr vertexArray, int vertexIndex, boolean* border);
-vertexPtr getConeVertices (nodePtr faceList, facePtr faceArray, vertexPtr vertexArray, vertexDataPtr current_vertex_data);
+int* order_vertex_star (int vertex_index);
+double getAngleAroundVertex (int* faceIndices, int numFaces, facePtr faceArray, vertexPtr vertexArray, int vertexIndex, boolean* border);
+vertexPtr getConeVertices (int* faceIndices, int numFaces, facePtr faceArray, vertexPtr vertexArray, vertexDataPtr current_vertex_data);
 vectorStruct get_average_normal (vertexStruct vertex_normal);
-vectorStruct getArtificialNormal (nodePtr faceList, facePtr faceArray, vertexPtr vertexArray);
+vectorStruct getArtificialNormal (int* face_indices, int num_faces, facePtr face_array, vertexPtr vertex_array);
 // double getConeStarAngle (nodePtr faceList, facePtr faceArray, vertexPtr vertexArray);
 void project_cone_on_plane (vertexPtr vertexArray, vertexDataPtr current_vertex_data);
 void freeObjectMemory ();
@@ -75,7 +114,7 @@ int main (int argc, char* argv[])
 
 	strcpy (inputFile, argv[1]);
 
-	if (argc == 3)
+	if (argc >= 3)
 		ShowVertex = atoi(argv[2]);
 
 	////////	OBJECT ACQUISITION	////////
@@ -92,12 +131,18 @@ int main (int argc, char* argv[])
 	(void) time (&stop);
 	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
 
+	// Export the results for each vertex.
+	if (argc >= 4)
+		write_curvature_ply_file (ObjectData, VertexDataArray, argv[3]);
+
+#ifndef HEADLESS
 	////////	RENDERING WITH OpenGL	////////
 	printf ("\n[STAGE 3] -- GRAPHICAL DISPLAY\n"); fflush (stdout);
 	(void) time (&start);
 	glMain ();
 	(void) time (&stop);
 	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
+#endif
 
 	freeObjectMemory ();
 
@@ -108,35 +153,136 @@ int main (int argc, char* argv[])
 // Prints information about the arguments to supply to the program.
 void usage (char* programName)
 {
-	printf ("Usage: %s input_file_name [vertex_number]\n", programName);
-	printf ("\tinput_file_name:\tobj file\n");
-	printf ("\tvertex_number:\t\tonly one vertex analysed\n");
+	printf ("Usage: %s input_file_name [vertex_number [curvature_file_name]]\n", programName);
+	printf ("\tinput_file_name:\tobj, ply, off or gmb file, possibly gzipped, or '-' for stdin\n");
+	printf ("\tvertex_number:\t\tonly one vertex analysed (0 for all)\n");
+	printf ("\tcurvature_file_name:\tbinary ply file to write with the curvature of each vertex\n");
 	exit (1);
 }
 #endif
 
 
 // Read the input file and generate an Object structure.
+// The program is stopped if the file can not be read.
 void generateObject (char* inputFile)
 {
-	// Read the input file and store the information in a list.
-	ObjectData = readObjFile (inputFile);
+	if (!read_object (inputFile, mesh_cache_enabled ()))
+	{
+		printf ("Exiting.\n");
+		exit (1);
+	}
+}
+
+
+// Read the input file into the Object structure.
+// The format of the file is chosen from its extension, which
+//  may be followed by '.gz' for compressed files.
+// An input file named '-' is read as an obj file from stdin.
+// With 'use_caches', a binary '.gmb' cache of the object is kept,
+//  and used instead of the input file while it is current.
+// Returns FALSE, with a message, if the file can not be read
+//  or is not valid.
+boolean read_object (char* inputFile, boolean use_caches)
+{
+	char*		cacheFile = NULL;
+	boolean		success = TRUE;
+
+	use_caches = use_caches && strcmp (inputFile, "-");
+
+	if (has_extension (inputFile, ".gmb"))
+	{
+		if (!read_mesh_cache (inputFile, &ObjectData))
+		{
+			printf ("Invalid mesh cache file: '%s'.\n", inputFile);
+			return (FALSE);
+		}
+	}
+	else
+	{
+		if (use_caches)
+			cacheFile = mesh_cache_file (inputFile, ".gmb");
+
+		if ( !use_caches || !mesh_cache_is_current (cacheFile, inputFile) || !read_mesh_cache (cacheFile, &ObjectData) )
+		{
+			// Read the input file and store the information in a list.
+			if (has_extension (inputFile, ".ply"))
+				success = read_ply_file (inputFile, &ObjectData);
+			else if (has_extension (inputFile, ".off"))
+				success = read_off_file (inputFile, &ObjectData);
+			else
+				success = read_obj_file (inputFile, &ObjectData);
+
+			if (success && use_caches)
+				write_mesh_cache (ObjectData, cacheFile, inputFile);
+		}
+		else
+			printf ("\tUsing mesh cache '%s'\n", cacheFile);
+
+		free (cacheFile);
+
+		if (!success)
+			return (FALSE);
+	}
+
+#ifdef HEADLESS
+	// The viewer draws the spherical polygons of every vertex,
+	//  which are not kept in the Gauss map cache.
+	if (use_caches)
+		GaussMapCacheFile = mesh_cache_file (inputFile, ".gmc");
+#endif
+
+	// The edges are not stored in the caches,
+	//  so they are always built again.
+	ObjectData.edgeList = get_face_array_edge_list (ObjectData.faceArray, ObjectData.numFaces, &ObjectData.numEdges);
 
 	printf ("\tObject read has %d vertices and %d faces and %d edges\n", ObjectData.numVertices, ObjectData.numFaces, ObjectData.numEdges);
 
 	// Change the normals of faces with concave edges.
 	// herisson_swap (ObjectData);
+
+	return (TRUE);
+}
+
+
+// Check whether a file name ends with an extension, ignoring
+//  case and an additional '.gz' suffix.
+boolean has_extension (char* file_name, char* extension)
+{
+	size_t		length = strlen (file_name);
+	size_t		extension_length = strlen (extension);
+
+	if ( (length > 3) && !strcasecmp (file_name + length - 3, ".gz") )
+		length -= 3;
+
+	if (length < extension_length)
+		return (FALSE);
+
+	return (!strncasecmp (file_name + length - extension_length, extension, extension_length));
 }
 
 
 // Process the object data to obtain the Gauss Map.
+// When all the vertices are processed, the results are
+//  read from the cache file if it was created for the
+//  same object, or stored there otherwise.
 void generateGaussMap ()
 {
-	int			i;
-	int			numVertices = 0;
+	int						i;
+	int						numVertices = 0;
+	unsigned long long		hash = 0;
+	boolean					use_cache = FALSE;
+	boolean					cached = FALSE;
+	gaussMapTotalsStruct	totals;
 
 	numVertices = ObjectData.numVertices;
 
+	// Start from zero, in case other objects were processed before.
+	TotalGaussMapArea = 0.0;
+	PositiveGaussMapArea = 0.0;
+	NegativeGaussMapArea = 0.0;
+	GaussianCurvature = 0.0;
+	MAX_TAC = 0.0;
+
 	// Check whether to do the computations for only one vertex
 	//  or for all.
 	if (ShowVertex == 0)
@@ -172,20 +318,53 @@ void generateGaussMap ()
 	for (i=0; i<=numVertices; i++)
 		initializeVertexDataStructure (&VertexDataArray[i]);
 
-	printf ("\tProcessing the vertices:\t"); fflush (stdout);
-    for (i=Begin; i<End; i++)
+	// The cache only holds the results for the whole object.
+	use_cache = (ShowVertex == 0) && (GaussMapCacheFile != NULL);
+
+	if (use_cache)
 	{
-#if (DEBUG >= 1)
-	printf ("\n---> FOR VERTEX %d:\n", i+1); fflush (stdout);
-#endif
+		hash = object_content_hash (ObjectData);
+		cached = read_gauss_map_cache (GaussMapCacheFile, hash, VertexDataArray, numVertices, &totals);
+	}
+
+	if (cached)
+	{
+		printf ("\tUsing Gauss Map cache '%s'\n", GaussMapCacheFile);
 
-		process_vertex (i+1);
+		TotalGaussMapArea = totals.total_area;
+		PositiveGaussMapArea = totals.positive_area;
+		NegativeGaussMapArea = totals.negative_area;
+		GaussianCurvature = totals.gaussian_curvature;
+		MAX_TAC = totals.max_tac;
+
+		printf ("\tRestoring the vertices:\t"); fflush (stdout);
+		for (i=Begin; i<End; i++)
+		{
+			restore_vertex_topology (i+1);
 
 #ifndef DEBUG
-		printProgressStar (i, End-Begin);
+			printProgressStar (i, End-Begin);
 #endif
+		}
+		printf (" Done\n"); fflush (stdout);
+	}
+	else
+	{
+		printf ("\tProcessing the vertices:\t"); fflush (stdout);
+		process_all_vertices ();
+		printf (" Done\n"); fflush (stdout);
+
+		if (use_cache)
+		{
+			totals.total_area = TotalGaussMapArea;
+			totals.positive_area = PositiveGaussMapArea;
+			totals.negative_area = NegativeGaussMapArea;
+			totals.gaussian_curvature = GaussianCurvature;
+			totals.max_tac = MAX_TAC;
+
+			write_gauss_map_cache (GaussMapCacheFile, hash, VertexDataArray, numVertices, totals);
+		}
 	}
-	printf (" Done\n"); fflush (stdout);
 
 // findFacesIntersection (2, 4);
 
@@ -259,13 +438,45 @@ void BIG_PENTA_SADDLE_CHEAT (nodePtr polygon_list)
 
 
 // Do all of the checks for the vertex indicated.
-// Fills all the data structures for that vertex.
+// Fills all the data structures for that vertex, and
+//  adds its results to the global totals.
 void process_vertex (int vertex_index)
+{
+	int*					vertexFaces = NULL;
+	gaussMapTotalsStruct	totals;
+
+	// Get the faces around the current vertex,
+	//  in CCW orientation.
+	vertexFaces = order_vertex_star (vertex_index);
+
+	totals.total_area = TotalGaussMapArea;
+	totals.positive_area = PositiveGaussMapArea;
+	totals.negative_area = NegativeGaussMapArea;
+	totals.gaussian_curvature = GaussianCurvature;
+	totals.max_tac = MAX_TAC;
+
+	process_vertex_star (vertex_index, vertexFaces, ObjectData.facesPerVertex[vertex_index], ObjectData.faceArray, &totals);
+
+	TotalGaussMapArea = totals.total_area;
+	PositiveGaussMapArea = totals.positive_area;
+	NegativeGaussMapArea = totals.negative_area;
+	GaussianCurvature = totals.gaussian_curvature;
+	MAX_TAC = totals.max_tac;
+}
+
+
+// Do all of the checks for a vertex, with the faces around it
+//  given in CCW order, each one beginning with the vertex.
+// 'vertexFaces' are indices into 'faceArray', which may be
+//  the array of faces of the object or a copy of the star.
+// Only the data of this vertex is written, and its results
+//  are added to 'totals', so several vertices can be processed
+//  at the same time.
+void process_vertex_star (int vertex_index, int* vertexFaces, int numVertexFaces, facePtr faceArray, gaussMapTotalsPtr totals)
 {
 	nodePtr			polygonNormals = NULL;
 	nodePtr			normalList = NULL;
 	nodePtr			extendedNormalList = NULL;
-	nodePtr			vertexFacesList = NULL;
 	nodePtr			loopPolygons = NULL;
 	nodePtr			convex_hull_list = NULL;
 	int				j;
@@ -283,18 +494,15 @@ void process_vertex (int vertex_index)
 	vertexPtr		projectedVertexArray = NULL;	// Array of the vertices projected on a plane.
 	vectorStruct	vertexNormal;
 	vertexDataStruct	current_vertex_data;
+	sphericalContextStruct	spherical_context = {NULL, NULL, NULL};
 
 // printf ("PROCESSING ==> ");
 // print_faces_around_vertex (vertex_index);
 
 	current_vertex_data = VertexDataArray[vertex_index];
 
-	// Get the list of faces that corresponds to
-	//  the current vertex.
-	vertexFacesList = ObjectData.vertexFaceArray[vertex_index];
-
 	// Skip over vertices that do not appear in any face.
-	if (ObjectData.facesPerVertex[vertex_index] == 0)
+	if (numVertexFaces == 0)
 	{
 		// Mark the vertex as deleted, in case the
 		//  mesh is stored into a new obj file.
@@ -302,34 +510,28 @@ void process_vertex (int vertex_index)
 		return;
 	}
 
-	// Order the faces around the current vertex in
-	//  CCW orientation.
-	vertexFacesList = order_faces_around_vertex (vertexFacesList, ObjectData.faceArray, vertex_index);
-	ObjectData.vertexFaceArray[vertex_index] = vertexFacesList;
+	// The temporary data of the vertex is taken from
+	//  the arena, and released all at once at the end.
+	set_scratch_arena (&VertexArena);
 
 	// Get the angle around the current vertex,
 	//  and store it in an array.
-	current_vertex_data.angle_deficit = getAngleAroundVertex (vertexFacesList, ObjectData.faceArray, ObjectData.vertexArray, vertex_index, &(current_vertex_data.border_vertex) );
-	GaussianCurvature += current_vertex_data.angle_deficit;
+	current_vertex_data.angle_deficit = getAngleAroundVertex (vertexFaces, numVertexFaces, faceArray, ObjectData.vertexArray, vertex_index, &(current_vertex_data.border_vertex) );
+	totals->gaussian_curvature += current_vertex_data.angle_deficit;
 
 	// Create a new vertexArray with only the vertices
 	//  in the star of the current vertex.
 	// This will be used to determine the C.H. of the cone
 	//  and used to compute the orientation.
-	coneVertexArray = getConeVertices (vertexFacesList, ObjectData.faceArray, ObjectData.vertexArray, &current_vertex_data);
+	coneVertexArray = getConeVertices (vertexFaces, numVertexFaces, faceArray, ObjectData.vertexArray, &current_vertex_data);
 	// The length of the array will be the number of faces,
 	//  plus one for the current vertex; plus the empty
 	//  vertex at the beginning, but that one is not counted.
 	coneVertexArrayLength = current_vertex_data.points_around_vertex;
 
-	// Determine if the vertex is in a saddle or a cone.
-	convex_hull_list = compute_3D_Convex_Hull (coneVertexArray, coneVertexArrayLength);
-	c_h_vertex = find_vertex_in_object (vertex_index, convex_hull_list, coneVertexArray);
-	freeList (convex_hull_list);
-
 	// Get the artificial normal
 	// vertexNormal = get_average_normal (ObjectData.normalArray[vertex_index]);
-	vertexNormal = getArtificialNormal (vertexFacesList, ObjectData.faceArray, ObjectData.vertexArray);
+	vertexNormal = getArtificialNormal (vertexFaces, numVertexFaces, faceArray, ObjectData.vertexArray);
 	// Add to the array of artificial vertex normals.
 	current_vertex_data.artificial_normal = vertexNormal;
 
@@ -340,7 +542,7 @@ void process_vertex (int vertex_index)
 
 	// Obtain a list of the normals corresponding to
 	//  the current vertex.
-	normalList = getFaceNormalList (vertexFacesList, ObjectData.faceArray, &numNormals, vertex_index, &(current_vertex_data.feature_edge_list));
+	normalList = getFaceNormalList (vertexFaces, numVertexFaces, faceArray, &numNormals, vertex_index, &(current_vertex_data.feature_edge_list));
 
 /*
 if (vertex_index == 8289)
@@ -352,7 +554,7 @@ printVectorList (normalList);
 
 	// Special case for two faces on the same plane.
 	// Add extra vectors between the 2 opposite normals.
-	check_opposite_vectors (normalList, ObjectData.faceArray, ObjectData.vertexArray, &numNormals);
+	check_opposite_vectors (normalList, ObjectData.faceArray, ObjectData.vertexArray, &numNormals, vertex_index);
 
 /*
 if (vertex_index == 8289)
@@ -362,19 +564,36 @@ printVectorList (normalList);
 }
 */
 
-	// Check if the indicatrix generates loops
-	//  of equal spherical polygons.
-	// (i.e.: Monkey Saddle, Penta Saddle)
-	loopPolygons = findLoopNormals (normalList, numNormals, &numLoopPolygons);
-
-	// For each of the looped polygons, do the
-	//  tests for self intersections.
-	for (j=0; j<numLoopPolygons; j++)
+	// A simple polygon of normals, going CCW around the artificial
+	//  normal, is the only spherical polygon of the vertex.
+	// There are no loops or intersections to look for, and the
+	//  vertex is on the C.H. of its star.
+	if ( !current_vertex_data.border_vertex && is_simple_spherical_polygon (normalList, numNormals, &vertexNormal) )
+	{
+		c_h_vertex = TRUE;
+		joinLists ( &(current_vertex_data.normals_around_vertex), copyList (normalList, sizeof (vectorStruct)) );
+		current_vertex_data.spherical_polygon_list = addFrontNode (current_vertex_data.spherical_polygon_list, normalList);
+	}
+	else
 	{
-		normalList = (nodePtr) getNodeData (loopPolygons, j);
+		// Determine if the vertex is in a saddle or a cone.
+		convex_hull_list = compute_3D_Convex_Hull (coneVertexArray, coneVertexArrayLength);
+		c_h_vertex = find_vertex_in_object (vertex_index, convex_hull_list, coneVertexArray);
+		freeList (convex_hull_list);
+
+		// Check if the indicatrix generates loops
+		//  of equal spherical polygons.
+		// (i.e.: Monkey Saddle, Penta Saddle)
+		loopPolygons = findLoopNormals (normalList, numNormals, &numLoopPolygons);
+
+		// For each of the looped polygons, do the
+		//  tests for self intersections.
+		for (j=0; j<numLoopPolygons; j++)
+		{
+			normalList = (nodePtr) getNodeData (loopPolygons, j);
 
-		// Locate where the arcs intersect each other.
-		extendedNormalList = findArcIntersections (normalList, &arcsIntersect);
+			// Locate where the arcs intersect each other.
+			extendedNormalList = findArcIntersections (&spherical_context, normalList, &arcsIntersect);
 
 /*
 if (vertex_index == 8289)
@@ -384,27 +603,29 @@ printVectorList (normalList);
 }
 */
 
-		// Divide the map into individual areas.
-		// current_vertex_data.spherical_polygon_list = NULL;
-		// current_vertex_data.spherical_polygon_list = testPolygonSplit (current_vertex_data.spherical_polygon_list, extendedNormalList);
-		current_vertex_data.spherical_polygon_list = splitSphericalPolygon (current_vertex_data.spherical_polygon_list, extendedNormalList);
-		// Deallocate information no longer used.
-		free_pairs_list ();
+			// Divide the map into individual areas.
+			// current_vertex_data.spherical_polygon_list = NULL;
+			// current_vertex_data.spherical_polygon_list = testPolygonSplit (&spherical_context, current_vertex_data.spherical_polygon_list, extendedNormalList);
+			current_vertex_data.spherical_polygon_list = splitSphericalPolygon (&spherical_context, current_vertex_data.spherical_polygon_list, extendedNormalList);
+			// Deallocate information no longer used.
+			free_pairs_list (&spherical_context);
 
-		// Add to the existing normals, specially for
-		//  the case of two or more loops.
-		joinLists ( &(current_vertex_data.normals_around_vertex), extendedNormalList);
-	}
+			// Add to the existing normals, specially for
+			//  the case of two or more loops.
+			joinLists ( &(current_vertex_data.normals_around_vertex), extendedNormalList);
+		}
 
 // printf ("\nCHECKPOINT 4\n");
 // printVectorList (normalList);
 
-	freeListOfLists (loopPolygons);
+		freeListOfLists (loopPolygons);
+	}
 
 // Correct the areas for the file Data/Bugs/penta-saddlenew-inter1.obj
 // BIG_PENTA_SADDLE_CHEAT (current_vertex_data.spherical_polygon_list);
 
 	numPolygons = getListLength (current_vertex_data.spherical_polygon_list);
+	current_vertex_data.num_polygons = numPolygons;
 
 	// Allocate memory for an array which will hold
 	//  the orientation of each of the areas found.
@@ -432,17 +653,17 @@ printVectorList (normalList);
 
 		localArea = findSphericalPolygonArea (polygonNormals, &current_vertex_data.spherical_polygon_orientation[j], c_h_vertex, coneVertexArray, coneVertexArrayLength);
 		current_vertex_data.curvature += localArea;
-		TotalGaussMapArea += localArea;
+		totals->total_area += localArea;
 
 		if (current_vertex_data.spherical_polygon_orientation[j] == CCW)
 		{
 			positive_polys++;
-			PositiveGaussMapArea += localArea;
+			totals->positive_area += localArea;
 		}
 		else if (current_vertex_data.spherical_polygon_orientation[j] == CW)
 		{
 			negative_polys++;
-			NegativeGaussMapArea += localArea;
+			totals->negative_area += localArea;
 		}
 		else if (current_vertex_data.spherical_polygon_orientation[j] == COL)
 			flat_polys++;
@@ -451,8 +672,8 @@ printVectorList (normalList);
 	}
 
 	// Find the largest curvature of any vertex.
-	if (current_vertex_data.curvature > MAX_TAC)
-		MAX_TAC = current_vertex_data.curvature;
+	if (current_vertex_data.curvature > totals->max_tac)
+		totals->max_tac = current_vertex_data.curvature;
 
 #if (DEBUG >= 1)
 	printf ("  ->POLYGON AREA - DONE!\n\n"); fflush (stdout);
@@ -480,7 +701,178 @@ printVectorList (normalList);
 /////////////////////////////////////////////////
 */
 
-	free (coneVertexArray);
+	// Move the results that are kept to the heap,
+	//  before releasing the memory of the arena.
+	set_scratch_arena (NULL);
+	VertexDataArray[vertex_index].normals_around_vertex = copyList (current_vertex_data.normals_around_vertex, sizeof (vectorStruct));
+	VertexDataArray[vertex_index].spherical_polygon_list = copyListOfLists (current_vertex_data.spherical_polygon_list, sizeof (vectorStruct));
+	VertexDataArray[vertex_index].feature_edge_list = copyList (current_vertex_data.feature_edge_list, sizeof (int));
+	arena_reset (&VertexArena);
+}
+
+
+// Process the vertices from 'Begin' to 'End' with several threads.
+// The threads take blocks of vertices in turns, and add the
+//  results of each block separately. The totals of the blocks
+//  are then added in order, so the results are the same with
+//  any number of threads.
+void process_all_vertices ()
+{
+	gaussMapWorkStruct		work;
+	gaussMapThreadPtr		threads = NULL;
+	int						num_threads;
+	int						i;
+
+	// A mesh without vertices has nothing to process, and
+	//  no progress to show.
+	if (End <= Begin)
+		return;
+
+	work.next_block = 0;
+	work.num_blocks = (End - Begin + VERTICES_PER_BLOCK - 1) / VERTICES_PER_BLOCK;
+	work.vertices_done = 0;
+	work.block_totals = (gaussMapTotalsPtr) xmalloc (sizeof (gaussMapTotalsStruct) * (work.num_blocks + 1));
+	memset (work.block_totals, 0, sizeof (gaussMapTotalsStruct) * (work.num_blocks + 1));
+
+	num_threads = getNumThreads ();
+	if (num_threads > work.num_blocks)
+		num_threads = work.num_blocks;
+	if (num_threads < 1)
+		num_threads = 1;
+
+	threads = (gaussMapThreadPtr) xmalloc (sizeof (gaussMapThreadStruct) * num_threads);
+	for (i=0; i<num_threads; i++)
+	{
+		threads[i].work = &work;
+		threads[i].thread = i;
+	}
+
+	runInThreads (process_vertex_blocks, threads, sizeof (gaussMapThreadStruct), num_threads);
+
+#ifndef DEBUG
+	printProgressStar (End - Begin - 1, End - Begin);
+#endif
+
+	for (i=0; i<work.num_blocks; i++)
+	{
+		TotalGaussMapArea += work.block_totals[i].total_area;
+		PositiveGaussMapArea += work.block_totals[i].positive_area;
+		NegativeGaussMapArea += work.block_totals[i].negative_area;
+		GaussianCurvature += work.block_totals[i].gaussian_curvature;
+		if (work.block_totals[i].max_tac > MAX_TAC)
+			MAX_TAC = work.block_totals[i].max_tac;
+	}
+
+	// The threads worked on copies of the faces, so now they
+	//  are turned as they would be after processing the
+	//  vertices one after the other.
+	for (i=Begin; i<End; i++)
+		rotate_faces_to_vertex (get_vertex_face_indices (&ObjectData, i+1), ObjectData.facesPerVertex[i+1], ObjectData.faceArray, i+1);
+
+	free (threads);
+	free (work.block_totals);
+}
+
+
+// Process blocks of vertices until there are none left.
+// The faces around each vertex are copied and turned to begin
+//  with the vertex, since the faces of the object are shared
+//  by all the threads.
+// Only the first thread shows the progress.
+void* process_vertex_blocks (void* argument)
+{
+	gaussMapThreadPtr		thread = (gaussMapThreadPtr) argument;
+	gaussMapWorkPtr			work = thread->work;
+	facePtr					star_faces = NULL;
+	int*					star_indices = NULL;
+	int*					vertex_faces = NULL;
+	int						star_capacity = 0;
+	int						num_faces;
+	int						block;
+	int						first;
+	int						last;
+	int						done;
+	int						i, j;
+
+	while ( (block = __sync_fetch_and_add (&work->next_block, 1)) < work->num_blocks )
+	{
+		first = Begin + block * VERTICES_PER_BLOCK;
+		last = first + VERTICES_PER_BLOCK;
+		if (last > End)
+			last = End;
+
+		for (i=first; i<last; i++)
+		{
+#if (DEBUG >= 1)
+			printf ("\n---> FOR VERTEX %d:\n", i+1); fflush (stdout);
+#endif
+
+			vertex_faces = get_vertex_face_indices (&ObjectData, i+1);
+			num_faces = ObjectData.facesPerVertex[i+1];
+
+			if (num_faces > star_capacity)
+			{
+				star_capacity = 2 * num_faces;
+				free (star_faces);
+				free (star_indices);
+				star_faces = (facePtr) xmalloc (sizeof (faceStruct) * star_capacity);
+				star_indices = (int*) xmalloc (sizeof (int) * star_capacity);
+			}
+
+			for (j=0; j<num_faces; j++)
+			{
+				star_faces[j] = ObjectData.faceArray[vertex_faces[j]];
+				reorderFace (&star_faces[j], i+1);
+				star_indices[j] = j;
+			}
+
+			process_vertex_star (i+1, star_indices, num_faces, star_faces, &work->block_totals[block]);
+		}
+
+		done = __sync_add_and_fetch (&work->vertices_done, last - first);
+
+#ifndef DEBUG
+		if (thread->thread == 0)
+			printProgressStar (done - 1, End - Begin);
+#endif
+	}
+
+	free (star_faces);
+	free (star_indices);
+
+	// The arena of the calling thread is kept for later vertices.
+	if (thread->thread != 0)
+		arena_free (&VertexArena);
+
+	return (NULL);
+}
+
+
+// Rebuild the data of a vertex whose Gauss Map was read
+//  from the cache, and which is still needed for decimation:
+//  the order of the faces around it, its neighbours, and their
+//  projection on the plane of the artificial normal.
+// The spherical polygons are not computed.
+void restore_vertex_topology (int vertex_index)
+{
+	int*			vertexFaces = NULL;
+	vertexPtr		coneVertexArray = NULL;
+
+	// Get the faces around the current vertex,
+	//  in CCW orientation.
+	vertexFaces = order_vertex_star (vertex_index);
+
+	// Skip over vertices that do not appear in any face.
+	if (ObjectData.facesPerVertex[vertex_index] == 0)
+	{
+		ObjectData.vertexArray[vertex_index].vertexId *= -1;
+		return;
+	}
+
+	coneVertexArray = getConeVertices (vertexFaces, ObjectData.facesPerVertex[vertex_index], ObjectData.faceArray, ObjectData.vertexArray, &VertexDataArray[vertex_index]);
+	project_cone_on_plane (coneVertexArray, &VertexDataArray[vertex_index]);
+
+	scratch_free (coneVertexArray);
 }
 
 
@@ -517,7 +909,7 @@ void find_concave_vertices (vertexDataStruct* current_vertex_data, int vertex_in
 	int			num_neighbours = current_vertex_data->points_around_vertex;
 	int			neighbour_index;
 	int			i;
-	vectorPtr	test_vector = NULL;
+	vectorStruct	test_vector;
 
 
 	for (i=2; i<=num_neighbours; i++)
@@ -526,8 +918,8 @@ void find_concave_vertices (vertexDataStruct* current_vertex_data, int vertex_in
 		// Build a vector along the edges,
 		//  and then compare it to the artificial
 		//  vertex normal.
-		test_vector = vectorFromVertices ( &(ObjectData.vertexArray[neighbour_index]), &(ObjectData.vertexArray[vertex_index]) );
-		if ( dotProduct (test_vector, &(current_vertex_data->artificial_normal)) < 0 )
+		test_vector = vector_from_vertices ( &(ObjectData.vertexArray[neighbour_index]), &(ObjectData.vertexArray[vertex_index]) );
+		if ( dotProduct (&test_vector, &(current_vertex_data->artificial_normal)) < 0 )
 		{
 			if (current_vertex_data->type == MIXED)
 				current_vertex_data->type = MIXED_CONCAVE;
@@ -549,7 +941,7 @@ void split_mixed_vertex (int vertex_index, vertexPtr coneVertexArray, int coneVe
 	int				list_length = 0;
 	nodePtr			coneConvexHull = NULL;
 	facePtr			face = NULL;
-	vectorPtr		plane_normal;
+	vectorStruct	plane_normal;
 	vertexStruct	current_vertex;
 	vertexStruct	plane_vertex;
 	vertexStruct	projected_vertex;
@@ -592,9 +984,9 @@ printf ("\t\t\tf %d (%d, %d, %d)\n",  face->faceId, face->vertex[0], face->verte
 					v1 = coneVertexArray[ face->vertex[0] ];
 					v2 = coneVertexArray[ face->vertex[1] ];
 					v3 = coneVertexArray[ face->vertex[2] ];
-					plane_normal = getTriangleNormal (v1, v2, v3);
+					plane_normal = triangle_normal (&v1, &v2, &v3);
 
-					projected_vertex = project_vertex_on_plane (*plane_normal, plane_vertex, current_vertex);
+					projected_vertex = project_vertex_on_plane (plane_normal, plane_vertex, current_vertex);
 
 Projected_Vertex = projected_vertex;
 printf ("******* At new vertex: %lf, %lf, %lf\n", projected_vertex.x, projected_vertex.y, projected_vertex.z);
@@ -605,114 +997,67 @@ printf ("******* At new vertex: %lf, %lf, %lf\n", projected_vertex.x, projected_
 }
 
 
-// Run through the list of faces and ensure that they are 
-//  in CCW order.
-// Returns the same list, with the elements ordered.
-nodePtr order_faces_around_vertex (nodePtr tempList, facePtr faceArray, int vertex_index)
+// Get the faces around a vertex in CCW order, and make
+//  the vertex the first one of each face.
+// The faces were ordered when the object was read, but
+//  during decimation they are also kept in a list which
+//  changes, so then the list is ordered again and copied
+//  into the array of faces of the vertex.
+// Returns the faces of the vertex in the array.
+int* order_vertex_star (int vertex_index)
 {
-	int			list_length = getListLength(tempList);
 	int			i;
-	int*		index = NULL;
-	int			nextVertex = 0;
-	int			previousVertex = 0;
-	nodePtr		newList = NULL;
-	nodePtr		newListTail = NULL;
-	faceStruct	face;
-
-// if (vertex_index == 8289)
-// printf ("Resorting list of faces around vertex %d:\n", vertex_index);
-
-	// Make sure each individual face has the vertex
-	//  of interest first.
-	for (i=0; i<list_length; i++)
-	{
-		index = (int*) getNodeData (tempList, i);
-		face = faceArray[*index];
-		reorderFace (&face, vertex_index);
-		faceArray[*index] = face;
-// if (vertex_index == 8289)
-// printf ("\tFace %d: %d, %d, %d\n", face.faceId, face.vertex[0], face.vertex[1], face.vertex[2]);
-	}
+	int*		vertex_faces = NULL;
+	nodePtr		pointer = NULL;
 
-	// Insert a face to begin with.
-	index = (int*) removeNode (&tempList, 0);
-	face = faceArray[*index];
-	newListTail = addNode (newListTail, index);
-	newList = newListTail;
-	list_length--;
-
-	// Set the variables for the faces that should
-	//  be inserted before or after the current list.
-	nextVertex = face.vertex[2];
-	previousVertex = face.vertex[1];
-
-	// Exit the for loop when all the faces have
-	//  been inserted in their correct position.
-	for (i=0; list_length > 0; i++)
+	if (ObjectData.vertexFaceArray != NULL)
 	{
-		index = (int*) getNodeData (tempList, i%list_length);
-		face = faceArray[*index];
-
-		// Insert a face at the end of the list.
-		if (face.vertex[1] == nextVertex)
-		{
-			nextVertex = face.vertex[2];
-			newListTail = addNode (newListTail, index);
-
-			removeNode (&tempList, i%list_length);
-			list_length--;
-		}
-		// Insert a face at the beginning of the list.
-		else if (face.vertex[2] == previousVertex)
-		{
-			previousVertex = face.vertex[1];
-			newList = addFrontNode (newList, index);
+		set_vertex_faces (&ObjectData, vertex_index, ObjectData.vertexFaceArray[vertex_index]);
+		vertex_faces = get_vertex_face_indices (&ObjectData, vertex_index);
+		order_vertex_faces (vertex_faces, ObjectData.facesPerVertex[vertex_index], ObjectData.faceArray, vertex_index);
 
-			removeNode (&tempList, i%list_length);
-			list_length--;
-		}
+		pointer = ObjectData.vertexFaceArray[vertex_index];
+		for (i=0; pointer != NULL; i++, pointer = pointer->next)
+			*(int*) pointer->data = vertex_faces[i];
 	}
 
-	return (newList);
+	vertex_faces = get_vertex_face_indices (&ObjectData, vertex_index);
+	rotate_faces_to_vertex (vertex_faces, ObjectData.facesPerVertex[vertex_index], ObjectData.faceArray, vertex_index);
+
+	return (vertex_faces);
 }
 
 
 // Compute the sum of the angles of the faces around a vertex.
-// Receives as parameters the list of the faces for a vertex
+// Receives as parameters the faces for a vertex
 //  and the array that contains all the vertices.
-double getAngleAroundVertex (nodePtr faceIndexList, facePtr faceArray, vertexPtr vertexArray, int vertexIndex, boolean *border)
+double getAngleAroundVertex (int* faceIndices, int numFaces, facePtr faceArray, vertexPtr vertexArray, int vertexIndex, boolean *border)
 {
 	int				i;
 	int				first_index = -1;
-	int				list_length = getListLength (faceIndexList);
-	int*			index;
 	double			angle = 0.0;
 	double			total = 0.0;
 	faceStruct		face;
 	vertexStruct	vertex1;
 	vertexStruct	vertex2;
 	vertexStruct	vertex3;
-	vectorPtr       vector1 = NULL;
-	vectorPtr       vector2 = NULL;
+	vectorStruct	vector1;
+	vectorStruct	vector2;
 
-	for (i=0; i<list_length; i++)
+	for (i=0; i<numFaces; i++)
 	{
-		index = (int*) getNodeData (faceIndexList, i);
-		face = faceArray[*index];
+		face = faceArray[faceIndices[i]];
 		vertex1 = vertexArray[(face.vertex[0])];
 		vertex2 = vertexArray[(face.vertex[1])];
 		vertex3 = vertexArray[(face.vertex[2])];
 
-		vector1 = vectorFromVertices (&vertex1, &vertex2);
-		vector2 = vectorFromVertices (&vertex1, &vertex3);
+		vector1 = vector_from_vertices (&vertex1, &vertex2);
+		vector2 = vector_from_vertices (&vertex1, &vertex3);
 
-		angle = angleBetweenVectors (vector1, vector2);
+		angle = angleBetweenVectors (&vector1, &vector2);
 
 		total += angle;
 
-		free (vector1);
-		free (vector2);
-
 		if (first_index == -1)
 			first_index = face.vertex[1];
 	}
@@ -732,20 +1077,18 @@ double getAngleAroundVertex (nodePtr faceIndexList, facePtr faceArray, vertexPtr
 
 
 // Create an array of vertices from those indicated
-//  in a list of faces.
+//  in an array of faces.
 // Returns an array, with the vertices corresponding
 //  to a cone.
 // Also creates an array with only the indices of 
 //  the neighbours, and inserts it into the
 //  VertexDataArray.
-vertexPtr getConeVertices (nodePtr faceList, facePtr faceArray, vertexPtr vertexArray, vertexDataPtr current_vertex_data)
+vertexPtr getConeVertices (int* faceIndices, int numFaces, facePtr faceArray, vertexPtr vertexArray, vertexDataPtr current_vertex_data)
 {
 	vertexPtr		coneVertexArray = NULL;
 	vertexPtr		empty_vertex = NULL;
-	int				list_length = getListLength (faceList);
-	int				num_neighbours = list_length;
+	int				num_neighbours = numFaces;
 	int				i;
-	int*			index = NULL;
 	int*			neighbourIndexArray = NULL;
 	faceStruct		face;
 
@@ -758,7 +1101,7 @@ vertexPtr getConeVertices (nodePtr faceList, facePtr faceArray, vertexPtr vertex
 	// The array will be the length of the number
 	//  of neighbours plus 2: 1 for the empty
 	//  vertex and 1 for the current vertex.
-	coneVertexArray = (vertexPtr) xmalloc (sizeof (vertexStruct) * (num_neighbours + 2));
+	coneVertexArray = (vertexPtr) scratch_malloc (sizeof (vertexStruct) * (num_neighbours + 2));
 	// The array of neighbours also has an empty
 	//  vertex, and the current vertex.
 	// This is only an array of integers, with
@@ -777,12 +1120,11 @@ vertexPtr getConeVertices (nodePtr faceList, facePtr faceArray, vertexPtr vertex
 	//  complain.
 	empty_vertex = createVertex (0, 0, 0, 0);
 	memcpy (&coneVertexArray[0], empty_vertex, sizeof (vertexStruct));
-	free (empty_vertex);
+	scratch_free (empty_vertex);
 	coneVertexArray[0].extra = 0;
 
 	// Get the first face.
-	index = (int*) getNodeData (faceList, 0);
-	face = faceArray[*index];
+	face = faceArray[faceIndices[0]];
 
 	// Copy the structure for the current vertex.
 	memcpy (&coneVertexArray[1], &vertexArray[face.vertex[0]], sizeof (vertexStruct));
@@ -794,10 +1136,9 @@ vertexPtr getConeVertices (nodePtr faceList, facePtr faceArray, vertexPtr vertex
 	neighbourIndexArray[2] = face.vertex[1];
 
 	// For each of the remaining faces.
-	for (i=1; i<list_length; i++)
+	for (i=1; i<numFaces; i++)
 	{
-		index = (int*) getNodeData (faceList, i);
-		face = faceArray[*index];
+		face = faceArray[faceIndices[i]];
 		// Copy the structure for the i'th vertex in the cone.
 		memcpy (&coneVertexArray[i+2], &vertexArray[face.vertex[1]], sizeof (vertexStruct));
 		// coneVertexArray[i+2].vertexId = i+2;
@@ -807,8 +1148,7 @@ vertexPtr getConeVertices (nodePtr faceList, facePtr faceArray, vertexPtr vertex
 	// Add another neighbour for border vertices.
 	if (current_vertex_data->border_vertex == TRUE)
 	{
-		index = (int*) getNodeData (faceList, list_length-1);
-		face = faceArray[*index];
+		face = faceArray[faceIndices[numFaces-1]];
 		// Copy the structure for the i'th vertex in the cone.
 		memcpy (&coneVertexArray[i+2], &vertexArray[face.vertex[2]], sizeof (vertexStruct));
 		// coneVertexArray[i+2].vertexId = i+2;
@@ -838,41 +1178,36 @@ vectorStruct get_average_normal (vertexStruct vertex_normal)
 
 // Compute an artificial normal vector for a vertex in a cone.
 // New algorithm based on Shroeder et al.
-vectorStruct getArtificialNormal (nodePtr face_list, facePtr face_array, vertexPtr vertex_array)
+vectorStruct getArtificialNormal (int* face_indices, int num_faces, facePtr face_array, vertexPtr vertex_array)
 {
 	int				i;
-	int				list_length = getListLength (face_list);
-	int*			face_index = NULL;
 	faceStruct		face;
-	vectorStruct	sum_vector;
 	vectorStruct	average_vector;
+	double			sum_i = 0.0;
+	double			sum_j = 0.0;
+	double			sum_k = 0.0;
 	double			cone_area;
 	double			triangle_area;
 
-	sum_vector.i = 0.0;
-	sum_vector.j = 0.0;
-	sum_vector.k = 0.0;
-
-	cone_area = area3D_cone (face_list, vertex_array, face_array);
+	cone_area = area3D_cone (face_indices, num_faces, vertex_array, face_array);
 
 	// Sum the face vectors multiplied by
 	//  the face areas.
-	for (i=0; i<list_length; i++)
+	for (i=0; i<num_faces; i++)
 	{
-		face_index = (int*) getNodeData (face_list, i);
-		face = face_array[*face_index];
+		face = face_array[face_indices[i]];
 					   
 		triangle_area = area3D_face (face, vertex_array);
 
-		sum_vector.i += face.faceNormal->i * triangle_area;
-		sum_vector.j += face.faceNormal->j * triangle_area;
-		sum_vector.k += face.faceNormal->k * triangle_area;
+		sum_i += face.faceNormal->i * triangle_area;
+		sum_j += face.faceNormal->j * triangle_area;
+		sum_k += face.faceNormal->k * triangle_area;
 	}
 
 	// Divide by the area of the cone.
-	average_vector.i = sum_vector.i / cone_area;
-	average_vector.j = sum_vector.j / cone_area;
-	average_vector.k = sum_vector.k / cone_area;
+	average_vector.i = sum_i / cone_area;
+	average_vector.j = sum_j / cone_area;
+	average_vector.k = sum_k / cone_area;
 
 	normalizeVector (&average_vector);
 
@@ -990,20 +1325,73 @@ void freeObjectMemory ()
 
 	free (VertexDataArray);
 
+	arena_free (&VertexArena);
+
 	free (ObjectData.vertexArray);
 	free (ObjectData.normalArray);
 	freeList (ObjectData.edgeList);
-	for (i=1; i<=ObjectData.numVertices; i++)
-	{
-		freeList (ObjectData.vertexFaceArray[i]);
-	}
+	free_vertex_face_adjacency (&ObjectData);
 	for (i=1; i<=ObjectData.numFaces; i++)
 	{
 		free (ObjectData.faceArray[i].faceNormal);
 	}
 	free (ObjectData.faceArray);
-	free (ObjectData.vertexFaceArray);
-	free (ObjectData.facesPerVertex);
+	free (GaussMapCacheFile);
+
+	// Leave the variables ready to read another object.
+	VertexDataArray = NULL;
+	GaussMapCacheFile = NULL;
+	memset (&ObjectData, 0, sizeof (objectStruct));
+}
+
+
+// Move the state of the object being processed into a
+//  structure, leaving the global variables empty.
+void save_gauss_map_state (gaussMapStatePtr state)
+{
+	state->object_data = ObjectData;
+	state->vertex_data_array = VertexDataArray;
+	state->show_vertex = ShowVertex;
+	state->begin = Begin;
+	state->end = End;
+	state->totals.total_area = TotalGaussMapArea;
+	state->totals.positive_area = PositiveGaussMapArea;
+	state->totals.negative_area = NegativeGaussMapArea;
+	state->totals.gaussian_curvature = GaussianCurvature;
+	state->totals.max_tac = MAX_TAC;
+	state->gauss_map_cache_file = GaussMapCacheFile;
+	state->vertex_arena = VertexArena;
+
+	memset (&ObjectData, 0, sizeof (objectStruct));
+	VertexDataArray = NULL;
+	ShowVertex = 0;
+	Begin = 0;
+	End = 0;
+	TotalGaussMapArea = 0.0;
+	PositiveGaussMapArea = 0.0;
+	NegativeGaussMapArea = 0.0;
+	GaussianCurvature = 0.0;
+	MAX_TAC = 0.0;
+	GaussMapCacheFile = NULL;
+	memset (&VertexArena, 0, sizeof (arenaStruct));
+}
+
+
+// Make the object in a structure the one being processed.
+void restore_gauss_map_state (gaussMapStatePtr state)
+{
+	ObjectData = state->object_data;
+	VertexDataArray = state->vertex_data_array;
+	ShowVertex = state->show_vertex;
+	Begin = state->begin;
+	End = state->end;
+	TotalGaussMapArea = state->totals.total_area;
+	PositiveGaussMapArea = state->totals.positive_area;
+	NegativeGaussMapArea = state->totals.negative_area;
+	GaussianCurvature = state->totals.gaussian_curvature;
+	MAX_TAC = state->totals.max_tac;
+	GaussMapCacheFile = state->gauss_map_cache_file;
+	VertexArena = state->vertex_arena;
 }
 
 
@@ -1015,6 +1403,7 @@ void testTriangulation (nodePtr polygonList, spinType* orientations)
 {
 	nodePtr			polygonVertices = NULL;
 	nodePtr			leanPolygon = NULL;
+	sphericalContextStruct	spherical_context = {NULL, NULL, NULL};
 	int				numPolygons = getListLength (polygonList);
 	int				numTriangles;
 	int				numVertices;
@@ -1029,11 +1418,11 @@ void testTriangulation (nodePtr polygonList, spinType* orientations)
 		numVertices = getListLength (leanPolygon);
 
 		// Triangulate the polygon.
-		triangulateSphericalPolygon (leanPolygon, orientations[i]);
-		numTriangles = getListLength (PolygonTriangles);
+		triangulateSphericalPolygon (&spherical_context, leanPolygon, orientations[i]);
+		numTriangles = getListLength (spherical_context.polygon_triangles);
 
-		freeListOfLists (PolygonTriangles);
-		PolygonTriangles = NULL;
+		freeListOfLists (spherical_context.polygon_triangles);
+		spherical_context.polygon_triangles = NULL;
 	}
 }
 
@@ -1043,7 +1432,7 @@ void findFacesIntersection (int faceIndex1, int faceIndex2)
 {
 	vectorPtr		vector1;
 	vectorPtr		vector2;
-	vectorPtr		interVector = NULL;
+	vectorStruct	interVector;
 
 	printf ("============= Vector of Intersection ==================\n");
 
@@ -1052,9 +1441,9 @@ void findFacesIntersection (int faceIndex1, int faceIndex2)
 	printf ("Vector 1 (face %d): %lf %lf %lf\n", faceIndex1, vector1->i, vector1->j, vector1->k);
 	printf ("Vector 2 (face %d): %lf %lf %lf\n", faceIndex2, vector2->i, vector2->j, vector2->k);
 
-	interVector = crossProduct (vector1, vector2);
-	normalizeVector (interVector);
-	printf ("Intersection Vector: %lf %lf %lf\n", interVector->i, interVector->j, interVector->k);
+	interVector = cross_product (vector1, vector2);
+	normalizeVector (&interVector);
+	printf ("Intersection Vector: %lf %lf %lf\n", interVector.i, interVector.j, interVector.k);
 
 	printf ("============= Vector of Intersection ==================\n");
 }
@@ -1139,16 +1528,12 @@ void herisson_swap (objectStruct ObjectData)
 void print_faces_around_vertex (int vertex_id)
 {
 	int			i;
-	int*		face_index;
-	nodePtr		faces_list = NULL;
+	int*		face_indices = NULL;
 
-	faces_list = ObjectData.vertexFaceArray[vertex_id];
+	face_indices = get_vertex_face_indices (&ObjectData, vertex_id);
 
 	printf ("FACES AROUND VERTEX %d:\t", vertex_id);
 	for (i=0; i<ObjectData.facesPerVertex[vertex_id]; i++)
-	{
-		face_index = (int*) getNodeData (faces_list, i);
-		printf (" %d", *face_index);
-	}
+		printf (" %d", face_indices[i]);
 	printf ("\n");
 }
@@ -1,29 +1,86 @@
 #include <stdio.h>
+#include <strings.h>
 #include <math.h>
 
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 #include "vertices.h"
 #include "geometry.h"
 #include "faces.h"
 #include "edges.h"
+#include "edgeMap.h"
 #include "object3D.h"
+#include "meshStorage.h"
+#include "adjacency.h"
+#include "halfEdge.h"
 #include "objParser.h"
+#include "plyParser.h"
+#include "offParser.h"
+#include "meshCache.h"
 #include "vertexGeometry.h"
+#include "polygonArray.h"
 #include "sphericalGeometry.h"
+#include "gaussMapCache.h"
 #include "convexHull3D.h"
 #include "normals3D.h"
+#include "objWriter.h"
+#include "plyWriter.h"
 
 
+// Data structures
+
+// STATE OF THE GAUSS MAP
+// Everything kept about the object being processed.
+// The programs work on a single object, held in global
+//  variables, which can be moved into this structure to
+//  work on another object and be restored later.
+typedef struct gaussMapStateStruct
+{
+	objectStruct			object_data;
+	vertexDataStruct*		vertex_data_array;
+	int						show_vertex;
+	int						begin;
+	int						end;
+	gaussMapTotalsStruct	totals;
+	char*					gauss_map_cache_file;
+	// Memory blocks of the arena used while processing the vertices.
+	arenaStruct				vertex_arena;
+} gaussMapStateStruct;
+
+typedef gaussMapStateStruct* gaussMapStatePtr;
+
+
+// Function declarations
+
 // Read the input file and generate an Object structure.
+// The program is stopped if the file can not be read.
 void generateObject (char* inputFile);
 
+// Read the input file into the Object structure, using the
+//  caches of the mesh and the Gauss map if 'use_caches' is set.
+// Returns FALSE, with a message, if the file can not be read.
+boolean read_object (char* inputFile, boolean use_caches);
+
+// Check whether a file name ends with an extension, ignoring
+//  case and an additional '.gz' suffix.
+boolean has_extension (char* file_name, char* extension);
+
 // Process the object data to obtain the Gauss Map.
 void generateGaussMap ();
 
 // Deallocate the memory used for the global variables.
 void freeObjectMemory ();
 
+// Move the state of the object being processed into a
+//  structure, leaving the global variables empty.
+void save_gauss_map_state (gaussMapStatePtr state);
+
+// Make the object in a structure the one being processed.
+// The global variables must be empty, as left by
+//  'save_gauss_map_state'.
+void restore_gauss_map_state (gaussMapStatePtr state);
+
 // Do all of the checks for the vertex indicated.
 // Fills all the data structures for that vertex.
 void process_vertex (int vertex_index);
@@ -0,0 +1,412 @@
+#include <stdio.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "gaussMap.h"
+#include "gaussMapLibrary.h"
+
+// Largest number of worker processes.
+#define MAX_WORKERS		256
+
+// Largest length of a line in a list of files.
+#define MAX_LINE		4096
+
+// Largest length of a line of the summary.
+#define SUMMARY_LENGTH	(MAX_LINE + 512)
+
+// Values of a list of files, with the number
+//  of elements and the space available.
+typedef struct
+{
+	char**		names;
+	int			count;
+	int			capacity;
+} fileListStruct;
+
+typedef fileListStruct* fileListPtr;
+
+// Information shared by the parent and the worker processes.
+typedef struct
+{
+	int			next_job;
+	int			current_job[MAX_WORKERS];
+} batchSharedStruct;
+
+typedef batchSharedStruct* batchSharedPtr;
+
+// Function declarations
+void usage (char* programName);
+void add_file (fileListPtr file_list, char* name);
+boolean is_mesh_file (char* name);
+void add_directory (fileListPtr file_list, char* directory);
+void add_file_list (fileListPtr file_list, char* list_name);
+int compare_names (const void* name_1, const void* name_2);
+double get_seconds (void);
+void write_summary (int summary_fd, char* line);
+void run_worker (fileListPtr file_list, batchSharedPtr shared, int worker, int summary_fd);
+pid_t start_worker (fileListPtr file_list, batchSharedPtr shared, int worker, int summary_fd);
+
+
+// Program entry point
+// Processes many meshes without starting a new program for
+//  each one. A pool of worker processes takes the meshes in
+//  turns, and each worker processes its meshes one after
+//  the other, reusing its memory.
+int main (int argc, char* argv[])
+{
+	fileListStruct		file_list = {NULL, 0, 0};
+	batchSharedPtr		shared = NULL;
+	pid_t				workers[MAX_WORKERS];
+	pid_t				pid;
+	char				line[SUMMARY_LENGTH];
+	char*				summary_name = NULL;
+	int					summary_fd;
+	int					num_workers = 0;
+	int					running = 0;
+	int					status;
+	int					job;
+	int					i;
+	struct stat			file_status;
+
+	// Read the options.
+	for (i=1; i<argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++)
+	{
+		if (!strcmp (argv[i], "-j") && i+1 < argc)
+			num_workers = atoi (argv[++i]);
+		else if (!strcmp (argv[i], "-o") && i+1 < argc)
+			summary_name = argv[++i];
+		else
+			usage (argv[0]);
+	}
+
+	if (i >= argc)
+		usage (argv[0]);
+
+	// Collect the names of the meshes to process.
+	for (; i<argc; i++)
+	{
+		if (is_mesh_file (argv[i]))
+			add_file (&file_list, argv[i]);
+		else if ( (stat (argv[i], &file_status) == 0) && S_ISDIR (file_status.st_mode) )
+			add_directory (&file_list, argv[i]);
+		else
+			add_file_list (&file_list, argv[i]);
+	}
+
+	if (num_workers < 1)
+		num_workers = getNumThreads ();
+	if (num_workers > MAX_WORKERS)
+		num_workers = MAX_WORKERS;
+	if (num_workers > file_list.count)
+		num_workers = file_list.count;
+
+	// Each worker would start a thread per processor for the
+	//  vertices of its mesh, so with several workers they
+	//  process their meshes in a single thread.
+	if (num_workers > 1)
+		setenv ("GAUSSMAP_THREADS", "1", 1);
+
+	// The workers send their own output to /dev/null, so the
+	//  summary is written through a copy of stdout.
+	if (summary_name != NULL)
+		summary_fd = open (summary_name, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+	else
+		summary_fd = dup (STDOUT_FILENO);
+
+	if (summary_fd < 0)
+	{
+		printf ("Unable to open file: '%s'. Exiting.\n", (summary_name != NULL) ? summary_name : "stdout");
+		exit (1);
+	}
+
+	// The counter of jobs must be seen by all the processes.
+	shared = (batchSharedPtr) mmap (NULL, sizeof (batchSharedStruct), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED)
+	{
+		printf ("Unable to allocate memory. Exiting.\n");
+		exit (1);
+	}
+	shared->next_job = 0;
+
+	write_summary (summary_fd, "file\tstatus\tvertices\tfaces\tabsolute_curvature\tpositive_curvature\tnegative_curvature\tgaussian_curvature\tread_seconds\tgauss_map_seconds\ttotal_seconds\n");
+	fflush (stdout);
+
+	for (i=0; i<num_workers; i++)
+	{
+		workers[i] = start_worker (&file_list, shared, i, summary_fd);
+		running++;
+	}
+
+	// Wait for the workers to finish.
+	// A worker stops the whole program when it finds an error
+	//  in a mesh, so that mesh is reported as failed and a new
+	//  worker continues with the remaining meshes.
+	while (running > 0)
+	{
+		pid = wait (&status);
+		if (pid < 0)
+			break;
+
+		for (i=0; i<num_workers && workers[i] != pid; i++);
+		if (i == num_workers)
+			continue;
+		running--;
+
+		if (WIFEXITED (status) && WEXITSTATUS (status) == 0)
+			continue;
+
+		job = shared->current_job[i];
+		if (job >= 0 && job < file_list.count)
+		{
+			snprintf (line, SUMMARY_LENGTH, "%s\tfailed\t0\t0\t0\t0\t0\t0\t0\t0\t0\n", file_list.names[job]);
+			write_summary (summary_fd, line);
+		}
+
+		if (shared->next_job < file_list.count)
+		{
+			workers[i] = start_worker (&file_list, shared, i, summary_fd);
+			running++;
+		}
+	}
+
+	close (summary_fd);
+
+	munmap (shared, sizeof (batchSharedStruct));
+
+	for (i=0; i<file_list.count; i++)
+		free (file_list.names[i]);
+	free (file_list.names);
+
+	return (0);
+}
+
+
+// Prints information about the arguments to supply to the program.
+void usage (char* programName)
+{
+	printf ("Usage: %s [-j workers] [-o summary_file] input ...\n", programName);
+	printf ("\tinput:\t\tmesh file, directory with meshes, or file with a list of meshes ('-' for stdin)\n");
+	printf ("\tworkers:\tnumber of meshes processed at the same time (with one thread each when more than 1)\n");
+	printf ("\tsummary_file:\tfile for the results, instead of stdout\n");
+	exit (1);
+}
+
+
+// Add a copy of a name at the end of the list of files.
+void add_file (fileListPtr file_list, char* name)
+{
+	if (file_list->count == file_list->capacity)
+	{
+		file_list->capacity = file_list->capacity * 2 + 16;
+		file_list->names = (char**) realloc (file_list->names, sizeof (char*) * file_list->capacity);
+		if (file_list->names == NULL)
+		{
+			printf ("Unable to allocate memory. Exiting.\n");
+			exit (1);
+		}
+	}
+
+	file_list->names[file_list->count] = (char*) xmalloc (strlen (name) + 1);
+	strcpy (file_list->names[file_list->count], name);
+	file_list->count++;
+}
+
+
+// Check whether the name of a file has the extension
+//  of one of the formats that can be read.
+boolean is_mesh_file (char* name)
+{
+	return (	has_extension (name, ".obj") || has_extension (name, ".ply") ||
+				has_extension (name, ".off") || has_extension (name, ".gmb") );
+}
+
+
+// Add the meshes in a directory, sorted by name.
+// Mesh caches are skipped, since they may be kept next to their sources.
+void add_directory (fileListPtr file_list, char* directory)
+{
+	DIR*				handle = NULL;
+	struct dirent*		entry = NULL;
+	fileListStruct		names = {NULL, 0, 0};
+	char*				path = NULL;
+	int					i;
+
+	handle = opendir (directory);
+	if (handle == NULL)
+	{
+		printf ("Unable to open directory: '%s'. Exiting.\n", directory);
+		exit (1);
+	}
+
+	while ( (entry = readdir (handle)) != NULL )
+	{
+		if (is_mesh_file (entry->d_name) && !has_extension (entry->d_name, ".gmb"))
+			add_file (&names, entry->d_name);
+	}
+	closedir (handle);
+
+	qsort (names.names, names.count, sizeof (char*), compare_names);
+
+	for (i=0; i<names.count; i++)
+	{
+		path = (char*) xmalloc (strlen (directory) + strlen (names.names[i]) + 2);
+		sprintf (path, "%s/%s", directory, names.names[i]);
+		add_file (file_list, path);
+		free (path);
+		free (names.names[i]);
+	}
+	free (names.names);
+}
+
+
+// Add the meshes named in a text file, one per line.
+// Empty lines and lines beginning with '#' are skipped.
+void add_file_list (fileListPtr file_list, char* list_name)
+{
+	FILE*		list_fd = NULL;
+	char		line[MAX_LINE];
+	size_t		length;
+
+	if (!strcmp (list_name, "-"))
+		list_fd = stdin;
+	else
+		list_fd = xfopen (list_name, "r");
+
+	while (fgets (line, MAX_LINE, list_fd) != NULL)
+	{
+		length = strlen (line);
+		while ( (length > 0) && (line[length-1] == '\n' || line[length-1] == '\r' || line[length-1] == ' ') )
+			line[--length] = '\0';
+
+		if ( (length > 0) && (line[0] != '#') )
+			add_file (file_list, line);
+	}
+
+	if (list_fd != stdin)
+		fclose (list_fd);
+}
+
+
+// Comparison of names for 'qsort'.
+int compare_names (const void* name_1, const void* name_2)
+{
+	return (strcmp (*(char**) name_1, *(char**) name_2));
+}
+
+
+// Get the time from a monotonic clock, in seconds.
+double get_seconds (void)
+{
+	struct timespec		now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec + now.tv_nsec * 1e-9);
+}
+
+
+// Write a line of the summary with a single call, so that
+//  the lines of different workers do not get mixed.
+void write_summary (int summary_fd, char* line)
+{
+	size_t		length = strlen (line);
+	ssize_t		written;
+
+	while (length > 0)
+	{
+		written = write (summary_fd, line, length);
+		if (written <= 0)
+			break;
+		line += written;
+		length -= written;
+	}
+}
+
+
+// Process meshes until there are no more left in the list.
+// Each mesh is taken from the shared counter, so the workers
+//  that finish first take more of them.
+// All the meshes of a worker are read into the same handle,
+//  which keeps the memory used for the previous one.
+// The messages printed while processing are discarded.
+void run_worker (fileListPtr file_list, batchSharedPtr shared, int worker, int summary_fd)
+{
+	gaussMapMeshPtr				mesh = NULL;
+	gaussMapMeshResultStruct	result;
+	char						line[SUMMARY_LENGTH];
+	int							job;
+	int							null_fd;
+	double						start;
+	double						read_end;
+	double						stop;
+
+	null_fd = open ("/dev/null", O_WRONLY);
+	if (null_fd >= 0)
+	{
+		dup2 (null_fd, STDOUT_FILENO);
+		close (null_fd);
+	}
+
+	// The caches are used as in the other programs.
+	mesh = gauss_map_mesh_new ();
+	gauss_map_mesh_use_caches (mesh, mesh_cache_enabled ());
+
+	while ( (job = __sync_fetch_and_add (&shared->next_job, 1)) < file_list->count )
+	{
+		shared->current_job[worker] = job;
+
+		start = get_seconds ();
+		if (!gauss_map_mesh_load (mesh, file_list->names[job]))
+		{
+			snprintf (line, SUMMARY_LENGTH, "%s\tfailed\t0\t0\t0\t0\t0\t0\t0\t0\t0\n", file_list->names[job]);
+			write_summary (summary_fd, line);
+			shared->current_job[worker] = -1;
+			continue;
+		}
+		read_end = get_seconds ();
+		gauss_map_mesh_compute (mesh);
+		stop = get_seconds ();
+
+		result = gauss_map_mesh_result (mesh);
+
+		snprintf (line, SUMMARY_LENGTH, "%s\tok\t%d\t%d\t%.10g\t%.10g\t%.10g\t%.10g\t%.3f\t%.3f\t%.3f\n",
+				file_list->names[job], result.num_vertices, result.num_faces,
+				result.absolute_curvature, result.positive_curvature, result.negative_curvature, result.gaussian_curvature,
+				read_end - start, stop - read_end, stop - start);
+		fflush (stdout);
+		write_summary (summary_fd, line);
+
+		shared->current_job[worker] = -1;
+	}
+
+	gauss_map_mesh_free (mesh);
+
+	fflush (stdout);
+	exit (0);
+}
+
+
+// Create a new worker process.
+// Returns the id of the process.
+pid_t start_worker (fileListPtr file_list, batchSharedPtr shared, int worker, int summary_fd)
+{
+	pid_t		pid;
+
+	shared->current_job[worker] = -1;
+
+	pid = fork ();
+	if (pid < 0)
+	{
+		printf ("Unable to create process. Exiting.\n");
+		exit (1);
+	}
+
+	if (pid == 0)
+		run_worker (file_list, shared, worker, summary_fd);
+
+	return (pid);
+}
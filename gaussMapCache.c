@@ -0,0 +1,220 @@
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "object3D.h"
+#include "vertexGeometry.h"
+#include "meshCache.h"
+#include "gaussMapCache.h"
+
+// Identification of the Gauss map cache files.
+// The version must be changed whenever the layout
+//  of the file, or the way the results are computed, changes.
+#define GAUSS_MAP_CACHE_MAGIC		"GMC"
+#define GAUSS_MAP_CACHE_VERSION		3
+#define GAUSS_MAP_CACHE_BYTE_ORDER	0x01020304
+
+// Header at the beginning of the cache file.
+// It is followed by these arrays, for the vertices
+//  beginning with 1:
+//	double	values [num_vertices][5]	(curvature, angle_deficit, artificial_normal i, j, k)
+//	int		flags [num_vertices][3]		(type, border_vertex, num_polygons)
+typedef struct
+{
+	char					magic[4];
+	int						version;
+	int						byte_order;
+	int						num_vertices;
+	int						precision;		// Size of the type 'real' that wrote the file.
+	unsigned long long		hash;
+	gaussMapTotalsStruct	totals;
+} gaussMapCacheHeader;
+
+
+// Mix a 64 bit word into a hash value.
+static unsigned long long hash_word (unsigned long long hash, unsigned long long word)
+{
+	hash ^= word;
+	hash *= 0x100000001B3ULL;
+	hash ^= hash >> 29;
+
+	return (hash);
+}
+
+
+// Mix a double into a hash value, using its bits.
+static unsigned long long hash_double (unsigned long long hash, double value)
+{
+	unsigned long long	word;
+
+	memcpy (&word, &value, sizeof (double));
+
+	return (hash_word (hash, word));
+}
+
+
+// Compute a hash of the vertex coordinates and the faces
+//  of an object, to identify the data in the caches.
+// The ids of the vertices and faces are not used, since
+//  they are changed while processing the object.
+unsigned long long object_content_hash (objectStruct object_data)
+{
+	unsigned long long	hash = 0xCBF29CE484222325ULL;
+	facePtr				face = NULL;
+	int					i;
+
+	hash = hash_word (hash, object_data.numVertices);
+	hash = hash_word (hash, object_data.numFaces);
+
+	for (i=1; i<=object_data.numVertices; i++)
+	{
+		hash = hash_double (hash, object_data.vertexArray[i].x);
+		hash = hash_double (hash, object_data.vertexArray[i].y);
+		hash = hash_double (hash, object_data.vertexArray[i].z);
+	}
+
+	for (i=1; i<=object_data.numFaces; i++)
+	{
+		face = &object_data.faceArray[i];
+		hash = hash_word (hash, ((unsigned long long) (unsigned int) face->faceVertices << 32) | (unsigned int) face->vertex[0]);
+		hash = hash_word (hash, ((unsigned long long) (unsigned int) face->vertex[1] << 32) | (unsigned int) face->vertex[2]);
+		hash = hash_word (hash, (unsigned int) face->vertex[3]);
+	}
+
+	return (hash);
+}
+
+
+// Write the per vertex results of the Gauss map,
+//  and the global totals, into a cache file.
+// The data is written to a temporary file, which is renamed
+//  at the end, so that a partial file is never read.
+boolean write_gauss_map_cache (char* filename, unsigned long long hash, vertexDataStruct* vertex_data_array, int num_vertices, gaussMapTotalsStruct totals)
+{
+	FILE*					GMC_FD = NULL;
+	char*					temp_name = NULL;
+	gaussMapCacheHeader		header;
+	vertexDataStruct*		vertex_data = NULL;
+	double					values[5];
+	int						flags[3];
+	int						i;
+	boolean					success;
+
+	temp_name = mesh_cache_name (filename, ".tmp");
+	GMC_FD = fopen (temp_name, "wb");
+	if (GMC_FD == NULL)
+	{
+		free (temp_name);
+		return (FALSE);
+	}
+	setvbuf (GMC_FD, NULL, _IOFBF, 1 << 20);
+
+	memset (&header, 0, sizeof (gaussMapCacheHeader));
+	memcpy (header.magic, GAUSS_MAP_CACHE_MAGIC, 4);
+	header.version = GAUSS_MAP_CACHE_VERSION;
+	header.byte_order = GAUSS_MAP_CACHE_BYTE_ORDER;
+	header.num_vertices = num_vertices;
+	header.precision = sizeof (real);
+	header.hash = hash;
+	header.totals = totals;
+
+	fwrite (&header, sizeof (gaussMapCacheHeader), 1, GMC_FD);
+
+	for (i=1; i<=num_vertices; i++)
+	{
+		vertex_data = &vertex_data_array[i];
+		values[0] = vertex_data->curvature;
+		values[1] = vertex_data->angle_deficit;
+		values[2] = vertex_data->artificial_normal.i;
+		values[3] = vertex_data->artificial_normal.j;
+		values[4] = vertex_data->artificial_normal.k;
+		fwrite (values, sizeof (double), 5, GMC_FD);
+	}
+
+	for (i=1; i<=num_vertices; i++)
+	{
+		vertex_data = &vertex_data_array[i];
+		flags[0] = vertex_data->type;
+		flags[1] = vertex_data->border_vertex;
+		flags[2] = vertex_data->num_polygons;
+		fwrite (flags, sizeof (int), 3, GMC_FD);
+	}
+
+	success = !ferror (GMC_FD);
+	success = (fclose (GMC_FD) == 0) && success;
+
+	if (success)
+		success = (rename (temp_name, filename) == 0);
+	if (!success)
+		remove (temp_name);
+
+	free (temp_name);
+
+	return (success);
+}
+
+
+// Read the results of the Gauss map from a cache file.
+// Only the values stored are changed in the vertex data
+//  structures, the lists of spherical polygons are not.
+boolean read_gauss_map_cache (char* filename, unsigned long long hash, vertexDataStruct* vertex_data_array, int num_vertices, gaussMapTotalsPtr totals)
+{
+	char*					data = NULL;
+	size_t					length;
+	gaussMapCacheHeader		header;
+	vertexDataStruct*		vertex_data = NULL;
+	double*					values = NULL;
+	int*					flags = NULL;
+	FILE*					GMC_FD = NULL;
+	int						i;
+
+	// Check that the file exists, before mapping it.
+	GMC_FD = fopen (filename, "rb");
+	if (GMC_FD == NULL)
+		return (FALSE);
+	fclose (GMC_FD);
+
+	data = xmapfile (filename, &length);
+
+	if (length != sizeof (gaussMapCacheHeader) + (sizeof (double) * 5 + sizeof (int) * 3) * (size_t) num_vertices)
+	{
+		xunmapfile (data, length);
+		return (FALSE);
+	}
+
+	memcpy (&header, data, sizeof (gaussMapCacheHeader));
+
+	if ( memcmp (header.magic, GAUSS_MAP_CACHE_MAGIC, 4) || (header.version != GAUSS_MAP_CACHE_VERSION) ||
+		 (header.byte_order != GAUSS_MAP_CACHE_BYTE_ORDER) || (header.num_vertices != num_vertices) ||
+		 (header.precision != sizeof (real)) || (header.hash != hash) )
+	{
+		xunmapfile (data, length);
+		return (FALSE);
+	}
+
+	values = (double*) (data + sizeof (gaussMapCacheHeader));
+	flags = (int*) (values + 5 * num_vertices);
+
+	for (i=1; i<=num_vertices; i++)
+	{
+		vertex_data = &vertex_data_array[i];
+		vertex_data->curvature = values[5*(i-1)];
+		vertex_data->angle_deficit = values[5*(i-1) + 1];
+		vertex_data->artificial_normal.vectorId = 0;
+		vertex_data->artificial_normal.i = values[5*(i-1) + 2];
+		vertex_data->artificial_normal.j = values[5*(i-1) + 3];
+		vertex_data->artificial_normal.k = values[5*(i-1) + 4];
+		vertex_data->artificial_normal.type = NORMAL;
+		vertex_data->artificial_normal.num_intersections = 0;
+		vertex_data->type = (vertexType) flags[3*(i-1)];
+		vertex_data->border_vertex = (boolean) flags[3*(i-1) + 1];
+		vertex_data->num_polygons = flags[3*(i-1) + 2];
+	}
+
+	*totals = header.totals;
+
+	xunmapfile (data, length);
+
+	return (TRUE);
+}
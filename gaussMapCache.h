@@ -0,0 +1,26 @@
+// Global results of the Gauss map computation.
+typedef struct gaussMapTotalsStruct
+{
+	double		total_area;
+	double		positive_area;
+	double		negative_area;
+	double		gaussian_curvature;
+	double		max_tac;
+} gaussMapTotalsStruct;
+
+typedef gaussMapTotalsStruct* gaussMapTotalsPtr;
+
+
+// Compute a hash of the vertex coordinates and the faces
+//  of an object, to identify the data in the caches.
+unsigned long long object_content_hash (objectStruct object_data);
+
+// Write the per vertex results of the Gauss map,
+//  and the global totals, into a cache file.
+// Returns FALSE if the file could not be written.
+boolean write_gauss_map_cache (char* filename, unsigned long long hash, vertexDataStruct* vertex_data_array, int num_vertices, gaussMapTotalsStruct totals);
+
+// Read the results of the Gauss map from a cache file.
+// Returns FALSE if the file does not exist, or was
+//  created for a different object.
+boolean read_gauss_map_cache (char* filename, unsigned long long hash, vertexDataStruct* vertex_data_array, int num_vertices, gaussMapTotalsPtr totals);
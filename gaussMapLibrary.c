@@ -0,0 +1,270 @@
+#include <pthread.h>
+
+#include "gaussMap.h"
+#include "meshWriter.h"
+#include "offWriter.h"
+#include "decimator.h"
+#include "gaussMapLibrary.h"
+
+// Data of a mesh handled by the library.
+// The functions of the Gauss map and of the decimation work on
+//  their global variables, so the state of the mesh is moved
+//  into them for the duration of each call, and back out after.
+struct gaussMapMeshStruct
+{
+	gaussMapStateStruct		gauss_map;
+	decimatorStateStruct	decimator;
+	boolean					use_caches;
+	boolean					loaded;
+	boolean					computed;
+	boolean					decimating;
+};
+
+// External variables
+extern objectStruct				ObjectData;
+extern vertexDataStruct*		VertexDataArray;
+extern double					TotalGaussMapArea;
+extern double					PositiveGaussMapArea;
+extern double					NegativeGaussMapArea;
+extern double					GaussianCurvature;
+extern __thread arenaStruct		VertexArena;
+
+// Only one mesh can be in the global variables at a time,
+//  so every call of the library holds this lock.
+static pthread_mutex_t		Global_state_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+// Check that a file can be created, since the writers
+//  stop the program when they can not open it.
+static boolean can_create_file (char* filename)
+{
+	FILE*	file = fopen (filename, "w");
+
+	if (file == NULL)
+		return (FALSE);
+
+	fclose (file);
+
+	return (TRUE);
+}
+
+
+// Make a mesh the one processed by the program.
+static void bind_mesh (gaussMapMeshPtr mesh)
+{
+	pthread_mutex_lock (&Global_state_lock);
+
+	restore_gauss_map_state (&mesh->gauss_map);
+	restore_decimator_state (&mesh->decimator);
+}
+
+
+// Move the data of the mesh processed back into its handle.
+static void release_mesh (gaussMapMeshPtr mesh)
+{
+	save_decimator_state (&mesh->decimator);
+	save_gauss_map_state (&mesh->gauss_map);
+
+	pthread_mutex_unlock (&Global_state_lock);
+}
+
+
+// Create an empty mesh.
+gaussMapMeshPtr gauss_map_mesh_new (void)
+{
+	gaussMapMeshPtr		mesh = NULL;
+
+	mesh = (gaussMapMeshPtr) xmalloc (sizeof (struct gaussMapMeshStruct));
+	memset (mesh, 0, sizeof (struct gaussMapMeshStruct));
+	mesh->decimator.removal_index = 1;
+
+	return (mesh);
+}
+
+
+// Choose whether the meshes read use the caches.
+void gauss_map_mesh_use_caches (gaussMapMeshPtr mesh, int use_caches)
+{
+	mesh->use_caches = (use_caches != FALSE);
+}
+
+
+// Read a mesh from a file, replacing the one in the handle.
+int gauss_map_mesh_load (gaussMapMeshPtr mesh, char* input_file)
+{
+	arenaStruct		arena;
+	boolean			success;
+
+	bind_mesh (mesh);
+
+	// Release the previous mesh, but keep the blocks of
+	//  its arena for the new one.
+	arena = VertexArena;
+	memset (&VertexArena, 0, sizeof (arenaStruct));
+
+	free_decimation ();
+	freeObjectMemory ();
+
+	arena_reset (&arena);
+	VertexArena = arena;
+
+	success = read_object (input_file, mesh->use_caches);
+
+	// The Gauss map of a mesh without faces can not be computed.
+	if ( success && ((ObjectData.numVertices == 0) || (ObjectData.numFaces == 0)) )
+	{
+		printf ("Mesh without faces: '%s'.\n", input_file);
+		success = FALSE;
+	}
+
+	mesh->loaded = success;
+	mesh->computed = FALSE;
+	mesh->decimating = FALSE;
+
+	release_mesh (mesh);
+
+	return (success);
+}
+
+
+// Compute the Gauss map of every vertex of the mesh.
+int gauss_map_mesh_compute (gaussMapMeshPtr mesh)
+{
+	if (!mesh->loaded)
+		return (FALSE);
+
+	// The results stay valid until another mesh is read.
+	if (mesh->computed)
+		return (TRUE);
+
+	bind_mesh (mesh);
+	generateGaussMap ();
+	mesh->computed = TRUE;
+	release_mesh (mesh);
+
+	return (TRUE);
+}
+
+
+// Get the results of the Gauss map for a vertex.
+int gauss_map_mesh_vertex_result (gaussMapMeshPtr mesh, int vertex_index, gaussMapVertexResultPtr result)
+{
+	vertexDataPtr		vertex_data = NULL;
+	boolean				valid = FALSE;
+
+	bind_mesh (mesh);
+
+	if ( mesh->computed && (vertex_index >= 1) && (vertex_index <= ObjectData.numVertices) &&
+			(ObjectData.vertexArray[vertex_index].vertexId > 0) )
+	{
+		vertex_data = &VertexDataArray[vertex_index];
+
+		result->type = vertex_data->type;
+		result->border_vertex = vertex_data->border_vertex;
+		result->curvature = vertex_data->curvature;
+		result->angle_deficit = vertex_data->angle_deficit;
+		result->num_polygons = vertex_data->num_polygons;
+		valid = TRUE;
+	}
+
+	release_mesh (mesh);
+
+	return (valid);
+}
+
+
+// Get the totals of the Gauss map for the whole mesh.
+gaussMapMeshResultStruct gauss_map_mesh_result (gaussMapMeshPtr mesh)
+{
+	gaussMapMeshResultStruct	result;
+
+	bind_mesh (mesh);
+
+	result.num_vertices = ObjectData.numVertices - mesh->decimator.removal_count;
+	result.num_faces = count_valid_faces (ObjectData);
+	result.surface_area = ObjectData.surfaceArea;
+	result.absolute_curvature = TotalGaussMapArea;
+	result.positive_curvature = PositiveGaussMapArea;
+	result.negative_curvature = NegativeGaussMapArea;
+	result.gaussian_curvature = GaussianCurvature;
+
+	release_mesh (mesh);
+
+	return (result);
+}
+
+
+// Remove the vertices of lowest curvature until only a
+//  percentage of the original vertices remain.
+int gauss_map_mesh_decimate (gaussMapMeshPtr mesh, double remaining_percent)
+{
+	if (!mesh->computed)
+		return (-1);
+
+	bind_mesh (mesh);
+
+	if (!mesh->decimating)
+	{
+		start_decimation ();
+		sort_vertices_by_decimation_parameter ();
+		mesh->decimating = TRUE;
+	}
+
+	headless_vertex_decimation (remaining_percent);
+
+	release_mesh (mesh);
+
+	return (mesh->gauss_map.object_data.numVertices - mesh->decimator.removal_count);
+}
+
+
+// Write the mesh into a file, with the format given by the
+//  extension of the name.
+int gauss_map_mesh_export (gaussMapMeshPtr mesh, char* filename)
+{
+	if ( !mesh->loaded || !can_create_file (filename) )
+		return (FALSE);
+
+	bind_mesh (mesh);
+
+	if (has_extension (filename, ".ply"))
+		write_ply_file (ObjectData, filename, TRUE);
+	else if (has_extension (filename, ".off"))
+		write_off_file (ObjectData, filename);
+	else
+		write_obj_file (ObjectData, filename);
+
+	release_mesh (mesh);
+
+	return (TRUE);
+}
+
+
+// Write the mesh into a ply file, with the results
+//  of the Gauss map for each vertex.
+int gauss_map_mesh_export_curvature (gaussMapMeshPtr mesh, char* filename)
+{
+	if ( !mesh->computed || !can_create_file (filename) )
+		return (FALSE);
+
+	bind_mesh (mesh);
+	write_curvature_ply_file (ObjectData, VertexDataArray, filename);
+	release_mesh (mesh);
+
+	return (TRUE);
+}
+
+
+// Release the mesh and all of its memory.
+void gauss_map_mesh_free (gaussMapMeshPtr mesh)
+{
+	if (mesh == NULL)
+		return;
+
+	bind_mesh (mesh);
+	free_decimation ();
+	freeObjectMemory ();
+	release_mesh (mesh);
+
+	free (mesh);
+}
@@ -0,0 +1,118 @@
+// Interface to read meshes, compute their Gauss maps, decimate
+//  and write them from other programs, linking 'libgaussmap.a'.
+// Each mesh is kept in its own handle, so several of them can be
+//  used in the same process.
+// This header does not need any other header of the program.
+// The truth values returned are 0 (FALSE) or 1 (TRUE).
+//
+// The functions of the program work on global variables, which
+//  each call fills with the data of its handle:
+// - All of the calls are serialised by a lock for the whole
+//   process. They can be made from different threads, but only
+//   one of them works at a time, even for different handles.
+// - The functions are not reentrant, and must not be called from
+//   signal handlers.
+// - A single computation of the Gauss map uses several threads,
+//   as many as the environment variable 'GAUSSMAP_THREADS' gives,
+//   or one for each processor.
+// - Messages about the progress and the errors are printed
+//   on stdout.
+// - Errors in the files read or written are returned as FALSE,
+//   but the process is stopped with 'exit' if memory can not be
+//   allocated or a thread can not be created.
+
+// Data structures
+
+// MESH
+// Handle to a mesh, with the results of its Gauss map
+//  and of its decimation.
+typedef struct gaussMapMeshStruct* gaussMapMeshPtr;
+
+// RESULTS OF A VERTEX
+typedef struct gaussMapVertexResultStruct
+{
+	// Value of the 'vertexType' of the vertex (vertices.h):
+	//  0 = FLAT, 1 = ALL_POS, 2 = ALL_NEG, 3 = MIXED,
+	//  4 = ALL_POS_CONCAVE, 5 = MIXED_CONCAVE.
+	int			type;
+	int			border_vertex;
+	double		curvature;
+	double		angle_deficit;
+	// Number of spherical polygons of the Gauss map of the vertex.
+	int			num_polygons;
+} gaussMapVertexResultStruct;
+
+typedef gaussMapVertexResultStruct* gaussMapVertexResultPtr;
+
+// RESULTS OF A MESH
+typedef struct gaussMapMeshResultStruct
+{
+	// Vertices and faces left after the decimation.
+	int			num_vertices;
+	int			num_faces;
+	double		surface_area;
+	double		absolute_curvature;
+	double		positive_curvature;
+	double		negative_curvature;
+	double		gaussian_curvature;
+} gaussMapMeshResultStruct;
+
+typedef gaussMapMeshResultStruct* gaussMapMeshResultPtr;
+
+
+// Function declarations
+
+// Create an empty mesh.
+gaussMapMeshPtr gauss_map_mesh_new (void);
+
+// Choose whether the meshes read into the handle use the caches
+//  of the mesh and of its Gauss map ('.gmb' and '.gmc' files).
+// They are not used unless this is called with TRUE.
+// The caches are kept in the directory given by the variable
+//  'GAUSSMAP_CACHE_DIR', or else next to each mesh file.
+void gauss_map_mesh_use_caches (gaussMapMeshPtr mesh, int use_caches);
+
+// Read a mesh from a file (obj, ply, off or mesh cache,
+//  optionally compressed with gzip), replacing the one
+//  in the handle.
+// The memory used to process the vertices of the previous
+//  mesh is kept for the new one.
+// Returns FALSE if the file can not be read, is not valid or
+//  has no faces, leaving the handle without a mesh.
+int gauss_map_mesh_load (gaussMapMeshPtr mesh, char* input_file);
+
+// Compute the Gauss map of every vertex of the mesh.
+// Returns FALSE if no mesh has been read.
+int gauss_map_mesh_compute (gaussMapMeshPtr mesh);
+
+// Get the results of the Gauss map for a vertex, with
+//  indices beginning with 1.
+// Returns FALSE if the Gauss map has not been computed, or the
+//  vertex does not exist or was removed by the decimation.
+int gauss_map_mesh_vertex_result (gaussMapMeshPtr mesh, int vertex_index, gaussMapVertexResultPtr result);
+
+// Get the totals of the Gauss map for the whole mesh.
+// The curvatures are 0 until the Gauss map is computed.
+gaussMapMeshResultStruct gauss_map_mesh_result (gaussMapMeshPtr mesh);
+
+// Remove the vertices of lowest curvature until only a
+//  percentage of the original vertices remain.
+// Can be called again with a lower percentage.
+// Returns the number of vertices left, or -1 if the Gauss map
+//  has not been computed.
+int gauss_map_mesh_decimate (gaussMapMeshPtr mesh, double remaining_percent);
+
+// Write the mesh into a file, with the format given by the
+//  extension of the name (obj, ply or off).
+// Returns FALSE if no mesh has been read, or the file
+//  can not be created.
+int gauss_map_mesh_export (gaussMapMeshPtr mesh, char* filename);
+
+// Write the mesh into a ply file, with the curvature, angle
+//  deficit, type and border flag of each vertex.
+// Returns FALSE if the Gauss map has not been computed, or
+//  the file can not be created.
+int gauss_map_mesh_export_curvature (gaussMapMeshPtr mesh, char* filename);
+
+// Release the mesh and all of its memory.
+void gauss_map_mesh_free (gaussMapMeshPtr mesh);
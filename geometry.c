@@ -1,5 +1,6 @@
 #include <math.h>
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 #include "vertices.h"
 #include "geometry.h"
@@ -65,11 +66,22 @@ vectorPtr vectorFromVertices (vertexPtr vertex1, vertexPtr vertex2)
 {
 	vectorPtr	newVector;
 
-	newVector = (vectorPtr) xmalloc (sizeof (vectorStruct));
+	newVector = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
+	*newVector = vector_from_vertices (vertex1, vertex2);
 
-	newVector->i = vertex2->x - vertex1->x;
-	newVector->j = vertex2->y - vertex1->y;
-	newVector->k = vertex2->z - vertex1->z;
+	return (newVector);
+}
+
+
+// Find the components of a vector, enclosed between two vertices.
+// The vector is returned by value, without allocating memory.
+vectorStruct vector_from_vertices (vertexPtr vertex1, vertexPtr vertex2)
+{
+	vectorStruct	newVector = {0, 0.0, 0.0, 0.0, NORMAL, 0};
+
+	newVector.i = vertex2->x - vertex1->x;
+	newVector.j = vertex2->y - vertex1->y;
+	newVector.k = vertex2->z - vertex1->z;
 
 	return (newVector);
 }
@@ -79,19 +91,13 @@ vectorPtr vectorFromVertices (vertexPtr vertex1, vertexPtr vertex2)
 // Returns the angle in radians.
 double angleBetweenVertices (vertexStruct vertex1, vertexStruct vertex2, vertexStruct vertex3)
 {
-	vectorPtr	vector1 = NULL;
-	vectorPtr	vector2 = NULL;
-	double		angle;
+	vectorStruct	vector1;
+	vectorStruct	vector2;
 
-	vector1 = vectorFromVertices (&vertex1, &vertex2);
-	vector2 = vectorFromVertices (&vertex2, &vertex3);
+	vector1 = vector_from_vertices (&vertex1, &vertex2);
+	vector2 = vector_from_vertices (&vertex2, &vertex3);
 
-	angle = angleBetweenVectors (vector1, vector2);
-
-	free (vector1);
-	free (vector2);
-
-	return (angle);
+	return (angleBetweenVectors (&vector1, &vector2));
 }
 
 
@@ -249,7 +255,7 @@ boolean colinearVectors (vectorPtr vector1, vectorPtr vector2)
 // Obtain the dot product of two vectors.
 double dotProduct (vectorPtr vector1, vectorPtr vector2)
 {
-	return ( (vector2->i * vector1->i) + (vector2->j * vector1->j) + (vector2->k * vector1->k) );
+	return ( ((double) vector2->i * vector1->i) + ((double) vector2->j * vector1->j) + ((double) vector2->k * vector1->k) );
 }
 
 
@@ -258,13 +264,24 @@ vectorPtr crossProduct (vectorPtr vector1, vectorPtr vector2)
 {
 	vectorPtr	newVector = NULL;
 
-	newVector = (vectorPtr) xmalloc (sizeof (vectorStruct) );
+	newVector = (vectorPtr) scratch_malloc (sizeof (vectorStruct) );
+	*newVector = cross_product (vector1, vector2);
 
-	newVector->i = vector1->j * vector2->k - vector1->k * vector2->j;
-	newVector->j = vector1->k * vector2->i - vector1->i * vector2->k;
-	newVector->k = vector1->i * vector2->j - vector1->j * vector2->i;
+	return (newVector);
+}
 
-	normalizeVector (newVector);
+
+// Compute the cross product of two vectors.
+// The result is normalized, and returned by value.
+vectorStruct cross_product (vectorPtr vector1, vectorPtr vector2)
+{
+	vectorStruct	newVector = {0, 0.0, 0.0, 0.0, NORMAL, 0};
+
+	newVector.i = (double) vector1->j * vector2->k - (double) vector1->k * vector2->j;
+	newVector.j = (double) vector1->k * vector2->i - (double) vector1->i * vector2->k;
+	newVector.k = (double) vector1->i * vector2->j - (double) vector1->j * vector2->i;
+
+	normalizeVector (&newVector);
 
 	return (newVector);
 }
@@ -275,11 +292,21 @@ vectorPtr sumVectors (vectorPtr vector1, vectorPtr vector2)
 {
 	vectorPtr	newVector = NULL;
 
-	newVector = (vectorPtr) xmalloc (sizeof (vectorStruct) );
+	newVector = (vectorPtr) scratch_malloc (sizeof (vectorStruct) );
+	*newVector = sum_vectors (vector1, vector2);
+
+	return (newVector);
+}
+
+
+// Sum two vectors, returning the result by value.
+vectorStruct sum_vectors (vectorPtr vector1, vectorPtr vector2)
+{
+	vectorStruct	newVector = {0, 0.0, 0.0, 0.0, NORMAL, 0};
 
-	newVector->i = vector1->i + vector2->i;
-	newVector->j = vector1->j + vector2->j;
-	newVector->k = vector1->k + vector2->k;
+	newVector.i = vector1->i + vector2->i;
+	newVector.j = vector1->j + vector2->j;
+	newVector.k = vector1->k + vector2->k;
 
 	return (newVector);
 }
@@ -292,9 +319,9 @@ double vectorLength (vectorPtr vector)
 	double	jSquared;
 	double	kSquared;
 
-	iSquared = vector->i * vector->i;
-	jSquared = vector->j * vector->j;
-	kSquared = vector->k * vector->k;
+	iSquared = (double) vector->i * vector->i;
+	jSquared = (double) vector->j * vector->j;
+	kSquared = (double) vector->k * vector->k;
 
 	return ( sqrtf (iSquared + jSquared + kSquared) );
 }
@@ -344,20 +371,16 @@ spinType orientationFromVertices_2D (vertexStruct vertex1, vertexStruct vertex2,
 //  to the plane is used to determine their orientation.
 spinType orientationFromVertices_3D (vertexStruct vertex1, vertexStruct vertex2, vertexStruct vertex3, vectorStruct normal_vector)
 {
-	double		orientation;
-	vectorPtr	vector1;
-	vectorPtr	vector2;
-	vectorPtr	cross_vector;
-
-	vector1 = vectorFromVertices (&vertex1, &vertex2);
-	vector2 = vectorFromVertices (&vertex2, &vertex3);
+	double			orientation;
+	vectorStruct	vector1;
+	vectorStruct	vector2;
+	vectorStruct	cross_vector;
 
-	cross_vector = crossProduct (vector1, vector2);
-	orientation = dotProduct (cross_vector, &normal_vector);
+	vector1 = vector_from_vertices (&vertex1, &vertex2);
+	vector2 = vector_from_vertices (&vertex2, &vertex3);
 
-	free (vector1);
-	free (vector2);
-	free (cross_vector);
+	cross_vector = cross_product (&vector1, &vector2);
+	orientation = dotProduct (&cross_vector, &normal_vector);
 
 	// Clock Wise
 	if ( orientation > (0 + EPSILON) )
@@ -527,18 +550,18 @@ boolean testSegmentCurveIntersect (vertexPtr vertexArray, nodePtr curve, vertexS
 // Returns the vertexId of the vertex that is farther away.
 int findFarCollinearVertex (vertexStruct vertex1, vertexStruct vertex2, vertexStruct vertex3)
 {
-	vectorPtr	vector1_2 = NULL;
-	vectorPtr	vector1_3 = NULL;
+	vectorStruct	vector1_2;
+	vectorStruct	vector1_3;
 	double		length1_2;
 	double		length1_3;
 	double		cosine;
 	int		farVertex;
 
-	vector1_2 = vectorFromVertices (&vertex1, &vertex2);
-	vector1_3 = vectorFromVertices (&vertex1, &vertex3);
-	length1_2 = vectorLength (vector1_2);
-	length1_3 = vectorLength (vector1_3);
-	cosine = dotProduct (vector1_2, vector1_3) / (length1_2 * length1_3);
+	vector1_2 = vector_from_vertices (&vertex1, &vertex2);
+	vector1_3 = vector_from_vertices (&vertex1, &vertex3);
+	length1_2 = vectorLength (&vector1_2);
+	length1_3 = vectorLength (&vector1_3);
+	cosine = dotProduct (&vector1_2, &vector1_3) / (length1_2 * length1_3);
 
 	// if ( (cosine > 0) && (length1_3 > length1_2) )
 
@@ -554,9 +577,6 @@ int findFarCollinearVertex (vertexStruct vertex1, vertexStruct vertex2, vertexSt
 			farVertex = vertex2.vertexId;
 	}
 
-	free (vector1_2);
-	free (vector1_3);
-
 	return (farVertex);
 }
 
@@ -620,9 +640,9 @@ double distanceVertexToSegment (vertexStruct vertex, vertexStruct segmentVertex1
 	}
 	*/
 
-	free (segmentVector);
-	free (vectorToVertex);
-	free (newVertex);
+	scratch_free (segmentVector);
+	scratch_free (vectorToVertex);
+	scratch_free (newVertex);
 
 	return (result);
 }
@@ -783,7 +803,7 @@ void divideFlatPolygon (vertexPtr vertexArray, nodePtr polygonList, nodePtr* par
 				//  both new polygons.
 				index = (int*) getNodeData (polygonList, closest);
 				vertex4 = vertexArray[*index];
-				tmpIndex = (int*) xmalloc (sizeof (int));
+				tmpIndex = (int*) scratch_malloc (sizeof (int));
 				memcpy (tmpIndex, &vertex4.vertexId, sizeof (int));
 				*part2List = addFrontNode (*part2List, tmpIndex);
 
@@ -799,7 +819,7 @@ void divideFlatPolygon (vertexPtr vertexArray, nodePtr polygonList, nodePtr* par
 
 				// Copy the second of the vertices that will belong
 				//  to both new polygons.
-				tmpIndex = (int*) xmalloc (sizeof (int));
+				tmpIndex = (int*) scratch_malloc (sizeof (int));
 				memcpy (tmpIndex, &vertex2.vertexId, sizeof (int));
 				*part2List = addFrontNode (*part2List, tmpIndex);
 			}
@@ -807,24 +827,24 @@ void divideFlatPolygon (vertexPtr vertexArray, nodePtr polygonList, nodePtr* par
 			{
 				// Copy one of the vertices that will belong to
 				//  both new polygons.
-				tmpIndex = (int*) xmalloc (sizeof (int));
+				tmpIndex = (int*) scratch_malloc (sizeof (int));
 				memcpy (tmpIndex, &vertex1.vertexId, sizeof (int));
 				*part1List = addFrontNode (*part1List, tmpIndex);
 
 				// Copy the second of the vertices that will belong to
 				//  both new polygons.
-				tmpIndex = (int*) xmalloc (sizeof (int));
+				tmpIndex = (int*) scratch_malloc (sizeof (int));
 				memcpy (tmpIndex, &vertex3.vertexId, sizeof (int));
 				*part1List = addFrontNode (*part1List, tmpIndex);
 
-				tmpIndex = (int*) xmalloc (sizeof (int));
+				tmpIndex = (int*) scratch_malloc (sizeof (int));
 				memcpy (tmpIndex, &vertex2.vertexId, sizeof (int));
 				*part1List = addFrontNode (*part1List, tmpIndex);
 
 				*part2List = polygonList;
 				// Remove the one vertex that will belong to the other polygon.
 				index = (int*) removeNode (part2List, i);
-				free (index);
+				scratch_free (index);
 			}
 
 			// Stop the for loop.
@@ -892,13 +912,13 @@ double area3D_Polygon( int num_vertices, vertexPtr vertex_array, vertexStruct no
     for (i=1, j=2, k=0; i<=num_vertices; i++, j++, k++)
         switch (coord) {
         case 1:
-            area += (vertex_array[i].y * (vertex_array[j].z - vertex_array[k].z));
+            area += (vertex_array[i].y * ((double) vertex_array[j].z - vertex_array[k].z));
             continue;
         case 2:
-            area += (vertex_array[i].x * (vertex_array[j].z - vertex_array[k].z));
+            area += (vertex_array[i].x * ((double) vertex_array[j].z - vertex_array[k].z));
             continue;
         case 3:
-            area += (vertex_array[i].x * (vertex_array[j].y - vertex_array[k].y));
+            area += (vertex_array[i].x * ((double) vertex_array[j].y - vertex_array[k].y));
             continue;
         }
 
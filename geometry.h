@@ -2,7 +2,15 @@
 
 #define SHORT_PI        3.1416
 #define PI              3.141592653589793238462643383279502884197169399375105820974944592308
+
+// Tolerance of the comparisons with zero.
+// Vectors stored with single precision have errors of about 1E-7,
+//  so then the tolerance is made larger.
+#ifdef SINGLE_PRECISION
+#define EPSILON         1E-6
+#else
 #define EPSILON         1E-10
+#endif
 
 
 // Type definitions
@@ -27,9 +35,9 @@ typedef segmentStruct* segmentPtr;
 typedef struct vectorStruct
 {
 	int			vectorId;
-	double		i;
-	double		j;
-	double		k;
+	real		i;
+	real		j;
+	real		k;
 	vectorType	type;
 	int			num_intersections;
 } vectorStruct;
@@ -56,6 +64,10 @@ segmentPtr createSegment (int vertex1, int vertex2, int info);
 // Find the components of a vector, enclosed between two vertices.
 vectorPtr vectorFromVertices (vertexPtr vertex1, vertexPtr vertex2);
 
+// Same as 'vectorFromVertices', but returning the vector
+//  by value, without allocating memory.
+vectorStruct vector_from_vertices (vertexPtr vertex1, vertexPtr vertex2);
+
 // Find the angle formed by three vertices, by creating 2 vectors.
 double angleBetweenVertices (vertexStruct vertex1, vertexStruct vertex2, vertexStruct vertex3);
 
@@ -88,9 +100,17 @@ double dotProduct (vectorPtr vector1, vectorPtr vector2);
 // Compute the cross product of two vectors.
 vectorPtr crossProduct (vectorPtr vector1, vectorPtr vector2);
 
+// Same as 'crossProduct', but returning the vector
+//  by value, without allocating memory.
+vectorStruct cross_product (vectorPtr vector1, vectorPtr vector2);
+
 // Sum two vectors.
 vectorPtr sumVectors (vectorPtr vector1, vectorPtr vector2);
 
+// Same as 'sumVectors', but returning the vector
+//  by value, without allocating memory.
+vectorStruct sum_vectors (vectorPtr vector1, vectorPtr vector2);
+
 // Alter the size of a normal vector, to make it equal to 1.
 void normalizeVector (vectorPtr vector);
 
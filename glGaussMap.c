@@ -7,6 +7,8 @@
 #include "geometry.h"
 #include "faces.h"
 #include "object3D.h"
+#include "adjacency.h"
+#include "polygonArray.h"
 #include "sphericalGeometry.h"
 #include "vertexGeometry.h"
 #include "objWriter.h"
@@ -53,10 +55,6 @@ extern int					Begin;
 extern int					End;
 extern nodePtr				ConvexHull;
 
-// For writing decimated files
-extern char*				File_Name;
-extern int					Removal_count;
-
 // 
 extern GLUquadricObj*	quadratic;
 extern GLuint			displayNormals;
@@ -65,9 +63,6 @@ extern GLuint			displayNormals;
 extern int				width, height;
 extern GLuint			font;
 
-// Variable for the triangulation of the polygons
-extern nodePtr			PolygonTriangles;
-
 // Global variables
 GLuint*			listIndex;
 
@@ -136,8 +131,9 @@ extern void gl_event( int event, int data, int xpos,  int ypos );
 // External function to print in OpenGL
 extern void gl_printf( GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha, GLint x, GLint y, GLuint font, const char *format, ... );
 
-// External function for mesh decimation
+// External functions for mesh decimation
 extern void visual_vertex_decimation ();
+extern void write_decimated_files ();
 
 
 
@@ -302,7 +298,7 @@ void gl_draw_normal_names (nodePtr normalList)
 void gl_draw_face_names (int current_vertex, objectStruct objectData)
 {
 	int				i;
-	int*			face_index = NULL;
+	int*			face_indices = NULL;
 	double			n_x, n_y, n_z;
 	char			string[5];
 	faceStruct		face;
@@ -312,10 +308,11 @@ void gl_draw_face_names (int current_vertex, objectStruct objectData)
 	vectorPtr		normal_vector = NULL;
 	GLdouble		gl_rotation_matrix[16];
 
+	face_indices = get_vertex_face_indices (&objectData, current_vertex);
+
 	for (i=0; i<objectData.facesPerVertex[current_vertex]; i++)
 	{
-		face_index = (int*) getNodeData (objectData.vertexFaceArray[current_vertex], i);
-		face = objectData.faceArray[*face_index];
+		face = objectData.faceArray[face_indices[i]];
 		reorderFace (&face, current_vertex);
 
 		vertex1 = objectData.displayVertexArray[ face.vertex[1] ];
@@ -1070,6 +1067,7 @@ void gl_oriented_gauss_map (GLuint list, nodePtr polygonList, spinType* orientat
 	nodePtr		polygonVertices = NULL;
 	nodePtr		leanPolygon = NULL;
 	nodePtr		triangleList = NULL;
+	sphericalContextStruct	spherical_context = {NULL, NULL, NULL};
 	vectorPtr	vertex1 = NULL;
 	vectorPtr	vertex2 = NULL;
 	vectorPtr	vertex3 = NULL;
@@ -1119,15 +1117,15 @@ void gl_oriented_gauss_map (GLuint list, nodePtr polygonList, spinType* orientat
 // printVectorList (leanPolygon);
 
 			// Triangulate the polygon.
-			triangulateSphericalPolygon (leanPolygon, orientations[i]);
-			numTriangles = getListLength (PolygonTriangles);
+			triangulateSphericalPolygon (&spherical_context, leanPolygon, orientations[i]);
+			numTriangles = getListLength (spherical_context.polygon_triangles);
 
 // printf ("Number of triangles in polygon: %d\n", numTriangles);	
 
 			for (j=0; j<numTriangles; j++)
 			{
 				// Get the current triangle.
-				triangleList = (nodePtr) getNodeData (PolygonTriangles, j);
+				triangleList = (nodePtr) getNodeData (spherical_context.polygon_triangles, j);
 
 				// Skip the drawing of the area if there are
 				//  less than 3 sides to the polygon.
@@ -1162,8 +1160,8 @@ glScalef (scale[0], scale[1], scale[2]);
 */
 
 			// Deallocate memory.
-			freeListOfLists (PolygonTriangles);
-			PolygonTriangles = NULL;
+			freeListOfLists (spherical_context.polygon_triangles);
+			spherical_context.polygon_triangles = NULL;
 		}	// if (orientations[i] == direction)
 	}	// for (i=0; i<numPolygons; i++)
 
@@ -1198,17 +1196,16 @@ void gl_setup_clip_plane (int plane, vectorPtr vertex1, vectorPtr vertex2, GLdou
 // Use polygon offset to avoid stitching (artifacts).
 void gl_draw_vertex_star (int vertexIndex)
 {
-	nodePtr			vertexFaceList = NULL;
+	int*			vertexFaces = NULL;
 	faceStruct		face;
 	GLint 			polygon_mode_status[2];
 	GLboolean		light_status;
-	int				listLength;
-	int*			faceIndex;
+	int				numFaces;
 	int				v1, v2, v3, v4;
 	int				i;
 
-	vertexFaceList = ObjectData.vertexFaceArray[vertexIndex];
-	listLength = getListLength (vertexFaceList);
+	vertexFaces = get_vertex_face_indices (&ObjectData, vertexIndex);
+	numFaces = ObjectData.facesPerVertex[vertexIndex];
 
 	// Switch off the lights.
 	gl_no_lighting (&light_status);
@@ -1227,10 +1224,9 @@ void gl_draw_vertex_star (int vertexIndex)
 	else
 		glBegin ( GL_TRIANGLES ) ;
 
-	for (i=0; i<listLength; i++)
+	for (i=0; i<numFaces; i++)
 	{
-		faceIndex = (int*) getNodeData (vertexFaceList, i);
-		face = ObjectData.faceArray[*faceIndex];
+		face = ObjectData.faceArray[vertexFaces[i]];
 		v1 = face.vertex[0];
 		v2 = face.vertex[1];
 		v3 = face.vertex[2];
@@ -1412,28 +1408,10 @@ void gl_scene_event( int event, int data, int xpos, int ypos )
 					break;
 
 				// Write output file.
+				// The writers skip the vertices and faces
+				//  removed by the decimation.
 				case '0':
-					{
-						objectStruct	new_object;
-						char			filename[100];
-
-						new_object = get_decimated_object (ObjectData);
-
-						// OBJ file format.
-						sprintf (filename, "%s-%d.obj", File_Name, Removal_count);
-						write_obj_file (new_object, filename);
-
-						// PLY file format.
-						sprintf (filename, "%s-%d.ply", File_Name, Removal_count);
-						write_ply_file (new_object, filename);
-
-						// OFF file format.
-						// sprintf (filename, "%s-%d.off", File_Name, Removal_count);
-						// write_off_file (new_object, filename);
-
-						free (new_object.vertexArray);
-						free (new_object.faceArray);
-					}
+					write_decimated_files ();
 					break;
 #endif
 
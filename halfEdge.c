@@ -0,0 +1,340 @@
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "object3D.h"
+#include "adjacency.h"
+#include "halfEdge.h"
+
+
+// Create the half edges of all the faces of an object.
+// Each face is taken as a triangle.
+// The twin of a half edge is searched among the faces
+//  around the vertex where it ends.
+halfEdgeMeshStruct build_half_edge_mesh (objectStruct object_data)
+{
+	halfEdgeMeshStruct	mesh;
+	int					num_half_edges = 3 * (object_data.numFaces + 1);
+	int*				face_indices = NULL;
+	int					face_index;
+	int					vertex_1;
+	int					vertex_2;
+	int					half_edge;
+	int					candidate;
+	int					i;
+	int					k;
+
+	mesh.numVertices = object_data.numVertices;
+	mesh.numFaces = object_data.numFaces;
+	mesh.origin = (int*) xmalloc (sizeof (int) * num_half_edges);
+	mesh.twin = (int*) xmalloc (sizeof (int) * num_half_edges);
+	mesh.vertexHalfEdge = (int*) xmalloc (sizeof (int) * (object_data.numVertices + 1));
+
+	for (i=0; i<num_half_edges; i++)
+	{
+		mesh.origin[i] = -1;
+		mesh.twin[i] = -1;
+	}
+	for (i=0; i<=object_data.numVertices; i++)
+		mesh.vertexHalfEdge[i] = -1;
+
+	for (face_index=1; face_index<=object_data.numFaces; face_index++)
+	{
+		if (object_data.faceArray[face_index].faceId < 0)
+			continue;
+
+		for (k=0; k<3; k++)
+		{
+			half_edge = 3 * face_index + k;
+			mesh.origin[half_edge] = object_data.faceArray[face_index].vertex[k];
+			mesh.vertexHalfEdge[mesh.origin[half_edge]] = half_edge;
+		}
+	}
+
+	for (half_edge=3; half_edge<num_half_edges; half_edge++)
+	{
+		if ( (mesh.origin[half_edge] < 0) || (mesh.twin[half_edge] >= 0) )
+			continue;
+
+		vertex_1 = mesh.origin[half_edge];
+		vertex_2 = half_edge_destination (&mesh, half_edge);
+
+		// Look for the half edge that goes back,
+		//  in the faces around its first vertex.
+		face_indices = get_vertex_face_indices (&object_data, vertex_2);
+		for (i=0; i<object_data.facesPerVertex[vertex_2]; i++)
+		{
+			if (face_indices[i] == half_edge_face (half_edge))
+				continue;
+
+			candidate = get_face_half_edge (&mesh, face_indices[i], vertex_2);
+			if ( (candidate >= 0) && (mesh.twin[candidate] < 0) && (half_edge_destination (&mesh, candidate) == vertex_1) )
+			{
+				mesh.twin[half_edge] = candidate;
+				mesh.twin[candidate] = half_edge;
+				break;
+			}
+		}
+	}
+
+	return (mesh);
+}
+
+
+// Release the memory of the arrays of half edges.
+void free_half_edge_mesh (halfEdgeMeshPtr mesh)
+{
+	free (mesh->origin);
+	free (mesh->twin);
+	free (mesh->vertexHalfEdge);
+
+	mesh->origin = NULL;
+	mesh->twin = NULL;
+	mesh->vertexHalfEdge = NULL;
+}
+
+
+// Get the face of a half edge.
+int half_edge_face (int half_edge)
+{
+	return (half_edge / 3);
+}
+
+
+// Get the half edge that follows another one in its face.
+int next_half_edge (int half_edge)
+{
+	return ( (half_edge % 3 == 2) ? half_edge - 2 : half_edge + 1 );
+}
+
+
+// Get the half edge that precedes another one in its face.
+int previous_half_edge (int half_edge)
+{
+	return ( (half_edge % 3 == 0) ? half_edge + 2 : half_edge - 1 );
+}
+
+
+// Get the vertex where a half edge ends.
+int half_edge_destination (halfEdgeMeshPtr mesh, int half_edge)
+{
+	return (mesh->origin[next_half_edge (half_edge)]);
+}
+
+
+// Get the next half edge that begins at the same vertex,
+//  turning clockwise, or -1 at a border.
+int next_vertex_half_edge (halfEdgeMeshPtr mesh, int half_edge)
+{
+	return (mesh->twin[previous_half_edge (half_edge)]);
+}
+
+
+// Get the next half edge that begins at the same vertex,
+//  turning counterclockwise, or -1 at a border.
+int previous_vertex_half_edge (halfEdgeMeshPtr mesh, int half_edge)
+{
+	int			twin = mesh->twin[half_edge];
+
+	if (twin < 0)
+		return (-1);
+
+	return (next_half_edge (twin));
+}
+
+
+// Get the half edge of a face that begins at a vertex.
+int get_face_half_edge (halfEdgeMeshPtr mesh, int face_index, int vertex_index)
+{
+	int			k;
+
+	for (k=0; k<3; k++)
+	{
+		if (mesh->origin[3 * face_index + k] == vertex_index)
+			return (3 * face_index + k);
+	}
+
+	return (-1);
+}
+
+
+// Find a half edge going from 'vertex_1' to 'vertex_2'.
+// Turns around 'vertex_1' clockwise, and if a border is
+//  found, turns from the beginning in the other direction.
+// The number of steps is limited, in case the faces around
+//  the vertex do not form a single fan.
+int find_half_edge (halfEdgeMeshPtr mesh, int vertex_1, int vertex_2, int skip_face_1, int skip_face_2)
+{
+	int			start = mesh->vertexHalfEdge[vertex_1];
+	int			half_edge = start;
+	int			face_index;
+	int			steps = 0;
+	boolean		clockwise = TRUE;
+
+	while ( (half_edge >= 0) && (steps++ <= 3 * mesh->numFaces) )
+	{
+		face_index = half_edge_face (half_edge);
+		if ( (face_index != skip_face_1) && (face_index != skip_face_2) && (half_edge_destination (mesh, half_edge) == vertex_2) )
+			return (half_edge);
+
+		if (clockwise)
+		{
+			half_edge = next_vertex_half_edge (mesh, half_edge);
+			if (half_edge == start)
+				break;
+			if (half_edge < 0)
+			{
+				clockwise = FALSE;
+				half_edge = previous_vertex_half_edge (mesh, start);
+			}
+		}
+		else
+			half_edge = previous_vertex_half_edge (mesh, half_edge);
+	}
+
+	return (-1);
+}
+
+
+// Check whether a face is in an array of faces.
+static boolean isUpdatedFace (int face_index, int* face_indices, int num_faces)
+{
+	int			i;
+
+	for (i=0; i<num_faces; i++)
+	{
+		if (face_indices[i] == face_index)
+			return (TRUE);
+	}
+
+	return (FALSE);
+}
+
+
+// Update the half edges of a group of faces, after their
+//  vertices were changed by an edge flip or a half edge
+//  collapse among them.
+// The half edges outside the group that were twins of the
+//  old half edges are kept, and matched again with the new
+//  half edges by their vertices. The new half edges inside
+//  the group are matched among themselves.
+void update_half_edge_faces (halfEdgeMeshPtr mesh, facePtr face_array, int* face_indices, int num_faces)
+{
+	int*		outside = NULL;
+	int*		old_vertices = NULL;
+	int			num_outside = 0;
+	int			num_old_vertices = 0;
+	int			half_edge;
+	int			other;
+	int			twin;
+	int			vertex_index;
+	int			i;
+	int			j;
+	int			k;
+	int			l;
+
+	outside = (int*) xmalloc (sizeof (int) * 6 * num_faces);
+	old_vertices = outside + 3 * num_faces;
+
+	// Keep the twins outside the group, and the old vertices.
+	for (i=0; i<num_faces; i++)
+	{
+		for (k=0; k<3; k++)
+		{
+			half_edge = 3 * face_indices[i] + k;
+			twin = mesh->twin[half_edge];
+
+			if ( (twin >= 0) && !isUpdatedFace (half_edge_face (twin), face_indices, num_faces) )
+				outside[num_outside++] = twin;
+			if (mesh->origin[half_edge] >= 0)
+				old_vertices[num_old_vertices++] = mesh->origin[half_edge];
+
+			mesh->twin[half_edge] = -1;
+		}
+	}
+
+	// Copy the new vertices of the faces.
+	for (i=0; i<num_faces; i++)
+	{
+		for (k=0; k<3; k++)
+		{
+			half_edge = 3 * face_indices[i] + k;
+			if (face_array[face_indices[i]].faceId < 0)
+				mesh->origin[half_edge] = -1;
+			else
+				mesh->origin[half_edge] = face_array[face_indices[i]].vertex[k];
+		}
+	}
+
+	// Match the new half edges.
+	for (i=0; i<num_faces; i++)
+	{
+		for (k=0; k<3; k++)
+		{
+			half_edge = 3 * face_indices[i] + k;
+			if ( (mesh->origin[half_edge] < 0) || (mesh->twin[half_edge] >= 0) )
+				continue;
+
+			vertex_index = half_edge_destination (mesh, half_edge);
+
+			// Look inside the group.
+			for (j=i+1; (j<num_faces) && (mesh->twin[half_edge] < 0); j++)
+			{
+				for (l=0; l<3; l++)
+				{
+					other = 3 * face_indices[j] + l;
+					if (	(mesh->origin[other] == vertex_index) && (mesh->twin[other] < 0) &&
+							(half_edge_destination (mesh, other) == mesh->origin[half_edge]) )
+					{
+						mesh->twin[half_edge] = other;
+						mesh->twin[other] = half_edge;
+						break;
+					}
+				}
+			}
+
+			// Look at the half edges outside.
+			for (j=0; (j<num_outside) && (mesh->twin[half_edge] < 0); j++)
+			{
+				other = outside[j];
+				if (	(other >= 0) && (mesh->origin[other] == vertex_index) &&
+						(half_edge_destination (mesh, other) == mesh->origin[half_edge]) )
+				{
+					mesh->twin[half_edge] = other;
+					mesh->twin[other] = half_edge;
+					outside[j] = -1;
+				}
+			}
+		}
+	}
+
+	// The outside half edges left are now on a border.
+	for (j=0; j<num_outside; j++)
+	{
+		if (outside[j] >= 0)
+			mesh->twin[outside[j]] = -1;
+	}
+
+	// Vertices that were left out of the group lose their
+	//  half edge, if it was in the group.
+	for (j=0; j<num_old_vertices; j++)
+	{
+		vertex_index = old_vertices[j];
+		half_edge = mesh->vertexHalfEdge[vertex_index];
+		if ( (half_edge >= 0) && (mesh->origin[half_edge] != vertex_index) )
+			mesh->vertexHalfEdge[vertex_index] = -1;
+	}
+
+	for (i=0; i<num_faces; i++)
+	{
+		for (k=0; k<3; k++)
+		{
+			half_edge = 3 * face_indices[i] + k;
+			if (mesh->origin[half_edge] >= 0)
+				mesh->vertexHalfEdge[mesh->origin[half_edge]] = half_edge;
+		}
+	}
+
+	free (outside);
+}
@@ -0,0 +1,70 @@
+// Data structures
+
+// HALF EDGES OF A TRIANGLE MESH
+// The half edges of face 'f' are numbered 3*f, 3*f+1 and 3*f+2.
+// Half edge 3*f+k goes from the vertex k of the face to the
+//  next one, so the numbers of the first face begin at 3.
+typedef struct halfEdgeMeshStruct
+{
+	int			numVertices;
+	int			numFaces;
+
+	// Vertex where each half edge begins, or -1
+	//  for the half edges of removed faces.
+	int*		origin;
+	// Half edge in the opposite direction, or -1
+	//  for the half edges on borders.
+	int*		twin;
+	// One of the half edges that begin at each vertex,
+	//  or -1 for vertices without faces.
+	int*		vertexHalfEdge;
+} halfEdgeMeshStruct;
+
+typedef halfEdgeMeshStruct* halfEdgeMeshPtr;
+
+
+// Function declarations
+
+// Create the half edges of all the faces of an object.
+// Uses the faces around each vertex to find the twins.
+halfEdgeMeshStruct build_half_edge_mesh (objectStruct object_data);
+
+// Release the memory of the arrays of half edges.
+void free_half_edge_mesh (halfEdgeMeshPtr mesh);
+
+// Get the face of a half edge.
+int half_edge_face (int half_edge);
+
+// Get the half edges that follow and precede
+//  another one, around the same face.
+int next_half_edge (int half_edge);
+int previous_half_edge (int half_edge);
+
+// Get the vertex where a half edge ends.
+int half_edge_destination (halfEdgeMeshPtr mesh, int half_edge);
+
+// Get the next half edge that begins at the same vertex,
+//  turning clockwise, or -1 at a border.
+int next_vertex_half_edge (halfEdgeMeshPtr mesh, int half_edge);
+
+// Get the next half edge that begins at the same vertex,
+//  turning counterclockwise, or -1 at a border.
+int previous_vertex_half_edge (halfEdgeMeshPtr mesh, int half_edge);
+
+// Get the half edge of a face that begins at a vertex.
+// Returns -1 if the vertex is not in the face.
+int get_face_half_edge (halfEdgeMeshPtr mesh, int face_index, int vertex_index);
+
+// Find a half edge going from 'vertex_1' to 'vertex_2', by
+//  turning around 'vertex_1'.
+// Half edges in the faces 'skip_face_1' and 'skip_face_2'
+//  are not considered.
+// Returns -1 if there is no such half edge.
+int find_half_edge (halfEdgeMeshPtr mesh, int vertex_1, int vertex_2, int skip_face_1, int skip_face_2);
+
+// Update the half edges of a group of faces, after their
+//  vertices were changed by an edge flip or a half edge
+//  collapse among them.
+// The vertices are read from the array of faces, and faces
+//  with a negative faceId are removed.
+void update_half_edge_faces (halfEdgeMeshPtr mesh, facePtr face_array, int* face_indices, int num_faces);
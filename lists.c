@@ -1,4 +1,5 @@
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 
 
@@ -8,7 +9,7 @@ nodePtr addNode (nodePtr list, void* newData)
 {
 	nodePtr		newNode = NULL;
 
-	newNode = (nodePtr) xmalloc (sizeof (node) );
+	newNode = (nodePtr) scratch_malloc (sizeof (node) );
 	newNode->data = newData;
 	newNode->next = NULL;
 
@@ -27,7 +28,7 @@ nodePtr addFrontNode (nodePtr list, void* newData)
 {
 	nodePtr		newNode = NULL;
 
-	newNode = (nodePtr) xmalloc (sizeof (node) );
+	newNode = (nodePtr) scratch_malloc (sizeof (node) );
 	newNode->data = newData;
 	newNode->next = list;
 
@@ -54,7 +55,7 @@ void insertDataAfterIndex (nodePtr list, void* newData, int index)
 		counter++;
 	}
 
-	newNode = (nodePtr) xmalloc (sizeof (node) );
+	newNode = (nodePtr) scratch_malloc (sizeof (node) );
 	newNode->data = newData;
 	newNode->next = pointer->next;
 	pointer->next = newNode;
@@ -114,7 +115,7 @@ void* removeNode (nodePtr* list, int itemPosition)
 
 	deleted->next = NULL;
 	item = deleted->data;
-	free (deleted);
+	scratch_free (deleted);
 
 	return (item);
 }
@@ -140,7 +141,7 @@ void* copyNode (void* node, size_t dataSize)
 {
 	void*		newData = NULL;
 
-	newData = xmalloc (dataSize);
+	newData = scratch_malloc (dataSize);
 	memcpy (newData, node, dataSize);
 
 	return (newData);
@@ -154,14 +155,11 @@ nodePtr copyList (nodePtr list, size_t dataSize)
 	nodePtr		pointer = list;
 	nodePtr		newList = NULL;
 	nodePtr		listTail = NULL;
-	void*		item = NULL;
 	void*		newItem = NULL;
-	int			counter = 0;
 
 	while (pointer != NULL)
 	{
-		item = getNodeData (list, counter);
-		newItem = copyNode (item, dataSize);
+		newItem = copyNode (pointer->data, dataSize);
 		listTail = addNode (listTail, newItem);
 
 		// Initialize the head of the list.
@@ -169,7 +167,29 @@ nodePtr copyList (nodePtr list, size_t dataSize)
 			newList = listTail;
 
 		pointer = pointer->next;
-		counter++;
+	}
+
+	return (newList);
+}
+
+
+// Copy a list containing lists as its data.
+// The data of the inner lists is copied too.
+nodePtr copyListOfLists (nodePtr mainList, size_t dataSize)
+{
+	nodePtr		pointer = mainList;
+	nodePtr		newList = NULL;
+	nodePtr		listTail = NULL;
+
+	while (pointer != NULL)
+	{
+		listTail = addNode (listTail, copyList ( (nodePtr) pointer->data, dataSize ));
+
+		// Initialize the head of the list.
+		if (newList == NULL)
+			newList = listTail;
+
+		pointer = pointer->next;
 	}
 
 	return (newList);
@@ -297,7 +317,7 @@ void freeListOfLists (nodePtr mainList)
 	{
 		nextNode = pointer->next;
 		freeList ( (nodePtr) pointer->data);
-		free (pointer);
+		scratch_free (pointer);
 		pointer = nextNode;
 	}
 
@@ -315,8 +335,8 @@ void freeList (nodePtr list)
 	while (pointer != NULL)
 	{
 		nextNode = pointer->next;
-		free (pointer->data);
-		free (pointer);
+		scratch_free (pointer->data);
+		scratch_free (pointer);
 		pointer = nextNode;
 	}
 }
@@ -18,6 +18,7 @@ void* removeNode (nodePtr* list, int itemPosition);
 void* getNodeData (nodePtr list, int itemPosition);
 void* copyNode (void* node, size_t dataSize);
 nodePtr copyList (nodePtr list, size_t dataSize);
+nodePtr copyListOfLists (nodePtr mainList, size_t dataSize);
 nodePtr invertList (nodePtr list, size_t dataSize);
 void joinLists (nodePtr* head, nodePtr tail);
 nodePtr getListTail (nodePtr list);
@@ -0,0 +1,419 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "object3D.h"
+#include "adjacency.h"
+#include "meshCache.h"
+
+// Identification of the '.gmb' files.
+// The version must be changed whenever the layout
+//  of the file, or the way the data is computed, changes.
+#define MESH_CACHE_MAGIC		"GMB"
+#define MESH_CACHE_VERSION		3
+#define MESH_CACHE_BYTE_ORDER	0x01020304
+
+// Header at the beginning of the '.gmb' file.
+// It is followed by these arrays, all of them for
+//  indices beginning with 1:
+//	double	vertices [numVertices][3]
+//	double	vertex_normals [numVertices][3]
+//	double	face_normals [numFaces][3]
+//	int		faces [numFaces][5]		(faceVertices, vertex[4])
+//	int		faces_per_vertex [numVertices]
+//	int		adjacency_offsets [numVertices+1]
+//	int		adjacency [numAdjacencies]
+// The faces of vertex 'i' are at positions adjacency_offsets[i-1]
+//  to adjacency_offsets[i]-1 of the adjacency array, already in
+//  CCW order around the vertex.
+// The size and modification time of the file the cache was
+//  created from are kept, to know when it has changed.
+typedef struct
+{
+	char		magic[4];
+	int			version;
+	int			byte_order;
+	int			numVertices;
+	int			numFaces;
+	int			numAdjacencies;
+	double		surfaceArea;
+	int			precision;		// Size of the type 'real' that wrote the file.
+	int			reserved;
+	long long	source_size;
+	long long	source_seconds;
+	long long	source_nanoseconds;
+} meshCacheHeader;
+
+
+// Check whether caches should be used.
+// They are used only when the variable 'GAUSSMAP_CACHE_DIR'
+//  is set, or when 'GAUSSMAP_CACHE' is set to anything but 0.
+boolean mesh_cache_enabled (void)
+{
+	char*	variable = getenv ("GAUSSMAP_CACHE_DIR");
+
+	if ( (variable != NULL) && (variable[0] != '\0') )
+		return (TRUE);
+
+	variable = getenv ("GAUSSMAP_CACHE");
+	if ( (variable != NULL) && (variable[0] != '\0') && strcmp (variable, "0") )
+		return (TRUE);
+
+	return (FALSE);
+}
+
+
+// Get the name of a file by adding an extension
+//  to the full name, such as 'venus.obj.gmb'.
+char* mesh_cache_name (char* filename, char* extension)
+{
+	char*	cache_name = NULL;
+
+	cache_name = (char*) xmalloc (strlen (filename) + strlen (extension) + 1);
+	sprintf (cache_name, "%s%s", filename, extension);
+
+	return (cache_name);
+}
+
+
+// Get the name of the cache file for a mesh file.
+// Without a cache directory, the cache is kept next to the
+//  mesh file, such as 'venus.obj.gmb'.
+// In the cache directory, the name is the full path of the
+//  mesh file with its '/' changed to '%',
+//  such as 'DIR/%home%user%venus.obj.gmb'.
+char* mesh_cache_file (char* filename, char* extension)
+{
+	char*	directory = getenv ("GAUSSMAP_CACHE_DIR");
+	char*	full_path = NULL;
+	char*	cache_name = NULL;
+	char*	character = NULL;
+
+	if ( (directory == NULL) || (directory[0] == '\0') )
+		return (mesh_cache_name (filename, extension));
+
+	full_path = realpath (filename, NULL);
+	if (full_path == NULL)
+	{
+		full_path = (char*) xmalloc (strlen (filename) + 1);
+		strcpy (full_path, filename);
+	}
+
+	for (character=full_path; *character!='\0'; character++)
+		if (*character == '/')
+			*character = '%';
+
+	cache_name = (char*) xmalloc (strlen (directory) + strlen (full_path) + strlen (extension) + 2);
+	sprintf (cache_name, "%s/%s%s", directory, full_path, extension);
+
+	free (full_path);
+
+	return (cache_name);
+}
+
+
+// Check whether a cache file exists and was created from
+//  the current contents of a file.
+// The size and the modification time of the file, with its
+//  nanoseconds, must be the same as when the cache was written.
+boolean mesh_cache_is_current (char* cache_file, char* source_file)
+{
+	FILE*				GMB_FD = NULL;
+	meshCacheHeader		header;
+	struct stat			source_status;
+	boolean				current;
+
+	if (stat (source_file, &source_status) < 0)
+		return (FALSE);
+
+	GMB_FD = fopen (cache_file, "rb");
+	if (GMB_FD == NULL)
+		return (FALSE);
+	current = (fread (&header, sizeof (meshCacheHeader), 1, GMB_FD) == 1);
+	fclose (GMB_FD);
+
+	return ( current && !memcmp (header.magic, MESH_CACHE_MAGIC, 4) &&
+			(header.version == MESH_CACHE_VERSION) &&
+			(header.source_size == (long long) source_status.st_size) &&
+			(header.source_seconds == (long long) source_status.st_mtim.tv_sec) &&
+			(header.source_nanoseconds == (long long) source_status.st_mtim.tv_nsec) );
+}
+
+
+// Write the arrays of an objectStruct into a binary
+//  '.gmb' mesh cache file, created from 'source_file'.
+// The data is written to a temporary file, which is renamed
+//  at the end, so that a partial file is never read.
+boolean write_mesh_cache (objectStruct object_data, char* filename, char* source_file)
+{
+	FILE*				GMB_FD = NULL;
+	char*				temp_name = NULL;
+	meshCacheHeader		header;
+	double				values[3];
+	int					face_values[5];
+	int					offset = 0;
+	int					i;
+	boolean				success;
+	struct stat			source_status;
+
+	if (stat (source_file, &source_status) < 0)
+		return (FALSE);
+
+	temp_name = mesh_cache_name (filename, ".tmp");
+	GMB_FD = fopen (temp_name, "wb");
+	if (GMB_FD == NULL)
+	{
+		free (temp_name);
+		return (FALSE);
+	}
+	setvbuf (GMB_FD, NULL, _IOFBF, 1 << 20);
+
+	memset (&header, 0, sizeof (meshCacheHeader));
+	memcpy (header.magic, MESH_CACHE_MAGIC, 4);
+	header.version = MESH_CACHE_VERSION;
+	header.byte_order = MESH_CACHE_BYTE_ORDER;
+	header.precision = sizeof (real);
+	header.numVertices = object_data.numVertices;
+	header.numFaces = object_data.numFaces;
+	header.surfaceArea = object_data.surfaceArea;
+	header.source_size = (long long) source_status.st_size;
+	header.source_seconds = (long long) source_status.st_mtim.tv_sec;
+	header.source_nanoseconds = (long long) source_status.st_mtim.tv_nsec;
+	for (i=1; i<=object_data.numVertices; i++)
+		header.numAdjacencies += object_data.facesPerVertex[i];
+
+	fwrite (&header, sizeof (meshCacheHeader), 1, GMB_FD);
+
+	for (i=1; i<=object_data.numVertices; i++)
+	{
+		values[0] = object_data.vertexArray[i].x;
+		values[1] = object_data.vertexArray[i].y;
+		values[2] = object_data.vertexArray[i].z;
+		fwrite (values, sizeof (double), 3, GMB_FD);
+	}
+
+	for (i=1; i<=object_data.numVertices; i++)
+	{
+		values[0] = object_data.normalArray[i].x;
+		values[1] = object_data.normalArray[i].y;
+		values[2] = object_data.normalArray[i].z;
+		fwrite (values, sizeof (double), 3, GMB_FD);
+	}
+
+	for (i=1; i<=object_data.numFaces; i++)
+	{
+		values[0] = object_data.faceArray[i].faceNormal->i;
+		values[1] = object_data.faceArray[i].faceNormal->j;
+		values[2] = object_data.faceArray[i].faceNormal->k;
+		fwrite (values, sizeof (double), 3, GMB_FD);
+	}
+
+	for (i=1; i<=object_data.numFaces; i++)
+	{
+		face_values[0] = object_data.faceArray[i].faceVertices;
+		memcpy (&face_values[1], object_data.faceArray[i].vertex, sizeof (int) * 4);
+		fwrite (face_values, sizeof (int), 5, GMB_FD);
+	}
+
+	fwrite (&object_data.facesPerVertex[1], sizeof (int), object_data.numVertices, GMB_FD);
+
+	fwrite (&offset, sizeof (int), 1, GMB_FD);
+	for (i=1; i<=object_data.numVertices; i++)
+	{
+		offset += object_data.facesPerVertex[i];
+		fwrite (&offset, sizeof (int), 1, GMB_FD);
+	}
+
+	for (i=1; i<=object_data.numVertices; i++)
+		fwrite (get_vertex_face_indices (&object_data, i), sizeof (int), object_data.facesPerVertex[i], GMB_FD);
+
+	success = !ferror (GMB_FD);
+	success = (fclose (GMB_FD) == 0) && success;
+
+	if (success)
+		success = (rename (temp_name, filename) == 0);
+	if (!success)
+		remove (temp_name);
+
+	free (temp_name);
+
+	return (success);
+}
+
+
+// Check that the indices read from a '.gmb' file are within
+//  the arrays, so that a damaged file is not used.
+// The faces must have 3 or 4 vertices of the object, and the
+//  faces around each vertex must be faces of the object, at the
+//  positions given by the offsets and the number of faces.
+static boolean mesh_cache_indices_are_valid (int* faces, int* faces_per_vertex, int* offsets, int* adjacency,
+												int numVertices, int numFaces, int numAdjacencies)
+{
+	int		i, j;
+
+	for (i=0; i<numFaces; i++)
+	{
+		if ( (faces[5*i] != 3) && (faces[5*i] != 4) )
+			return (FALSE);
+		for (j=1; j<=faces[5*i]; j++)
+			if ( (faces[5*i + j] < 1) || (faces[5*i + j] > numVertices) )
+				return (FALSE);
+	}
+
+	if ( (offsets[0] != 0) || (offsets[numVertices] != numAdjacencies) )
+		return (FALSE);
+
+	for (i=0; i<numVertices; i++)
+		if ( (faces_per_vertex[i] < 0) || (offsets[i+1] - offsets[i] != faces_per_vertex[i]) )
+			return (FALSE);
+
+	for (i=0; i<numAdjacencies; i++)
+		if ( (adjacency[i] < 1) || (adjacency[i] > numFaces) )
+			return (FALSE);
+
+	return (TRUE);
+}
+
+
+// Load an objectStruct from a binary '.gmb' mesh cache file.
+// The file is mapped into memory, and the arrays are copied
+//  directly into the structures used by the program.
+boolean read_mesh_cache (char* filename, objectPtr object_data)
+{
+	int					fileDescriptor;
+	struct stat			fileStatus;
+	char*				data = NULL;
+	meshCacheHeader		header;
+	double*				vertices = NULL;
+	double*				vertex_normals = NULL;
+	double*				face_normals = NULL;
+	int*				faces = NULL;
+	int*				faces_per_vertex = NULL;
+	int*				offsets = NULL;
+	int*				adjacency = NULL;
+	size_t				length;
+	size_t				expected;
+	int					numVertices;
+	int					numFaces;
+	int					i;
+	vectorPtr			normal = NULL;
+
+	fileDescriptor = open (filename, O_RDONLY);
+	if (fileDescriptor < 0)
+		return (FALSE);
+	if ( (fstat (fileDescriptor, &fileStatus) < 0) || (fileStatus.st_size < (off_t) sizeof (meshCacheHeader)) )
+	{
+		close (fileDescriptor);
+		return (FALSE);
+	}
+
+	length = (size_t) fileStatus.st_size;
+	data = (char*) mmap (NULL, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close (fileDescriptor);
+	if (data == MAP_FAILED)
+		return (FALSE);
+
+	memcpy (&header, data, sizeof (meshCacheHeader));
+
+	numVertices = header.numVertices;
+	numFaces = header.numFaces;
+	expected = sizeof (meshCacheHeader)
+				+ sizeof (double) * 3 * ((size_t) numVertices * 2 + numFaces)
+				+ sizeof (int) * 5 * (size_t) numFaces
+				+ sizeof (int) * ((size_t) numVertices * 2 + 1)
+				+ sizeof (int) * (size_t) header.numAdjacencies;
+
+	if ( memcmp (header.magic, MESH_CACHE_MAGIC, 4) || (header.version != MESH_CACHE_VERSION) ||
+		 (header.byte_order != MESH_CACHE_BYTE_ORDER) || (header.precision != sizeof (real)) ||
+		 (numVertices < 0) || (numFaces < 0) ||
+		 (header.numAdjacencies < 0) || (length != expected) )
+	{
+		munmap (data, length);
+		return (FALSE);
+	}
+
+	vertices = (double*) (data + sizeof (meshCacheHeader));
+	vertex_normals = vertices + 3 * numVertices;
+	face_normals = vertex_normals + 3 * numVertices;
+	faces = (int*) (face_normals + 3 * numFaces);
+	faces_per_vertex = faces + 5 * numFaces;
+	offsets = faces_per_vertex + numVertices;
+	adjacency = offsets + numVertices + 1;
+
+	if (!mesh_cache_indices_are_valid (faces, faces_per_vertex, offsets, adjacency, numVertices, numFaces, header.numAdjacencies))
+	{
+		munmap (data, length);
+		return (FALSE);
+	}
+
+	object_data->numVertices = numVertices;
+	object_data->numFaces = numFaces;
+	object_data->numNormals = 0;
+	object_data->numEdges = 0;
+	object_data->displayVertexArray = NULL;
+	object_data->edgeList = NULL;
+	object_data->surfaceArea = header.surfaceArea;
+
+	// The arrays have an empty element at index 0.
+	object_data->vertexArray = (vertexPtr) xmalloc (sizeof (vertexStruct) * (numVertices + 1));
+	object_data->normalArray = (vertexPtr) xmalloc (sizeof (vertexStruct) * (numVertices + 1));
+	object_data->faceArray = (facePtr) xmalloc (sizeof (faceStruct) * (numFaces + 1));
+	object_data->facesPerVertex = (int*) xmalloc (sizeof (int) * (numVertices + 1));
+	object_data->vertexFaceOffsets = (int*) xmalloc (sizeof (int) * (numVertices + 2));
+	object_data->vertexFaceIndices = (int*) xmalloc (sizeof (int) * (header.numAdjacencies + 1));
+	object_data->vertexFaceLength = header.numAdjacencies;
+	object_data->vertexFaceCapacity = header.numAdjacencies + 1;
+	object_data->vertexFaceArray = NULL;
+
+	memset (&object_data->vertexArray[0], 0, sizeof (vertexStruct));
+	memset (&object_data->normalArray[0], 0, sizeof (vertexStruct));
+	memset (&object_data->faceArray[0], 0, sizeof (faceStruct));
+	object_data->facesPerVertex[0] = 0;
+	memcpy (&object_data->facesPerVertex[1], faces_per_vertex, sizeof (int) * numVertices);
+
+	// The faces around each vertex are copied as they are.
+	object_data->vertexFaceOffsets[0] = 0;
+	memcpy (&object_data->vertexFaceOffsets[1], offsets, sizeof (int) * (numVertices + 1));
+	memcpy (object_data->vertexFaceIndices, adjacency, sizeof (int) * header.numAdjacencies);
+
+	for (i=1; i<=numVertices; i++)
+	{
+		object_data->vertexArray[i].vertexId = i;
+		object_data->vertexArray[i].x = vertices[3*(i-1)];
+		object_data->vertexArray[i].y = vertices[3*(i-1) + 1];
+		object_data->vertexArray[i].z = vertices[3*(i-1) + 2];
+		object_data->vertexArray[i].extra = 0;
+
+		object_data->normalArray[i].vertexId = i;
+		object_data->normalArray[i].x = vertex_normals[3*(i-1)];
+		object_data->normalArray[i].y = vertex_normals[3*(i-1) + 1];
+		object_data->normalArray[i].z = vertex_normals[3*(i-1) + 2];
+		object_data->normalArray[i].extra = 0;
+	}
+
+	for (i=1; i<=numFaces; i++)
+	{
+		object_data->faceArray[i].faceId = i;
+		object_data->faceArray[i].faceVertices = faces[5*(i-1)];
+		memcpy (object_data->faceArray[i].vertex, &faces[5*(i-1) + 1], sizeof (int) * 4);
+
+		normal = (vectorPtr) xmalloc (sizeof (vectorStruct));
+		normal->vectorId = i;
+		normal->i = face_normals[3*(i-1)];
+		normal->j = face_normals[3*(i-1) + 1];
+		normal->k = face_normals[3*(i-1) + 2];
+		normal->type = NORMAL;
+		normal->num_intersections = 0;
+		object_data->faceArray[i].faceNormal = normal;
+	}
+
+	munmap (data, length);
+
+	return (TRUE);
+}
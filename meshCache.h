@@ -0,0 +1,30 @@
+// Check whether caches should be used.
+// They are not used unless the environment variable
+//  'GAUSSMAP_CACHE_DIR' names a directory for them, or
+//  'GAUSSMAP_CACHE' is set to 1 to keep them next to the meshes.
+boolean mesh_cache_enabled (void);
+
+// Get the name of a file by adding an extension to another.
+// The string returned must be freed by the caller.
+char* mesh_cache_name (char* filename, char* extension);
+
+// Get the name of the cache file for a mesh file, in the
+//  cache directory or next to the mesh file.
+// The string returned must be freed by the caller.
+char* mesh_cache_file (char* filename, char* extension);
+
+// Check whether a cache file exists and was created from
+//  the current contents of a file, with the same size and
+//  modification time.
+boolean mesh_cache_is_current (char* cache_file, char* source_file);
+
+// Write the arrays of an objectStruct into a binary
+//  '.gmb' mesh cache file, created from 'source_file'.
+// Returns FALSE if the file could not be written.
+boolean write_mesh_cache (objectStruct object_data, char* filename, char* source_file);
+
+// Load an objectStruct from a binary '.gmb' mesh cache file.
+// Returns FALSE if the file does not exist, is not a valid
+//  cache for this version of the program, or has indices
+//  outside of its arrays.
+boolean read_mesh_cache (char* filename, objectPtr object_data);
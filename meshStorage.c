@@ -0,0 +1,717 @@
+#include <math.h>
+#include "tools.h"
+#include "arena.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "meshStorage.h"
+
+// The kernels that work on several faces at a time use the
+//  SSE2 and AVX instructions, when they are available.
+// Compile with '-D NO_SIMD' to use only the plain loops.
+// The kernels work on arrays of doubles, so they are not used
+//  when the coordinates are stored with single precision.
+#if !defined (NO_SIMD) && !defined (SINGLE_PRECISION) && (defined (__x86_64__) || defined (__i386__))
+#define MESH_SIMD
+#include <immintrin.h>
+#endif
+
+
+// Copy the vertices and the normal of a face into the storage.
+static void set_mesh_storage_face (meshStoragePtr storage, int index, facePtr face)
+{
+	storage->triangles[3*index] = face->vertex[0];
+	storage->triangles[3*index + 1] = face->vertex[1];
+	storage->triangles[3*index + 2] = face->vertex[2];
+	storage->fourthVertex[index] = (face->faceVertices == 4) ? face->vertex[3] : -1;
+
+	if (face->faceNormal != NULL)
+	{
+		storage->normalX[index] = face->faceNormal->i;
+		storage->normalY[index] = face->faceNormal->j;
+		storage->normalZ[index] = face->faceNormal->k;
+	}
+}
+
+
+// Allocate the arrays of the storage and copy the vertices.
+static meshStorageStruct allocate_mesh_storage (vertexPtr vertex_array, int num_vertices, int num_faces)
+{
+	meshStorageStruct	storage;
+	int					i;
+
+	storage.numVertices = num_vertices;
+	storage.numFaces = num_faces;
+
+	storage.x = (real*) xmalloc (sizeof (real) * (num_vertices + 1));
+	storage.y = (real*) xmalloc (sizeof (real) * (num_vertices + 1));
+	storage.z = (real*) xmalloc (sizeof (real) * (num_vertices + 1));
+
+	storage.triangles = (int*) xmalloc (sizeof (int) * 3 * (num_faces + 1));
+	storage.fourthVertex = (int*) xmalloc (sizeof (int) * (num_faces + 1));
+	memset (storage.triangles, 0, sizeof (int) * 3 * (num_faces + 1));
+	memset (storage.fourthVertex, -1, sizeof (int) * (num_faces + 1));
+
+	storage.normalX = (real*) xmalloc (sizeof (real) * (num_faces + 1));
+	storage.normalY = (real*) xmalloc (sizeof (real) * (num_faces + 1));
+	storage.normalZ = (real*) xmalloc (sizeof (real) * (num_faces + 1));
+	storage.area = (real*) xmalloc (sizeof (real) * (num_faces + 1));
+	memset (storage.normalX, 0, sizeof (real) * (num_faces + 1));
+	memset (storage.normalY, 0, sizeof (real) * (num_faces + 1));
+	memset (storage.normalZ, 0, sizeof (real) * (num_faces + 1));
+	memset (storage.area, 0, sizeof (real) * (num_faces + 1));
+
+	storage.x[0] = storage.y[0] = storage.z[0] = 0.0;
+	for (i=1; i<=num_vertices; i++)
+	{
+		storage.x[i] = vertex_array[i].x;
+		storage.y[i] = vertex_array[i].y;
+		storage.z[i] = vertex_array[i].z;
+	}
+
+	return (storage);
+}
+
+
+// Create the storage of a mesh, with the same vertices
+//  and faces as the arrays given.
+// The normals already computed for the faces are copied.
+meshStorageStruct new_mesh_storage (vertexPtr vertex_array, int num_vertices, facePtr face_array, int num_faces)
+{
+	meshStorageStruct	storage;
+	int					i;
+
+	storage = allocate_mesh_storage (vertex_array, num_vertices, num_faces);
+
+	for (i=1; i<=num_faces; i++)
+		set_mesh_storage_face (&storage, i, &face_array[i]);
+
+	return (storage);
+}
+
+
+// Create the storage of a mesh with the faces in a list.
+meshStorageStruct new_mesh_storage_from_list (vertexPtr vertex_array, int num_vertices, nodePtr face_list)
+{
+	meshStorageStruct	storage;
+	nodePtr				pointer = NULL;
+	int					i = 1;
+
+	storage = allocate_mesh_storage (vertex_array, num_vertices, getListLength (face_list));
+
+	for (pointer=face_list; pointer!=NULL; pointer=pointer->next)
+		set_mesh_storage_face (&storage, i++, (facePtr) pointer->data);
+
+	return (storage);
+}
+
+
+// Release the memory of the storage.
+void free_mesh_storage (meshStoragePtr storage)
+{
+	free (storage->x);
+	free (storage->y);
+	free (storage->z);
+	free (storage->triangles);
+	free (storage->fourthVertex);
+	free (storage->normalX);
+	free (storage->normalY);
+	free (storage->normalZ);
+	free (storage->area);
+
+	memset (storage, 0, sizeof (meshStorageStruct));
+}
+
+
+// Compute the normal of a single face.
+// The vector is normalized twice, as in 'getTriangleNormal',
+//  so that the results are exactly the same.
+static void face_normal (meshStoragePtr storage, int face)
+{
+	int*			triangle = &storage->triangles[3*face];
+	vectorStruct	vector1;
+	vectorStruct	vector2;
+	vectorStruct	normal;
+
+	vector1.i = storage->x[triangle[1]] - storage->x[triangle[0]];
+	vector1.j = storage->y[triangle[1]] - storage->y[triangle[0]];
+	vector1.k = storage->z[triangle[1]] - storage->z[triangle[0]];
+
+	vector2.i = storage->x[triangle[2]] - storage->x[triangle[1]];
+	vector2.j = storage->y[triangle[2]] - storage->y[triangle[1]];
+	vector2.k = storage->z[triangle[2]] - storage->z[triangle[1]];
+
+	normal = cross_product (&vector1, &vector2);
+	normalizeVector (&normal);
+
+	storage->normalX[face] = normal.i;
+	storage->normalY[face] = normal.j;
+	storage->normalZ[face] = normal.k;
+}
+
+
+// Compute the area of a single face, with its normal.
+static void face_area (meshStoragePtr storage, int face)
+{
+	int*			triangle = &storage->triangles[3*face];
+	vertexStruct	triangle_array[5];
+	vertexStruct	face_normal;
+	int				i;
+
+	for (i=0; i<5; i++)
+	{
+		triangle_array[i].x = storage->x[triangle[i%3]];
+		triangle_array[i].y = storage->y[triangle[i%3]];
+		triangle_array[i].z = storage->z[triangle[i%3]];
+	}
+
+	face_normal.x = storage->normalX[face];
+	face_normal.y = storage->normalY[face];
+	face_normal.z = storage->normalZ[face];
+
+	storage->area[face] = area3D_Polygon (3, triangle_array, face_normal);
+	if (storage->area[face] < 0)
+		storage->area[face] *= -1;
+}
+
+
+// Divide the sum of normals of a vertex by the number of
+//  faces around it, and then make it of unit length.
+static void vertex_normal (vertexPtr normal, double sum_x, double sum_y, double sum_z, double counter)
+{
+	double		xSquared;
+	double		ySquared;
+	double		zSquared;
+	double		vectorLength;
+
+	normal->x = sum_x / counter;
+	normal->y = sum_y / counter;
+	normal->z = sum_z / counter;
+
+	xSquared = normal->x * normal->x;
+	ySquared = normal->y * normal->y;
+	zSquared = normal->z * normal->z;
+
+	vectorLength = sqrtf (xSquared + ySquared + zSquared);
+
+	normal->x /= vectorLength;
+	normal->y /= vectorLength;
+	normal->z /= vectorLength;
+}
+
+
+#ifdef MESH_SIMD
+
+// The kernels below repeat the operations of the functions
+//  for a single face in the same order, so that each face
+//  gets exactly the same result.
+// The lengths of the vectors are computed with a single
+//  precision square root, like in 'vectorLength'.
+
+// Read a coordinate of the same corner of four consecutive faces.
+#define LOAD_CORNER_4(coordinate, face, corner)	\
+	_mm256_set_pd (	coordinate[storage->triangles[3*((face)+3) + (corner)]],	\
+					coordinate[storage->triangles[3*((face)+2) + (corner)]],	\
+					coordinate[storage->triangles[3*((face)+1) + (corner)]],	\
+					coordinate[storage->triangles[3*(face) + (corner)]] )
+
+// Read a coordinate of the same corner of two consecutive faces.
+#define LOAD_CORNER_2(coordinate, face, corner)	\
+	_mm_set_pd (	coordinate[storage->triangles[3*((face)+1) + (corner)]],	\
+					coordinate[storage->triangles[3*(face) + (corner)]] )
+
+
+// Normalize four vectors, as in 'normalizeVector'.
+__attribute__ ((target ("avx")))
+static void normalize_avx (__m256d* i, __m256d* j, __m256d* k)
+{
+	__m256d		length;
+	__m256d		is_zero;
+
+	length = _mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (*i, *i), _mm256_mul_pd (*j, *j)), _mm256_mul_pd (*k, *k));
+	length = _mm256_cvtps_pd (_mm_sqrt_ps (_mm256_cvtpd_ps (length)));
+
+	is_zero = _mm256_cmp_pd (length, _mm256_setzero_pd (), _CMP_EQ_OQ);
+	length = _mm256_blendv_pd (length, _mm256_set1_pd (1.0), is_zero);
+
+	*i = _mm256_div_pd (*i, length);
+	*j = _mm256_div_pd (*j, length);
+	*k = _mm256_div_pd (*k, length);
+}
+
+
+// Normalize two vectors, as in 'normalizeVector'.
+__attribute__ ((target ("sse2")))
+static void normalize_sse2 (__m128d* i, __m128d* j, __m128d* k)
+{
+	__m128d		length;
+	__m128d		is_zero;
+
+	length = _mm_add_pd (_mm_add_pd (_mm_mul_pd (*i, *i), _mm_mul_pd (*j, *j)), _mm_mul_pd (*k, *k));
+	length = _mm_cvtps_pd (_mm_sqrt_ps (_mm_cvtpd_ps (length)));
+
+	is_zero = _mm_cmpeq_pd (length, _mm_setzero_pd ());
+	length = _mm_or_pd (_mm_andnot_pd (is_zero, length), _mm_and_pd (is_zero, _mm_set1_pd (1.0)));
+
+	*i = _mm_div_pd (*i, length);
+	*j = _mm_div_pd (*j, length);
+	*k = _mm_div_pd (*k, length);
+}
+
+
+// Compute the normals of groups of four faces, beginning with 'face'.
+// Returns the first face not processed.
+__attribute__ ((target ("avx")))
+static int face_normals_avx (meshStoragePtr storage, int face)
+{
+	__m256d		x1, y1, z1, x2, y2, z2, x3, y3, z3;
+	__m256d		i1, j1, k1, i2, j2, k2;
+	__m256d		i, j, k;
+
+	for (; face+3<=storage->numFaces; face+=4)
+	{
+		x1 = LOAD_CORNER_4 (storage->x, face, 0);
+		y1 = LOAD_CORNER_4 (storage->y, face, 0);
+		z1 = LOAD_CORNER_4 (storage->z, face, 0);
+		x2 = LOAD_CORNER_4 (storage->x, face, 1);
+		y2 = LOAD_CORNER_4 (storage->y, face, 1);
+		z2 = LOAD_CORNER_4 (storage->z, face, 1);
+		x3 = LOAD_CORNER_4 (storage->x, face, 2);
+		y3 = LOAD_CORNER_4 (storage->y, face, 2);
+		z3 = LOAD_CORNER_4 (storage->z, face, 2);
+
+		i1 = _mm256_sub_pd (x2, x1);
+		j1 = _mm256_sub_pd (y2, y1);
+		k1 = _mm256_sub_pd (z2, z1);
+		i2 = _mm256_sub_pd (x3, x2);
+		j2 = _mm256_sub_pd (y3, y2);
+		k2 = _mm256_sub_pd (z3, z2);
+
+		i = _mm256_sub_pd (_mm256_mul_pd (j1, k2), _mm256_mul_pd (k1, j2));
+		j = _mm256_sub_pd (_mm256_mul_pd (k1, i2), _mm256_mul_pd (i1, k2));
+		k = _mm256_sub_pd (_mm256_mul_pd (i1, j2), _mm256_mul_pd (j1, i2));
+
+		normalize_avx (&i, &j, &k);
+		normalize_avx (&i, &j, &k);
+
+		_mm256_storeu_pd (&storage->normalX[face], i);
+		_mm256_storeu_pd (&storage->normalY[face], j);
+		_mm256_storeu_pd (&storage->normalZ[face], k);
+	}
+
+	return (face);
+}
+
+
+// Compute the normals of groups of two faces, beginning with 'face'.
+// Returns the first face not processed.
+__attribute__ ((target ("sse2")))
+static int face_normals_sse2 (meshStoragePtr storage, int face)
+{
+	__m128d		x1, y1, z1, x2, y2, z2, x3, y3, z3;
+	__m128d		i1, j1, k1, i2, j2, k2;
+	__m128d		i, j, k;
+
+	for (; face+1<=storage->numFaces; face+=2)
+	{
+		x1 = LOAD_CORNER_2 (storage->x, face, 0);
+		y1 = LOAD_CORNER_2 (storage->y, face, 0);
+		z1 = LOAD_CORNER_2 (storage->z, face, 0);
+		x2 = LOAD_CORNER_2 (storage->x, face, 1);
+		y2 = LOAD_CORNER_2 (storage->y, face, 1);
+		z2 = LOAD_CORNER_2 (storage->z, face, 1);
+		x3 = LOAD_CORNER_2 (storage->x, face, 2);
+		y3 = LOAD_CORNER_2 (storage->y, face, 2);
+		z3 = LOAD_CORNER_2 (storage->z, face, 2);
+
+		i1 = _mm_sub_pd (x2, x1);
+		j1 = _mm_sub_pd (y2, y1);
+		k1 = _mm_sub_pd (z2, z1);
+		i2 = _mm_sub_pd (x3, x2);
+		j2 = _mm_sub_pd (y3, y2);
+		k2 = _mm_sub_pd (z3, z2);
+
+		i = _mm_sub_pd (_mm_mul_pd (j1, k2), _mm_mul_pd (k1, j2));
+		j = _mm_sub_pd (_mm_mul_pd (k1, i2), _mm_mul_pd (i1, k2));
+		k = _mm_sub_pd (_mm_mul_pd (i1, j2), _mm_mul_pd (j1, i2));
+
+		normalize_sse2 (&i, &j, &k);
+		normalize_sse2 (&i, &j, &k);
+
+		_mm_storeu_pd (&storage->normalX[face], i);
+		_mm_storeu_pd (&storage->normalY[face], j);
+		_mm_storeu_pd (&storage->normalZ[face], k);
+	}
+
+	return (face);
+}
+
+
+// Compute the areas of groups of four faces, beginning with 'face'.
+// As in 'area3D_Polygon', the triangle is projected on the plane
+//  of the two coordinates where the normal is smallest.
+// Returns the first face not processed.
+__attribute__ ((target ("avx")))
+static int face_areas_avx (meshStoragePtr storage, int face)
+{
+	__m256d		x[3], y[3], z[3];
+	__m256d		a1[3], a2[3];
+	__m256d		nx, ny, nz;
+	__m256d		ax, ay, az, an;
+	__m256d		sign = _mm256_set1_pd (-0.0);
+	__m256d		zero = _mm256_setzero_pd ();
+	__m256d		ignore_x, ignore_y, ignore_z;
+	__m256d		greater_xy, greater_xz, greater_yz;
+	__m256d		area, scale;
+	int			c;
+
+	for (; face+3<=storage->numFaces; face+=4)
+	{
+		for (c=0; c<3; c++)
+		{
+			x[c] = LOAD_CORNER_4 (storage->x, face, c);
+			y[c] = LOAD_CORNER_4 (storage->y, face, c);
+			z[c] = LOAD_CORNER_4 (storage->z, face, c);
+		}
+		nx = _mm256_loadu_pd (&storage->normalX[face]);
+		ny = _mm256_loadu_pd (&storage->normalY[face]);
+		nz = _mm256_loadu_pd (&storage->normalZ[face]);
+
+		// The absolute values, written as (n > 0 ? n : -n).
+		ax = _mm256_blendv_pd (_mm256_xor_pd (nx, sign), nx, _mm256_cmp_pd (nx, zero, _CMP_GT_OQ));
+		ay = _mm256_blendv_pd (_mm256_xor_pd (ny, sign), ny, _mm256_cmp_pd (ny, zero, _CMP_GT_OQ));
+		az = _mm256_blendv_pd (_mm256_xor_pd (nz, sign), nz, _mm256_cmp_pd (nz, zero, _CMP_GT_OQ));
+
+		// Select the coordinate to ignore.
+		greater_xy = _mm256_cmp_pd (ax, ay, _CMP_GT_OQ);
+		greater_xz = _mm256_cmp_pd (ax, az, _CMP_GT_OQ);
+		greater_yz = _mm256_cmp_pd (ay, az, _CMP_GT_OQ);
+		ignore_x = _mm256_and_pd (greater_xy, greater_xz);
+		ignore_y = _mm256_andnot_pd (greater_xy, greater_yz);
+		ignore_z = _mm256_andnot_pd (_mm256_or_pd (ignore_x, ignore_y), _mm256_cmp_pd (zero, zero, _CMP_EQ_OQ));
+
+		// The two coordinates of the projection.
+		for (c=0; c<3; c++)
+		{
+			a1[c] = _mm256_blendv_pd (x[c], y[c], ignore_x);
+			a2[c] = _mm256_blendv_pd (z[c], y[c], ignore_z);
+		}
+
+		area = _mm256_add_pd (zero, _mm256_mul_pd (a1[1], _mm256_sub_pd (a2[2], a2[0])));
+		area = _mm256_add_pd (area, _mm256_mul_pd (a1[2], _mm256_sub_pd (a2[0], a2[1])));
+		area = _mm256_add_pd (area, _mm256_mul_pd (a1[0], _mm256_sub_pd (a2[1], a2[2])));
+
+		// Scale to get the area before the projection.
+		an = _mm256_sqrt_pd (_mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (ax, ax), _mm256_mul_pd (ay, ay)), _mm256_mul_pd (az, az)));
+		scale = _mm256_blendv_pd (_mm256_blendv_pd (az, ay, ignore_y), ax, ignore_x);
+		scale = _mm256_div_pd (an, _mm256_mul_pd (_mm256_set1_pd (2.0), scale));
+		area = _mm256_mul_pd (area, scale);
+
+		// Make the area positive.
+		area = _mm256_blendv_pd (area, _mm256_xor_pd (area, sign), _mm256_cmp_pd (area, zero, _CMP_LT_OQ));
+
+		_mm256_storeu_pd (&storage->area[face], area);
+	}
+
+	return (face);
+}
+
+
+// Choose between two values, according to a mask.
+__attribute__ ((target ("sse2")))
+static __m128d select_sse2 (__m128d mask, __m128d if_true, __m128d if_false)
+{
+	return (_mm_or_pd (_mm_and_pd (mask, if_true), _mm_andnot_pd (mask, if_false)));
+}
+
+
+// Compute the areas of groups of two faces, beginning with 'face'.
+// Returns the first face not processed.
+__attribute__ ((target ("sse2")))
+static int face_areas_sse2 (meshStoragePtr storage, int face)
+{
+	__m128d		x[3], y[3], z[3];
+	__m128d		a1[3], a2[3];
+	__m128d		nx, ny, nz;
+	__m128d		ax, ay, az, an;
+	__m128d		sign = _mm_set1_pd (-0.0);
+	__m128d		zero = _mm_setzero_pd ();
+	__m128d		ignore_x, ignore_y, ignore_z;
+	__m128d		greater_xy, greater_xz, greater_yz;
+	__m128d		area, scale;
+	int			c;
+
+	for (; face+1<=storage->numFaces; face+=2)
+	{
+		for (c=0; c<3; c++)
+		{
+			x[c] = LOAD_CORNER_2 (storage->x, face, c);
+			y[c] = LOAD_CORNER_2 (storage->y, face, c);
+			z[c] = LOAD_CORNER_2 (storage->z, face, c);
+		}
+		nx = _mm_loadu_pd (&storage->normalX[face]);
+		ny = _mm_loadu_pd (&storage->normalY[face]);
+		nz = _mm_loadu_pd (&storage->normalZ[face]);
+
+		ax = select_sse2 (_mm_cmpgt_pd (nx, zero), nx, _mm_xor_pd (nx, sign));
+		ay = select_sse2 (_mm_cmpgt_pd (ny, zero), ny, _mm_xor_pd (ny, sign));
+		az = select_sse2 (_mm_cmpgt_pd (nz, zero), nz, _mm_xor_pd (nz, sign));
+
+		greater_xy = _mm_cmpgt_pd (ax, ay);
+		greater_xz = _mm_cmpgt_pd (ax, az);
+		greater_yz = _mm_cmpgt_pd (ay, az);
+		ignore_x = _mm_and_pd (greater_xy, greater_xz);
+		ignore_y = _mm_andnot_pd (greater_xy, greater_yz);
+		ignore_z = _mm_andnot_pd (_mm_or_pd (ignore_x, ignore_y), _mm_cmpeq_pd (zero, zero));
+
+		for (c=0; c<3; c++)
+		{
+			a1[c] = select_sse2 (ignore_x, y[c], x[c]);
+			a2[c] = select_sse2 (ignore_z, y[c], z[c]);
+		}
+
+		area = _mm_add_pd (zero, _mm_mul_pd (a1[1], _mm_sub_pd (a2[2], a2[0])));
+		area = _mm_add_pd (area, _mm_mul_pd (a1[2], _mm_sub_pd (a2[0], a2[1])));
+		area = _mm_add_pd (area, _mm_mul_pd (a1[0], _mm_sub_pd (a2[1], a2[2])));
+
+		an = _mm_sqrt_pd (_mm_add_pd (_mm_add_pd (_mm_mul_pd (ax, ax), _mm_mul_pd (ay, ay)), _mm_mul_pd (az, az)));
+		scale = select_sse2 (ignore_x, ax, select_sse2 (ignore_y, ay, az));
+		scale = _mm_div_pd (an, _mm_mul_pd (_mm_set1_pd (2.0), scale));
+		area = _mm_mul_pd (area, scale);
+
+		area = select_sse2 (_mm_cmplt_pd (area, zero), _mm_xor_pd (area, sign), area);
+
+		_mm_storeu_pd (&storage->area[face], area);
+	}
+
+	return (face);
+}
+
+
+// Finish the normals of groups of four vertices, beginning with 'vertex'.
+// Returns the first vertex not processed.
+__attribute__ ((target ("avx")))
+static int vertex_normals_avx (vertexPtr normals, double* sum_x, double* sum_y, double* sum_z, double* counters, int num_vertices, int vertex)
+{
+	__m256d		x, y, z;
+	__m256d		counter;
+	__m256d		length;
+	double		result[3][4];
+	int			l;
+
+	for (; vertex+3<=num_vertices; vertex+=4)
+	{
+		counter = _mm256_loadu_pd (&counters[vertex]);
+		x = _mm256_div_pd (_mm256_loadu_pd (&sum_x[vertex]), counter);
+		y = _mm256_div_pd (_mm256_loadu_pd (&sum_y[vertex]), counter);
+		z = _mm256_div_pd (_mm256_loadu_pd (&sum_z[vertex]), counter);
+
+		length = _mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (x, x), _mm256_mul_pd (y, y)), _mm256_mul_pd (z, z));
+		length = _mm256_cvtps_pd (_mm_sqrt_ps (_mm256_cvtpd_ps (length)));
+
+		_mm256_storeu_pd (result[0], _mm256_div_pd (x, length));
+		_mm256_storeu_pd (result[1], _mm256_div_pd (y, length));
+		_mm256_storeu_pd (result[2], _mm256_div_pd (z, length));
+
+		for (l=0; l<4; l++)
+		{
+			normals[vertex+l].x = result[0][l];
+			normals[vertex+l].y = result[1][l];
+			normals[vertex+l].z = result[2][l];
+		}
+	}
+
+	return (vertex);
+}
+
+
+// Finish the normals of groups of two vertices, beginning with 'vertex'.
+// Returns the first vertex not processed.
+__attribute__ ((target ("sse2")))
+static int vertex_normals_sse2 (vertexPtr normals, double* sum_x, double* sum_y, double* sum_z, double* counters, int num_vertices, int vertex)
+{
+	__m128d		x, y, z;
+	__m128d		counter;
+	__m128d		length;
+	double		result[3][2];
+	int			l;
+
+	for (; vertex+1<=num_vertices; vertex+=2)
+	{
+		counter = _mm_loadu_pd (&counters[vertex]);
+		x = _mm_div_pd (_mm_loadu_pd (&sum_x[vertex]), counter);
+		y = _mm_div_pd (_mm_loadu_pd (&sum_y[vertex]), counter);
+		z = _mm_div_pd (_mm_loadu_pd (&sum_z[vertex]), counter);
+
+		length = _mm_add_pd (_mm_add_pd (_mm_mul_pd (x, x), _mm_mul_pd (y, y)), _mm_mul_pd (z, z));
+		length = _mm_cvtps_pd (_mm_sqrt_ps (_mm_cvtpd_ps (length)));
+
+		_mm_storeu_pd (result[0], _mm_div_pd (x, length));
+		_mm_storeu_pd (result[1], _mm_div_pd (y, length));
+		_mm_storeu_pd (result[2], _mm_div_pd (z, length));
+
+		for (l=0; l<2; l++)
+		{
+			normals[vertex+l].x = result[0][l];
+			normals[vertex+l].y = result[1][l];
+			normals[vertex+l].z = result[2][l];
+		}
+	}
+
+	return (vertex);
+}
+
+#endif	// MESH_SIMD
+
+
+// Compute the unit normal of every face.
+// The results are the same as those of 'getTriangleNormal'.
+void mesh_face_normals (meshStoragePtr storage)
+{
+	int		face = 1;
+
+#ifdef MESH_SIMD
+	if (__builtin_cpu_supports ("avx"))
+		face = face_normals_avx (storage, face);
+	face = face_normals_sse2 (storage, face);
+#endif
+
+	for (; face<=storage->numFaces; face++)
+		face_normal (storage, face);
+}
+
+
+// Compute the area of every face, using its normal.
+// The results are the same as those of 'area3D_face'.
+void mesh_face_areas (meshStoragePtr storage)
+{
+	int		face = 1;
+
+#ifdef MESH_SIMD
+	if (__builtin_cpu_supports ("avx"))
+		face = face_areas_avx (storage, face);
+	face = face_areas_sse2 (storage, face);
+#endif
+
+	for (; face<=storage->numFaces; face++)
+		face_area (storage, face);
+}
+
+
+// Add the areas of all the faces.
+double mesh_surface_area (meshStoragePtr storage)
+{
+	double		surface_area = 0.0;
+	int			i;
+
+	// The areas are added in order, so that the total
+	//  does not depend on the kernel used.
+	for (i=1; i<=storage->numFaces; i++)
+		surface_area += storage->area[i];
+
+	return (surface_area);
+}
+
+
+// Compute the normal of each vertex, as the average of
+//  the normals of the faces around it.
+// Returns an array of vertices with the endpoints of the
+//  normals, indexed beginning with 1.
+vertexPtr mesh_vertex_normals (meshStoragePtr storage)
+{
+	vertexPtr	normals = NULL;
+	double*		sum_x = NULL;
+	double*		sum_y = NULL;
+	double*		sum_z = NULL;
+	double*		counters = NULL;
+	size_t		size = sizeof (double) * (storage->numVertices + 1);
+	int			vertex;
+	int			face;
+	int			c;
+
+	// Allocate memory for as many vertices as there exist.
+	normals = (vertexPtr) xmalloc (sizeof (vertexStruct) * (storage->numVertices + 1));
+	memset (normals, 0, sizeof (vertexStruct) * (storage->numVertices + 1));
+	sum_x = (double*) xmalloc (size);
+	sum_y = (double*) xmalloc (size);
+	sum_z = (double*) xmalloc (size);
+	counters = (double*) xmalloc (size);
+	memset (sum_x, 0, size);
+	memset (sum_y, 0, size);
+	memset (sum_z, 0, size);
+	memset (counters, 0, size);
+
+	// Add the normal of each face to its vertices.
+	// The faces are visited in order, so that the sums
+	//  are always done in the same order.
+	for (face=1; face<=storage->numFaces; face++)
+	{
+		for (c=0; c<4; c++)
+		{
+			vertex = (c < 3) ? storage->triangles[3*face + c] : storage->fourthVertex[face];
+			if (vertex == -1)
+				continue;
+
+			sum_x[vertex] += storage->normalX[face];
+			sum_y[vertex] += storage->normalY[face];
+			sum_z[vertex] += storage->normalZ[face];
+			counters[vertex] += 1;
+		}
+	}
+
+	for (vertex=1; vertex<=storage->numVertices; vertex++)
+		normals[vertex].vertexId = vertex;
+
+	vertex = 1;
+#ifdef MESH_SIMD
+	if (__builtin_cpu_supports ("avx"))
+		vertex = vertex_normals_avx (normals, sum_x, sum_y, sum_z, counters, storage->numVertices, vertex);
+	vertex = vertex_normals_sse2 (normals, sum_x, sum_y, sum_z, counters, storage->numVertices, vertex);
+#endif
+
+	for (; vertex<=storage->numVertices; vertex++)
+		vertex_normal (&normals[vertex], sum_x[vertex], sum_y[vertex], sum_z[vertex], counters[vertex]);
+
+	free (sum_x);
+	free (sum_y);
+	free (sum_z);
+	free (counters);
+
+	return (normals);
+}
+
+
+// Create a vector with the normal of a face of the storage.
+vectorPtr new_mesh_face_normal (meshStoragePtr storage, int face_index, int face_id)
+{
+	vectorPtr	normal = NULL;
+
+	normal = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
+
+	normal->i = storage->normalX[face_index];
+	normal->j = storage->normalY[face_index];
+	normal->k = storage->normalZ[face_index];
+	// Give the normal an Id number,
+	//  related to the number of the face.
+	normal->vectorId = face_id;
+	normal->type = NORMAL;
+	// Variable to store the arc intersections
+	//  of the indicatrix that occur at the
+	//  location of this vector.
+	// (Used in sphericalGeometry.c)
+	normal->num_intersections = 0;
+
+	return (normal);
+}
+
+
+// Give the faces of an array new vectors with the normals
+//  of the storage.
+void store_mesh_face_normals (meshStoragePtr storage, facePtr face_array)
+{
+	int		i;
+
+	for (i=1; i<=storage->numFaces; i++)
+		face_array[i].faceNormal = new_mesh_face_normal (storage, i, face_array[i].faceId);
+}
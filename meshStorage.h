@@ -0,0 +1,69 @@
+// Data structures
+
+// MESH STORAGE
+// Geometry of a mesh kept as a structure of arrays, so that the
+//  loops over all the faces can work on several faces at a time.
+// All the arrays are indexed beginning with 1, like the arrays of
+//  vertices and faces of the objectStruct.
+typedef struct meshStorageStruct
+{
+	int			numVertices;
+	int			numFaces;
+
+	// Coordinates of the vertices.
+	real*		x;
+	real*		y;
+	real*		z;
+
+	// Three vertices of each face, one after the other.
+	// The vertices of face 'i' begin at 'triangles[3*i]'.
+	int*		triangles;
+	// Fourth vertex of the faces with 4 vertices, or -1.
+	int*		fourthVertex;
+
+	// Unit normal and area of each face.
+	real*		normalX;
+	real*		normalY;
+	real*		normalZ;
+	real*		area;
+} meshStorageStruct;
+
+typedef meshStorageStruct* meshStoragePtr;
+
+
+// Function declarations
+
+// Create the storage of a mesh, with the same vertices
+//  and faces as the arrays given.
+// The normals already computed for the faces are copied.
+meshStorageStruct new_mesh_storage (vertexPtr vertex_array, int num_vertices, facePtr face_array, int num_faces);
+
+// Create the storage of a mesh with the faces in a list.
+meshStorageStruct new_mesh_storage_from_list (vertexPtr vertex_array, int num_vertices, nodePtr face_list);
+
+// Release the memory of the storage.
+void free_mesh_storage (meshStoragePtr storage);
+
+// Compute the unit normal of every face.
+// The results are the same as those of 'getTriangleNormal'.
+void mesh_face_normals (meshStoragePtr storage);
+
+// Compute the area of every face, using its normal.
+// The results are the same as those of 'area3D_face'.
+void mesh_face_areas (meshStoragePtr storage);
+
+// Add the areas of all the faces.
+double mesh_surface_area (meshStoragePtr storage);
+
+// Compute the normal of each vertex, as the average of
+//  the normals of the faces around it.
+// Returns an array of vertices with the endpoints of the
+//  normals, indexed beginning with 1.
+vertexPtr mesh_vertex_normals (meshStoragePtr storage);
+
+// Create a vector with the normal of a face of the storage.
+vectorPtr new_mesh_face_normal (meshStoragePtr storage, int face_index, int face_id);
+
+// Give the faces of an array new vectors with the normals
+//  of the storage.
+void store_mesh_face_normals (meshStoragePtr storage, facePtr face_array);
@@ -0,0 +1,124 @@
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "object3D.h"
+#include "meshWriter.h"
+
+// Number of records formatted by each thread at a time.
+#define RECORDS_PER_CHUNK	8192
+
+// A range of records, formatted by a single thread.
+typedef struct
+{
+	recordFormatter		format;
+	void*				data;
+	int					first;
+	int					last;
+	char*				buffer;
+	size_t				length;
+} formatChunkStruct;
+
+typedef formatChunkStruct* formatChunkPtr;
+
+
+// Create an array with the new index of each vertex,
+//  once the deleted vertices (negative ids) are removed.
+// Deleted vertices get the index 0.
+int* build_vertex_remap (objectStruct object_data, int* num_vertices)
+{
+	int*		remap = NULL;
+	int			counter = 0;
+	int			i;
+
+	remap = (int*) xmalloc (sizeof (int) * (object_data.numVertices + 1));
+	remap[0] = 0;
+
+	for (i=1; i<=object_data.numVertices; i++)
+	{
+		if (object_data.vertexArray[i].vertexId < 0)
+			remap[i] = 0;
+		else
+			remap[i] = ++counter;
+	}
+
+	*num_vertices = counter;
+
+	return (remap);
+}
+
+
+// Count the faces that have not been deleted.
+int count_valid_faces (objectStruct object_data)
+{
+	int			counter = 0;
+	int			i;
+
+	for (i=1; i<=object_data.numFaces; i++)
+		if (object_data.faceArray[i].faceId >= 0)
+			counter++;
+
+	return (counter);
+}
+
+
+// Thread function to format a range of records.
+static void* format_chunk (void* argument)
+{
+	formatChunkPtr	chunk = (formatChunkPtr) argument;
+	int				i;
+
+	chunk->length = 0;
+	for (i=chunk->first; i<=chunk->last; i++)
+		chunk->length += chunk->format (chunk->buffer + chunk->length, i, chunk->data);
+
+	return (NULL);
+}
+
+
+// Format the records from 'first' to 'last' in parallel,
+//  and write them to the file in order.
+// Each thread formats a range of records into its own buffer,
+//  and the buffers are then written with a single call each.
+// 'max_length' is the largest number of characters of a record.
+void write_records (FILE* fileDescriptor, recordFormatter format, void* data, int first, int last, int max_length, int progress_offset, int progress_total)
+{
+	formatChunkPtr	chunks = NULL;
+	int				num_threads = getNumThreads ();
+	int				num_chunks;
+	int				next = first;
+	int				i;
+
+	chunks = (formatChunkPtr) xmalloc (sizeof (formatChunkStruct) * num_threads);
+	for (i=0; i<num_threads; i++)
+	{
+		chunks[i].format = format;
+		chunks[i].data = data;
+		chunks[i].buffer = (char*) xmalloc ((size_t) max_length * RECORDS_PER_CHUNK);
+	}
+
+	while (next <= last)
+	{
+		// Give a range of records to each thread.
+		for (num_chunks=0; (num_chunks < num_threads) && (next <= last); num_chunks++)
+		{
+			chunks[num_chunks].first = next;
+			chunks[num_chunks].last = next + RECORDS_PER_CHUNK - 1;
+			if (chunks[num_chunks].last > last)
+				chunks[num_chunks].last = last;
+			next = chunks[num_chunks].last + 1;
+		}
+
+		runInThreads (format_chunk, chunks, sizeof (formatChunkStruct), num_chunks);
+
+		for (i=0; i<num_chunks; i++)
+			fwrite (chunks[i].buffer, 1, chunks[i].length, fileDescriptor);
+
+		printProgressStar (progress_offset + next - first, progress_total);
+	}
+
+	for (i=0; i<num_threads; i++)
+		free (chunks[i].buffer);
+	free (chunks);
+}
@@ -0,0 +1,27 @@
+// Data given to the functions that format the records.
+typedef struct meshWriterDataStruct
+{
+	objectPtr	object_data;
+	int*		vertex_remap;
+} meshWriterDataStruct;
+
+typedef meshWriterDataStruct* meshWriterDataPtr;
+
+// Function to write one record of a file into a buffer.
+// Returns the number of characters written, which may
+//  be 0 for records that must be skipped.
+typedef int (*recordFormatter) (char* buffer, int index, void* data);
+
+
+// Create an array with the new index of each vertex,
+//  once the deleted vertices (negative ids) are removed.
+// Deleted vertices get the index 0.
+// The number of remaining vertices is returned in 'num_vertices'.
+int* build_vertex_remap (objectStruct object_data, int* num_vertices);
+
+// Count the faces that have not been deleted.
+int count_valid_faces (objectStruct object_data);
+
+// Format the records from 'first' to 'last' in parallel,
+//  and write them to the file in order.
+void write_records (FILE* fileDescriptor, recordFormatter format, void* data, int first, int last, int max_length, int progress_offset, int progress_total);
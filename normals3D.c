@@ -1,9 +1,11 @@
 #include <math.h>
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 #include "vertices.h"
 #include "geometry.h"
 #include "faces.h"
+#include "meshStorage.h"
 #include "normals3D.h"
 
 
@@ -14,105 +16,50 @@
 //  each vertex.
 vertexPtr normalsFromVertices (vertexPtr vertices, nodePtr faceList, int numVertices)
 {
-	nodePtr		pointer = faceList;
-	facePtr		face = NULL;
-	int			p1;
-	int			p2;
-	int			p3;
-	int			p4;
-	int			i;
-	vectorPtr	faceNormal = NULL;
-	vertexPtr	normals = NULL;
-	int*		counters = NULL;
-	double		xSquared;
-	double		ySquared;
-	double		zSquared;
-	double		vectorLength;
-
-	// Allocate memory for as many vertices as there exist.
-	normals = (vertexPtr) xmalloc (sizeof (vertexStruct) * (numVertices + 1));
-	memset (normals, 0, sizeof (vertexStruct) * (numVertices + 1));
-	counters = (int*) xmalloc (sizeof (int) * (numVertices + 1));
-	memset (counters, 0, sizeof (int) * (numVertices + 1));
+	nodePtr				pointer = NULL;
+	facePtr				face = NULL;
+	vertexPtr			normals = NULL;
+	meshStorageStruct	storage;
+	int					i;
 
 	// Skip over the first (empty) face in the list.
-	pointer = pointer->next;
+	storage = new_mesh_storage_from_list (vertices, numVertices, faceList->next);
 
-	// For each face in the model.
-	while (pointer != NULL)
+	mesh_face_normals (&storage);
+
+	// Assign the normals to the face structures.
+	i = 1;
+	for (pointer=faceList->next; pointer!=NULL; pointer=pointer->next)
 	{
-		// Get the current face.
 		face = (facePtr) pointer->data;
-
-		p1 = face->vertex[0];
-		p2 = face->vertex[1];
-		p3 = face->vertex[2];
-		p4 = face->vertex[3];
-
-		// Get the normal for the current triangle.
-		faceNormal = getTriangleNormal (vertices[p1], vertices[p2], vertices[p3]);
-
-		// Assign the normal to the face structure.
-		face->faceNormal = faceNormal;
-		// Give the normal an Id number,
-		//  related to the number of the face.
-		face->faceNormal->vectorId = face->faceId;
-		face->faceNormal->type = NORMAL;
-		// Variable to store the arc intersections
-		//  of the indicatrix that occur at the
-		//  location of this vector.
-		// (Used in sphericalGeometry.c)
-		face->faceNormal->num_intersections = 0;
-
-		// Add the normal components to the sums
-		//  for each of the vertices that belong
-		//  to the current face.
-		normals[p1].x += faceNormal->i;
-		normals[p1].y += faceNormal->j;
-		normals[p1].z += faceNormal->k;
-		counters[p1] += 1;
-
-		normals[p2].x += faceNormal->i;
-		normals[p2].y += faceNormal->j;
-		normals[p2].z += faceNormal->k;
-		counters[p2] += 1;
-
-		normals[p3].x += faceNormal->i;
-		normals[p3].y += faceNormal->j;
-		normals[p3].z += faceNormal->k;
-		counters[p3] += 1;
-
-		if (face->faceVertices == 4)
-		{
-			normals[p4].x += faceNormal->i;
-			normals[p4].y += faceNormal->j;
-			normals[p4].z += faceNormal->k;
-			counters[p4] += 1;
-		}
-
-		pointer = pointer->next;
+		face->faceNormal = new_mesh_face_normal (&storage, i++, face->faceId);
 	}
 
-	// Reduce the size of the normals.
-	for (i=1; i<=numVertices; i++)
-	{
-		normals[i].vertexId = i;
-		normals[i].x /= counters[i];
-		normals[i].y /= counters[i];
-		normals[i].z /= counters[i];
+	normals = mesh_vertex_normals (&storage);
 
-		xSquared = normals[i].x * normals[i].x;
-		ySquared = normals[i].y * normals[i].y;
-		zSquared = normals[i].z * normals[i].z;
+	free_mesh_storage (&storage);
 
-		vectorLength = sqrtf (xSquared + ySquared + zSquared);
+	return (normals);
+}
 
-		normals[i].x /= vectorLength;
-		normals[i].y /= vectorLength;
-		normals[i].z /= vectorLength;
-	}
 
-	free (counters);
+// Compute the normals of each face, and then of each vertex.
+// Same as 'normalsFromVertices', but taking the faces
+//  from an array indexed beginning with 1, as they
+//  are stored in the objectStruct.
+vertexPtr normalsFromFaceArray (vertexPtr vertices, facePtr faceArray, int numFaces, int numVertices)
+{
+	vertexPtr			normals = NULL;
+	meshStorageStruct	storage;
+
+	storage = new_mesh_storage (vertices, numVertices, faceArray, numFaces);
+
+	mesh_face_normals (&storage);
+	store_mesh_face_normals (&storage, faceArray);
+
+	normals = mesh_vertex_normals (&storage);
+
+	free_mesh_storage (&storage);
 
 	return (normals);
 }
@@ -123,19 +70,28 @@ vertexPtr normalsFromVertices (vertexPtr vertices, nodePtr faceList, int numVert
 //  on them. Finally normalize the vector length.
 vectorPtr getTriangleNormal (vertexStruct vertex1, vertexStruct vertex2, vertexStruct vertex3)
 {
-	vectorPtr		vector1 = NULL;
-	vectorPtr		vector2 = NULL;
 	vectorPtr		normalVector = NULL;
 
-	vector1 = vectorFromVertices (&vertex1, &vertex2);
-	vector2 = vectorFromVertices (&vertex2, &vertex3);
+	normalVector = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
+	*normalVector = triangle_normal (&vertex1, &vertex2, &vertex3);
+
+	return (normalVector);
+}
+
+
+// Compute the normal of a triangle, returning it by value.
+vectorStruct triangle_normal (vertexPtr vertex1, vertexPtr vertex2, vertexPtr vertex3)
+{
+	vectorStruct	vector1;
+	vectorStruct	vector2;
+	vectorStruct	normalVector;
 
-	normalVector = crossProduct (vector1, vector2);
+	vector1 = vector_from_vertices (vertex1, vertex2);
+	vector2 = vector_from_vertices (vertex2, vertex3);
 
-	normalizeVector (normalVector);
+	normalVector = cross_product (&vector1, &vector2);
 
-	free (vector1);
-	free (vector2);
+	normalizeVector (&normalVector);
 
 	return (normalVector);
 }
@@ -1,7 +1,15 @@
 // Compute the normals of each face, and then of each verte.
 vertexPtr normalsFromVertices (vertexPtr vertices, nodePtr faceList, int numVertices);
 
+// Same as 'normalsFromVertices', but taking the faces
+//  from an array indexed beginning with 1.
+vertexPtr normalsFromFaceArray (vertexPtr vertices, facePtr faceArray, int numFaces, int numVertices);
+
 // Compute the normal of a triangle, by using its vertices
 //  to create 2 vectors, and then perform the cross product
 //  on them. Finally normalize the vector length.
 vectorPtr getTriangleNormal (vertexStruct vertex1, vertexStruct vertex2, vertexStruct vertex3);
+
+// Same as 'getTriangleNormal', but returning the vector
+//  by value, without allocating memory.
+vectorStruct triangle_normal (vertexPtr vertex1, vertexPtr vertex2, vertexPtr vertex3);
@@ -4,266 +4,423 @@
 #include "geometry.h"
 #include "faces.h"
 #include "object3D.h"
+#include "adjacency.h"
+#include "meshStorage.h"
 #include "normals3D.h"
 #include "objParser.h"
 
-// Global variable to dump useless data.
-char*		string;
+// Minimum size of the block of data to parse in each thread.
+#define MIN_CHUNK_SIZE	(1 << 20)
+
+// A block of an obj file, parsed by a single thread.
+typedef struct
+{
+	char*		start;
+	char*		end;
+	int			numVertices;
+	int			numFaces;
+	int			vertexOffset;
+	int			faceOffset;
+	vertexPtr	vertexArray;
+	facePtr		faceArray;
+} objChunkStruct;
+
+typedef objChunkStruct* objChunkPtr;
+
+// Types of line found in an obj file.
+typedef enum {OTHER_LINE, VERTEX_LINE, FACE_LINE}	objLineType;
+
+// Identify the type of definition in the line
+//  beginning at 'cursor'.
+static objLineType lineType (char* cursor, char* end)
+{
+	cursor = skipBlanks (cursor, end);
+
+	if ( (end - cursor < 2) || (cursor[1] != ' ' && cursor[1] != '\t') )
+		return (OTHER_LINE);
+
+	if (cursor[0] == 'v')
+		return (VERTEX_LINE);
+	if (cursor[0] == 'f')
+		return (FACE_LINE);
+
+	return (OTHER_LINE);
+}
 
 
 
 // Parse an obj file and create lists with the vertices and faces.
 // Also creates an array with lists of faces that converge
 //  on each of the vertices.
+// The program is stopped if the file can not be read.
 objectStruct readObjFile (char* filename)
 {
-	FILE*			OBJ_FD = NULL;
-	char			keyword;
-	nodePtr			vertexList = NULL;
-	nodePtr			vertexListTail = NULL;
-	nodePtr			faceList = NULL;
-	nodePtr			faceListTail = NULL;
-	nodePtr*		vertexFaceArray = NULL;
-	vertexPtr		vertex = NULL;
+	objectStruct	objectData;
+
+	if (!read_obj_file (filename, &objectData))
+	{
+		printf ("Exiting.\n");
+		exit (1);
+	}
+
+	return (objectData);
+}
+
+
+// Parse an obj file into an object structure.
+// Plain files are mapped into memory, while files compressed
+//  with gzip and the standard input ('-') are decoded into a
+//  buffer in large blocks.
+// Returns FALSE, with a message, if the file can not be read
+//  or is not valid.
+boolean read_obj_file (char* filename, objectPtr object_data)
+{
+	char*			data = NULL;
+	size_t			length;
+	boolean			success;
+
+	if (!loadFile (filename, &data, &length))
+		return (FALSE);
+
+	success = readObjBuffer (data, length, filename, object_data);
+
+	xunloadfile (filename, data, length);
+
+	return (success);
+}
+
+
+// Thread function to count the definitions in a chunk.
+static void* countChunk (void* argument)
+{
+	objChunkPtr		chunk = (objChunkPtr) argument;
+
+	countObjRecords (chunk->start, chunk->end, &chunk->numVertices, &chunk->numFaces);
+
+	return (NULL);
+}
+
+
+// Thread function to parse the definitions in a chunk.
+static void* parseChunk (void* argument)
+{
+	objChunkPtr		chunk = (objChunkPtr) argument;
+
+	parseObjRecords (chunk->start, chunk->end, chunk->vertexArray, chunk->faceArray, chunk->vertexOffset, chunk->faceOffset);
+
+	return (NULL);
+}
+
+
+// Parse the contents of an obj file, already stored in memory.
+// A first pass counts the vertices and faces, so that the
+//  arrays can be allocated once, and the second pass reads
+//  the data directly into them.
+// Large files are split on line boundaries and each chunk
+//  is counted and parsed by a separate thread.
+// The counts of the previous chunks give the index of the
+//  first vertex and face of each chunk, so that the numbering
+//  is the same as when reading the file sequentially.
+// Returns FALSE, with a message, if a face uses a vertex
+//  that is not defined.
+boolean readObjBuffer (char* data, size_t length, char* filename, objectPtr objectData)
+{
+	char*			end = data + length;
 	vertexPtr		vertexArray = NULL;
-	vertexPtr		normalArray = NULL;
 	facePtr			faceArray = NULL;
-	facePtr			face = NULL;
+	objChunkPtr		chunks = NULL;
+	char*			boundary;
+	int				numChunks;
 	int				i;
+	int				j;
 	int				vertex_counter = 0;
 	int				face_counter = 0;
-	int*			facesPerVertex = NULL;
-	boolean			textured = FALSE;
-	boolean			normals = FALSE;
-	objectStruct	objectData;
-
-	OBJ_FD = xfopen (filename, "r");
 
-	string = (char*) xmalloc (sizeof (char) * 100);
+	numChunks = getNumThreads ();
+	if (length / MIN_CHUNK_SIZE < (size_t) numChunks)
+		numChunks = (int) (length / MIN_CHUNK_SIZE);
+	if (numChunks < 1)
+		numChunks = 1;
 
-	// Add an empty vertex at the beginning of the vertex list.
-	// It will be disregarded, and thus the vertices will be
-	//  indexed beginning with 1, when they are transfered to
-	//  an array.
-	vertex = createVertex (0, 0, 0, 0);
-	vertexList = addNode (NULL, vertex);
-	vertexListTail = vertexList;
+	chunks = (objChunkPtr) xmalloc (sizeof (objChunkStruct) * numChunks);
 
-	// Add an empty face at the beginning of the face list.
-	// It will be disregarded, and thus the faces will be
-	//  indexed beginning with 1, when they are transfered to
-	//  an array.
-	face = createEmptyFace ();
-	faceList = addNode (NULL, face);
-	faceListTail = faceList;
-
-	while (!feof (OBJ_FD))
+	// Split the data at the beginning of a line.
+	boundary = data;
+	for (i=0; i<numChunks; i++)
 	{
-		keyword = getc (OBJ_FD);
-
-		switch (keyword)
+		chunks[i].start = boundary;
+		if (i == numChunks - 1)
+			boundary = end;
+		else
 		{
-			case 'v':	// A vertex definition
-				keyword = getc (OBJ_FD);
-				if (keyword == ' ' || keyword == '\t')	// Normal vertex
-				{
-					vertex = readVertex (OBJ_FD);
-					vertexListTail = addNode (vertexListTail, vertex);
-					vertex_counter++;
-					vertex->vertexId = vertex_counter;
-				}
-				else if (keyword == 't')	// Texture vertex
-				{
-					textured = TRUE;
-				}
-				else if (keyword == 'n')	// Normal vertex
-				{
-					normals = TRUE;
-				}
-				break;
-			case 'f':	// A face definition
-				face = readFace (OBJ_FD, textured, normals);
-				faceListTail = addNode (faceListTail, face);
-				face_counter++;
-				face->faceId = face_counter;
-
-				// Initialize arrays for vertex faces.
-				if (vertexFaceArray == NULL)
-				{
-					vertexFaceArray = (nodePtr*) xmalloc ( sizeof (nodePtr) * (vertex_counter+1) );
-					facesPerVertex = (int*) xmalloc ( sizeof(int) * (vertex_counter+1) );
-					for (i=0; i<=vertex_counter; i++)
-					{
-						vertexFaceArray[i] = NULL;
-						facesPerVertex[i] = 0;
-					}
-				}
-				vertexFaceArray = addFaceToVertexFaceArray (vertexFaceArray, face, vertex_counter, facesPerVertex);
-				break;
-			case '\n':	// A blank line
-				break;
-			default:	// Any other case
-				// Read and discard the line
-				fgets(string, 100, OBJ_FD);
-				break;
+			boundary = data + (length / numChunks) * (i + 1);
+			if (boundary < chunks[i].start)
+				boundary = chunks[i].start;
+			if ( (boundary > data) && (boundary[-1] != '\n') )
+				boundary = skipLine (boundary, end);
 		}
+		chunks[i].end = boundary;
 	}
 
-	free (string);
+	runInThreads (countChunk, chunks, sizeof (objChunkStruct), numChunks);
 
-	fclose (OBJ_FD);
+	for (i=0; i<numChunks; i++)
+	{
+		chunks[i].vertexOffset = vertex_counter;
+		chunks[i].faceOffset = face_counter;
+		vertex_counter += chunks[i].numVertices;
+		face_counter += chunks[i].numFaces;
+	}
 
-	// Convert the list of vertices into an array.
-	// The array will have 'numVertices'+1 elements.
+	// The arrays will have one element more than the number of
+	//  vertices and faces.
 	// The element at index 0 is blank, allowing the
-	//  real vertices to start from index 1.
-	vertexArray = listToVertexArray (vertexList, vertex_counter+1);
+	//  real vertices and faces to start from index 1.
+	vertexArray = (vertexPtr) xmalloc (sizeof (vertexStruct) * (vertex_counter+1));
+	faceArray = (facePtr) xmalloc (sizeof (faceStruct) * (face_counter+1));
+	memset (&vertexArray[0], 0, sizeof (vertexStruct));
+	memset (&faceArray[0], 0, sizeof (faceStruct));
 
-	// Obtain the normals for each individual vertex.
-	normalArray = normalsFromVertices (vertexArray, faceList, vertex_counter);
+	for (i=0; i<numChunks; i++)
+	{
+		chunks[i].vertexArray = vertexArray;
+		chunks[i].faceArray = faceArray;
+	}
 
-	// Convert the list of faces into an array.
-	// The array will have 'numFaces'+1 elements.
-	// The element at index 0 is blank, allowing the
-	//  real faces to start from index 1.
-	faceArray = listToFaceArray (faceList, face_counter+1);
+	runInThreads (parseChunk, chunks, sizeof (objChunkStruct), numChunks);
 
-	// Copy the data just read into the object structure
-	objectData.numVertices = vertex_counter;
-	objectData.numFaces = face_counter;
-	objectData.numEdges = 0;
-	objectData.vertexArray = vertexArray;
-	objectData.displayVertexArray = NULL;
-	objectData.normalArray = normalArray;
-	objectData.faceArray = faceArray;
-	objectData.edgeList = NULL;
-	objectData.vertexFaceArray = vertexFaceArray;
-	objectData.facesPerVertex = facesPerVertex;
-	objectData.surfaceArea = object_surface_area (faceArray, face_counter, vertexArray);
+	free (chunks);
 
+	// Validate the indices before using them.
+	for (i=1; i<=face_counter; i++)
+		for (j=0; j<faceArray[i].faceVertices; j++)
+			if (faceArray[i].vertex[j] < 1 || faceArray[i].vertex[j] > vertex_counter)
+			{
+				printf ("Error reading obj file '%s': face %d with an invalid vertex index.\n", filename, i);
+				free (vertexArray);
+				free (faceArray);
+				return (FALSE);
+			}
 
-	freeList (vertexList);
-	freeList (faceList);
+	*objectData = buildObjectData (vertexArray, vertex_counter, faceArray, face_counter);
 
-	return (objectData);
+	return (TRUE);
 }
 
 
-// Create a new vertex structure with the information from
-//  the .obj file.
-vertexPtr readVertex (FILE* OBJ_FD)
+// Count the number of vertex and face definitions
+//  in a block of obj data.
+void countObjRecords (char* data, char* end, int* numVertices, int* numFaces)
 {
-	double		x;
-	double		y;
-	double		z;
-	vertexPtr	newVertex = NULL;
+	char*		cursor = data;
+	int			vertex_counter = 0;
+	int			face_counter = 0;
+
+	while (cursor < end)
+	{
+		switch (lineType (cursor, end))
+		{
+			case VERTEX_LINE:
+				vertex_counter++;
+				break;
+			case FACE_LINE:
+				face_counter++;
+				break;
+			default:
+				break;
+		}
 
-	fscanf (OBJ_FD, "%lf %lf %lf", &x, &y, &z);
+		cursor = skipLine (cursor, end);
+	}
 
-	newVertex = (vertexPtr) xmalloc (sizeof(vertexStruct));
+	*numVertices = vertex_counter;
+	*numFaces = face_counter;
+}
 
-	newVertex->x = x;
-	newVertex->y = y;
-	newVertex->z = z;
-	newVertex->extra = 0;
 
-	// Discard the rest of the line.
-	fgets(string, 100, OBJ_FD);
+// Read the vertex and face definitions in a block of
+//  obj data into arrays allocated by the caller.
+// The arrays are filled beginning with index 'vertexOffset'+1
+//  and 'faceOffset'+1, which are the number of definitions
+//  found before the block.
+// Texture vertices, normals and any other definitions
+//  are ignored.
+void parseObjRecords (char* data, char* end, vertexPtr vertexArray, facePtr faceArray, int vertexOffset, int faceOffset)
+{
+	char*		cursor = data;
+	vertexPtr	vertex = NULL;
+	facePtr		face = NULL;
+	int			vertex_counter = vertexOffset;
+	int			face_counter = faceOffset;
+	double		coordinates[3];
+
+	while (cursor < end)
+	{
+		switch (lineType (cursor, end))
+		{
+			case VERTEX_LINE:	// A vertex definition
+				cursor = skipBlanks (cursor, end) + 1;
+				vertex_counter++;
+				vertex = &vertexArray[vertex_counter];
+				vertex->vertexId = vertex_counter;
+				cursor = scanDouble (cursor, end, &coordinates[0]);
+				cursor = scanDouble (cursor, end, &coordinates[1]);
+				cursor = scanDouble (cursor, end, &coordinates[2]);
+				vertex->x = coordinates[0];
+				vertex->y = coordinates[1];
+				vertex->z = coordinates[2];
+				vertex->extra = 0;
+				break;
+			case FACE_LINE:		// A face definition
+				cursor = skipBlanks (cursor, end) + 1;
+				face_counter++;
+				face = &faceArray[face_counter];
+				face->faceId = face_counter;
+				cursor = readFace (cursor, end, face);
+				break;
+			default:			// Any other case
+				break;
+		}
 
-	return (newVertex);
+		// Discard the rest of the line
+		cursor = skipLine (cursor, end);
+	}
 }
 
 
-// Create a new face structure with the information from
-//  the .obj file.
-facePtr readFace (FILE* OBJ_FD, boolean textured, boolean normals)
+// Fill a face structure with the information from
+//  a face definition in the .obj data.
+// The vertices may be given as 'v', 'v/t', 'v/t/n' or 'v//n'.
+// Only the vertex indices are kept.
+// Returns a pointer to the character after the last vertex read.
+char* readFace (char* cursor, char* end, facePtr face)
 {
-	int			vertex[3];
-	int			texture[3];
-	int			normal[3];
 	int			i;
-	char		nextChar;
-	facePtr		new_face = NULL;
-
-	new_face = (facePtr) xmalloc (sizeof(faceStruct));
+	int			index;
+	char*		next;
 
-	new_face->faceVertices = 3;
+	face->faceVertices = 0;
+	face->faceNormal = NULL;
+	// Triangles have no fourth vertex.
+	for (i=0; i<4; i++)
+		face->vertex[i] = -1;
 
-	for (i=0; i<3; i++)
+	// Read up to four vertices.
+	for (i=0; i<4; i++)
 	{
-		fscanf (OBJ_FD, "%d", &vertex[i]);
-		if (textured)
+		next = scanInteger (cursor, end, &index);
+		// No more vertices in this line.
+		if (next == cursor)
+			break;
+		cursor = next;
+
+		face->vertex[i] = index;
+		face->faceVertices++;
+
+		// Skip the texture and normal indices.
+		while ( (cursor < end) && (*cursor == '/') )
 		{
-			fscanf (OBJ_FD, "/%d", &texture[i]);
-			if (normals)
-				fscanf (OBJ_FD, "/%d", &normal[i]);
+			cursor++;
+			cursor = scanInteger (cursor, end, &index);
 		}
-		else if (normals)
-			fscanf (OBJ_FD, "//%d", &normal[i]);
-
-		new_face->vertex[i] = vertex[i];
 	}
 
-	new_face->vertex[3] = -1;
+	return (cursor);
+}
 
-	// Check to see if there is a fourth vertex in the face.
-	nextChar = getc (OBJ_FD);
 
-	// If the next character is different from:
-	//  ASCII 10 = LF (line feed)
-	//  ASCII 13 = CR (carriage return)
-	if ( (nextChar != 10) && (nextChar != 13) )
-	{
-		new_face->faceVertices = 4;
+// Add a polygon, given by the indices of its vertices, at the
+//  end of an array of faces that grows as needed.
+// The array is indexed beginning with 1, and 'capacity' is the
+//  number of faces it can hold.
+// Triangles and quadrilaterals are kept as they are, while
+//  larger polygons are split into a fan of triangles.
+// Polygons with less than 3 vertices are ignored.
+// Returns the array, which may have been moved.
+facePtr addPolygonToFaceArray (facePtr faceArray, int* numFaces, int* capacity, int* indices, int numIndices)
+{
+	int			i;
+	int			numTriangles;
+	facePtr		face = NULL;
+
+	if (numIndices < 3)
+		return (faceArray);
 
-		fscanf (OBJ_FD, "%d", &vertex[i]);
-		if (textured)
+	numTriangles = (numIndices > 4) ? numIndices - 2 : 1;
+
+	for (i=0; i<numTriangles; i++)
+	{
+		*numFaces += 1;
+		if (*numFaces > *capacity)
 		{
-			fscanf (OBJ_FD, "/%d", &texture[i]);
-			if (normals)
-				fscanf (OBJ_FD, "/%d", &normal[i]);
+			*capacity = *capacity * 2 + 1;
+			faceArray = (facePtr) realloc (faceArray, sizeof (faceStruct) * (*capacity + 1));
+			if (faceArray == NULL)
+			{
+				printf ("Unable to allocate memory. Exiting.\n");
+				exit (1);
+			}
 		}
-		else if (normals)
-			fscanf (OBJ_FD, "//%d", &normal[i]);
 
-		// Se the fourth vertex. (i = 3)
-		new_face->vertex[i] = vertex[i];
-
-		// Discard the rest of the line.
-		fgets(string, 100, OBJ_FD);
+		face = &faceArray[*numFaces];
+		face->faceId = *numFaces;
+		face->faceNormal = NULL;
+		if (numIndices > 4)
+		{
+			face->faceVertices = 3;
+			face->vertex[0] = indices[0];
+			face->vertex[1] = indices[i+1];
+			face->vertex[2] = indices[i+2];
+			face->vertex[3] = -1;
+		}
+		else
+		{
+			face->faceVertices = numIndices;
+			face->vertex[0] = indices[0];
+			face->vertex[1] = indices[1];
+			face->vertex[2] = indices[2];
+			face->vertex[3] = (numIndices == 4) ? indices[3] : -1;
+		}
 	}
 
-	return (new_face);
+	return (faceArray);
 }
 
 
-// Add a new face to the array of faces per vertex.
-// The 'faceId' will be inserted in the lists corresponding
-//  to each of the vertices that compose the face.
-nodePtr* addFaceToVertexFaceArray (nodePtr* vertexFaceArray, facePtr face, int numVertices, int* facesPerVertex)
+// Complete an object structure from the arrays of vertices
+//  and faces, computing the normals, the surface area and
+//  the faces around each vertex.
+// Both arrays must be indexed beginning with 1.
+objectStruct buildObjectData (vertexPtr vertexArray, int numVertices, facePtr faceArray, int numFaces)
 {
-	int			i;
-	int			currentVertex;
-	int*		index;
-	nodePtr		tmpList = NULL;
+	vertexPtr			normalArray = NULL;
+	objectStruct		objectData;
+	meshStorageStruct	storage;
+
+	// Compute the normals and areas of the faces,
+	//  and the normals for each individual vertex.
+	storage = new_mesh_storage (vertexArray, numVertices, faceArray, numFaces);
+	mesh_face_normals (&storage);
+	mesh_face_areas (&storage);
+	store_mesh_face_normals (&storage, faceArray);
+	normalArray = mesh_vertex_normals (&storage);
 
-	// For each of the vertices delimiting this face.
-	for (i=0; i<face->faceVertices; i++)
-	{
-		currentVertex = face->vertex[i];
-		// Get the list for the current vertex.
-		tmpList = vertexFaceArray[currentVertex];
-		// Copy the faceId to a new int.
-		index = (int*) xmalloc (sizeof (int));
-		memcpy (index, &(face->faceId), sizeof (int));
-		// Insert the pointer into the list.
-		tmpList = addFrontNode (tmpList, index);
-		vertexFaceArray[currentVertex] = tmpList;
-
-		// Increment the number of adjacent faces
-		//  to the corresponding vertices.
-		facesPerVertex[currentVertex] += 1;
-	}
+	// Copy the data just read into the object structure
+	objectData.numVertices = numVertices;
+	objectData.numFaces = numFaces;
+	objectData.numNormals = 0;
+	objectData.numEdges = 0;
+	objectData.vertexArray = vertexArray;
+	objectData.displayVertexArray = NULL;
+	objectData.normalArray = normalArray;
+	objectData.faceArray = faceArray;
+	objectData.edgeList = NULL;
+	objectData.surfaceArea = mesh_surface_area (&storage);
 
-	return (vertexFaceArray);
+	free_mesh_storage (&storage);
+
+	// Store the faces around each vertex, in CCW order.
+	build_vertex_face_adjacency (&objectData);
+
+	return (objectData);
 }
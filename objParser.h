@@ -1,16 +1,34 @@
 // Parse an obj file and create lists with the vertices
 //  and faces.
+// The program is stopped if the file can not be read.
 objectStruct readObjFile (char* filename);
 
-// Create a new vertex structure with the information from
-//  the .obj file.
-vertexPtr readVertex (FILE* OBJ_FD);
+// Parse an obj file into an object structure.
+// Returns FALSE, with a message, if the file can not be read
+//  or is not valid.
+boolean read_obj_file (char* filename, objectPtr object_data);
 
-// Create a new face structure with the information from
-//  the .obj file.
-facePtr readFace (FILE* OBJ_FD, boolean textured, boolean normals);
+// Parse the contents of an obj file, already stored in memory.
+// Returns FALSE, with a message, if the data is not valid.
+boolean readObjBuffer (char* data, size_t length, char* filename, objectPtr objectData);
 
-// Add a new face to the array of faces per vertex.
-// The 'faceId' will be inserted in the lists corresponding
-//  to each of the vertices that compose the face.
-nodePtr* addFaceToVertexFaceArray (nodePtr* vertexFaceArray, facePtr face, int numVertices, int* facesPerVertex);
+// Count the number of vertex and face definitions
+//  in a block of obj data.
+void countObjRecords (char* data, char* end, int* numVertices, int* numFaces);
+
+// Read the vertex and face definitions in a block of
+//  obj data into arrays allocated by the caller.
+void parseObjRecords (char* data, char* end, vertexPtr vertexArray, facePtr faceArray, int vertexOffset, int faceOffset);
+
+// Fill a face structure with the information from
+//  a face definition in the .obj data.
+char* readFace (char* cursor, char* end, facePtr face);
+
+// Add a polygon, given by the indices of its vertices, at the
+//  end of an array of faces that grows as needed.
+facePtr addPolygonToFaceArray (facePtr faceArray, int* numFaces, int* capacity, int* indices, int numIndices);
+
+// Complete an object structure from the arrays of vertices
+//  and faces, computing the normals, the surface area and
+//  the faces around each vertex.
+objectStruct buildObjectData (vertexPtr vertexArray, int numVertices, facePtr faceArray, int numFaces);
@@ -4,49 +4,98 @@
 #include "geometry.h"
 #include "faces.h"
 #include "object3D.h"
+#include "meshWriter.h"
 #include "objWriter.h"
 
+// Largest number of characters in a line of the file.
+#define OBJ_MAX_LINE	128
+
+
+// Write the line for a vertex.
+// Deleted vertices are skipped.
+static int format_obj_vertex (char* buffer, int index, void* data)
+{
+	meshWriterDataPtr	writer_data = (meshWriterDataPtr) data;
+	vertexPtr			vertex = &writer_data->object_data->vertexArray[index];
+	int					length = 0;
+
+	if (vertex->vertexId < 0)
+		return (0);
+
+	buffer[length++] = 'v';
+	buffer[length++] = ' ';
+	length += formatDouble (buffer + length, vertex->x);
+	buffer[length++] = ' ';
+	length += formatDouble (buffer + length, vertex->y);
+	buffer[length++] = ' ';
+	length += formatDouble (buffer + length, vertex->z);
+	buffer[length++] = '\n';
+
+	return (length);
+}
+
+
+// Write the line for a face, with the new indices of its vertices.
+// Deleted faces are skipped.
+static int format_obj_face (char* buffer, int index, void* data)
+{
+	meshWriterDataPtr	writer_data = (meshWriterDataPtr) data;
+	facePtr				face = &writer_data->object_data->faceArray[index];
+	int					length = 0;
+	int					i;
+
+	if (face->faceId < 0)
+		return (0);
+
+	buffer[length++] = 'f';
+	for (i=0; i<face->faceVertices; i++)
+	{
+		buffer[length++] = ' ';
+		length += formatInteger (buffer + length, writer_data->vertex_remap[face->vertex[i]]);
+	}
+	buffer[length++] = '\n';
+
+	return (length);
+}
+
+
 // Output the contents of an objectStruct
 //  into an obj file.
+// The vertices and faces that were deleted (with negative ids)
+//  are not written, and the vertices are numbered again.
 void write_obj_file (objectStruct object_data, char* filename)
 {
-	FILE*			OBJ_FD = NULL;
-	int				num_vertices;
-	int				num_faces;
-	int				i;
-	time_t			start;
-	time_t			stop;
-	vertexStruct	vertex;
-	faceStruct		face;
+	FILE*					OBJ_FD = NULL;
+	int						num_vertices;
+	int						num_faces;
+	int						total;
+	time_t					start;
+	time_t					stop;
+	meshWriterDataStruct	writer_data;
 
 	printf ("\n[EXTRA STAGE] -- WRITING OBJ FILE: %s\n", filename); fflush (stdout);
 	(void) time (&start);
 
-	num_vertices = object_data.numVertices;
-	num_faces = object_data.numFaces;
+	writer_data.object_data = &object_data;
+	writer_data.vertex_remap = build_vertex_remap (object_data, &num_vertices);
+	num_faces = count_valid_faces (object_data);
+	total = object_data.numVertices + object_data.numFaces;
 
 	OBJ_FD = xfopen (filename, "w");
+	setvbuf (OBJ_FD, NULL, _IOFBF, 1 << 20);
 
 	//Write the coordinates for the vertices.
 	fprintf (OBJ_FD, "# %d vertices\n", num_vertices);
-	for (i=1; i<=num_vertices; i++)
-	{
-		vertex = object_data.vertexArray[i];
-		fprintf (OBJ_FD, "v %lf %lf %lf\n", vertex.x, vertex.y, vertex.z);
-		printProgressStar (i, num_vertices + num_faces);
-	}
+	write_records (OBJ_FD, format_obj_vertex, &writer_data, 1, object_data.numVertices, OBJ_MAX_LINE, 0, total);
 
 	// Write the faces.
 	fprintf (OBJ_FD, "\n# %d faces\n", num_faces);
-	for (i=1; i<=num_faces; i++)
-	{
-		face = object_data.faceArray[i];
-		fprintf (OBJ_FD, "f %d %d %d\n", face.vertex[0], face.vertex[1], face.vertex[2]);
-		printProgressStar (num_vertices + i, num_vertices + num_faces);
-	}
+	write_records (OBJ_FD, format_obj_face, &writer_data, 1, object_data.numFaces, OBJ_MAX_LINE, object_data.numVertices, total);
 
 	fclose (OBJ_FD);
 
+	free (writer_data.vertex_remap);
+
 	(void) time (&stop);
 	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
 }
@@ -1,5 +1,6 @@
 // Output the contents of an objectStruct
 //  into an obj file.
+// Deleted vertices and faces are skipped.
 void write_obj_file (objectStruct object_data, char* filename);
 
 // Create a new objectStruct to contain the
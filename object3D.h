@@ -15,10 +15,18 @@ typedef struct objectStruct
 	facePtr		faceArray;
 	nodePtr		edgeList;
 
-	// Array of lists of face indexes.
-	nodePtr*	vertexFaceArray;
+	// Faces around each vertex, in CCW order.
+	// The faces of vertex 'i' begin at 'vertexFaceOffsets[i]'
+	//  in 'vertexFaceIndices'.
+	int*		vertexFaceOffsets;
+	int*		vertexFaceIndices;
+	int			vertexFaceLength;
+	int			vertexFaceCapacity;
 	// Array of integers.
 	int*		facesPerVertex;
+	// Array of lists of face indexes, only used
+	//  while the faces are modified.
+	nodePtr*	vertexFaceArray;
 
 	double		surfaceArea;
 } objectStruct;
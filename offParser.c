@@ -0,0 +1,242 @@
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "object3D.h"
+#include "objParser.h"
+#include "offParser.h"
+
+// Report a problem in the file.
+// Returns NULL, to be returned in turn by the function
+//  that found the problem.
+static char* offError (char* filename, char* message)
+{
+	printf ("Error reading off file '%s': %s.\n", filename, message);
+
+	return (NULL);
+}
+
+
+// Advance to the first character of the next line with data,
+//  skipping empty lines and comments.
+static char* nextDataLine (char* cursor, char* end)
+{
+	while (cursor < end)
+	{
+		cursor = skipBlanks (cursor, end);
+
+		if ( (cursor < end) && (*cursor != '\n') && (*cursor != '#') )
+			break;
+
+		cursor = skipLine (cursor, end);
+	}
+
+	return (cursor);
+}
+
+
+// Read the keyword that begins the file, if present, and the
+//  number of vertices and faces.
+// The keyword may have prefixes for colours, normals or texture
+//  coordinates ('COFF', 'NOFF', 'STOFF'...), which are ignored.
+// The counts may appear in the same line as the keyword.
+// Returns a pointer to the line after the counts, or NULL if
+//  the header is not valid.
+static char* readOffHeader (char* cursor, char* end, char* filename, int* numVertices, int* numFaces)
+{
+	char*		keyword;
+	int			numEdges;
+
+	cursor = nextDataLine (cursor, end);
+
+	keyword = cursor;
+	while ( (cursor < end) && ( (*cursor >= 'A' && *cursor <= 'Z') || (*cursor >= 'a' && *cursor <= 'z') ) )
+		cursor++;
+
+	if (cursor != keyword)
+	{
+		if ( (cursor - keyword < 3) || strncmp (cursor - 3, "OFF", 3) )
+			return (offError (filename, "not an off file"));
+
+		cursor = skipBlanks (cursor, end);
+		if ( (end - cursor >= 6) && !strncmp (cursor, "BINARY", 6) )
+			return (offError (filename, "binary off files are not supported"));
+
+		cursor = nextDataLine (cursor, end);
+	}
+
+	keyword = cursor;
+	cursor = scanInteger (cursor, end, numVertices);
+	if (cursor == keyword)
+		return (offError (filename, "missing number of vertices"));
+
+	keyword = cursor;
+	cursor = scanInteger (cursor, end, numFaces);
+	if (cursor == keyword)
+		return (offError (filename, "missing number of faces"));
+
+	// The number of edges is optional, and not used.
+	cursor = scanInteger (cursor, end, &numEdges);
+
+	if (*numVertices < 0 || *numFaces < 0)
+		return (offError (filename, "invalid number of elements"));
+
+	return (skipLine (cursor, end));
+}
+
+
+// Parse an off file and create the arrays with the vertices
+//  and faces.
+// The program is stopped if the file can not be read.
+objectStruct readOffFile (char* filename)
+{
+	objectStruct	objectData;
+
+	if (!read_off_file (filename, &objectData))
+	{
+		printf ("Exiting.\n");
+		exit (1);
+	}
+
+	return (objectData);
+}
+
+
+// Parse an off file into an object structure.
+// The file is loaded with 'loadFile', so '.off.gz' files
+//  and pipes are accepted too.
+// Returns FALSE, with a message, if the file can not be read
+//  or is not valid.
+boolean read_off_file (char* filename, objectPtr object_data)
+{
+	char*			data = NULL;
+	size_t			length;
+	boolean			success;
+
+	if (!loadFile (filename, &data, &length))
+		return (FALSE);
+
+	success = readOffBuffer (data, length, filename, object_data);
+
+	xunloadfile (filename, data, length);
+
+	return (success);
+}
+
+
+// Parse the contents of an off file, already stored in memory.
+// Since the header gives the number of vertices and faces, the
+//  arrays are allocated once and filled in a single pass.
+// As with obj files, faces may be triangles or quadrilaterals.
+// Larger polygons are split into a fan of triangles.
+// Any colour or other data after the coordinates or indices is
+//  ignored.
+// The vertex indices in the file start with 0, and are
+//  changed to start with 1, as used in the objectStruct.
+// Returns FALSE, with a message, if the data is not valid.
+boolean readOffBuffer (char* data, size_t length, char* filename, objectPtr objectData)
+{
+	char*		cursor = data;
+	char*		end = data + length;
+	char*		start;
+	int			i;
+	int			j;
+	int			numVertices;
+	int			numFaces;
+	int			numIndices;
+	int			maxIndices = 8;
+	int			faceCounter = 0;
+	int			faceCapacity;
+	int*		indices = NULL;
+	double		coordinates[3];
+	vertexPtr	vertexArray = NULL;
+	facePtr		faceArray = NULL;
+
+	cursor = readOffHeader (cursor, end, filename, &numVertices, &numFaces);
+	if (cursor == NULL)
+		return (FALSE);
+
+	// The arrays begin with index 1.
+	vertexArray = (vertexPtr) xmalloc (sizeof (vertexStruct) * (numVertices + 1));
+	faceCapacity = numFaces;
+	faceArray = (facePtr) xmalloc (sizeof (faceStruct) * (faceCapacity + 1));
+	indices = (int*) xmalloc (sizeof (int) * maxIndices);
+
+	// The reading stops at the first error, leaving the cursor
+	//  as NULL.
+	for (i=1; (i<=numVertices) && (cursor != NULL); i++)
+	{
+		cursor = nextDataLine (cursor, end);
+
+		for (j=0; (j<3) && (cursor != NULL); j++)
+		{
+			start = cursor;
+			cursor = scanDouble (cursor, end, &coordinates[j]);
+			if (cursor == start)
+				cursor = offError (filename, "invalid vertex coordinates");
+		}
+		if (cursor == NULL)
+			break;
+
+		vertexArray[i].vertexId = i;
+		vertexArray[i].x = coordinates[0];
+		vertexArray[i].y = coordinates[1];
+		vertexArray[i].z = coordinates[2];
+		vertexArray[i].extra = 0;
+
+		cursor = skipLine (cursor, end);
+	}
+
+	for (i=1; (i<=numFaces) && (cursor != NULL); i++)
+	{
+		cursor = nextDataLine (cursor, end);
+
+		start = cursor;
+		cursor = scanInteger (cursor, end, &numIndices);
+		if (cursor == start || numIndices < 0)
+		{
+			cursor = offError (filename, "invalid face");
+			break;
+		}
+
+		if (numIndices > maxIndices)
+		{
+			free (indices);
+			maxIndices = numIndices;
+			indices = (int*) xmalloc (sizeof (int) * maxIndices);
+		}
+
+		for (j=0; (j<numIndices) && (cursor != NULL); j++)
+		{
+			start = cursor;
+			cursor = scanInteger (cursor, end, &indices[j]);
+			if (cursor == start)
+				cursor = offError (filename, "missing face vertex index");
+
+			// The indices in the file start with 0.
+			indices[j]++;
+			if ( (cursor != NULL) && (indices[j] < 1 || indices[j] > numVertices) )
+				cursor = offError (filename, "face with an invalid vertex index");
+		}
+		if (cursor == NULL)
+			break;
+
+		faceArray = addPolygonToFaceArray (faceArray, &faceCounter, &faceCapacity, indices, numIndices);
+
+		cursor = skipLine (cursor, end);
+	}
+
+	free (indices);
+
+	if (cursor == NULL)
+	{
+		free (vertexArray);
+		free (faceArray);
+		return (FALSE);
+	}
+
+	*objectData = buildObjectData (vertexArray, numVertices, faceArray, faceCounter);
+
+	return (TRUE);
+}
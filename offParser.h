@@ -0,0 +1,14 @@
+// Parse an off file and create the arrays with the vertices
+//  and faces.
+// Only the ascii version of the format is accepted.
+// The program is stopped if the file can not be read.
+objectStruct readOffFile (char* filename);
+
+// Parse an off file into an object structure.
+// Returns FALSE, with a message, if the file can not be read
+//  or is not valid.
+boolean read_off_file (char* filename, objectPtr object_data);
+
+// Parse the contents of an off file, already stored in memory.
+// Returns FALSE, with a message, if the data is not valid.
+boolean readOffBuffer (char* data, size_t length, char* filename, objectPtr objectData);
@@ -4,54 +4,100 @@
 #include "geometry.h"
 #include "faces.h"
 #include "object3D.h"
+#include "meshWriter.h"
 #include "offWriter.h"
 
+// Largest number of characters in a line of the file.
+#define OFF_MAX_LINE	128
+
+
+// Write the line for a vertex.
+// Deleted vertices are skipped.
+static int format_off_vertex (char* buffer, int index, void* data)
+{
+	meshWriterDataPtr	writer_data = (meshWriterDataPtr) data;
+	vertexPtr			vertex = &writer_data->object_data->vertexArray[index];
+	int					length = 0;
+
+	if (vertex->vertexId < 0)
+		return (0);
+
+	length += formatDouble (buffer + length, vertex->x);
+	buffer[length++] = '\t';
+	length += formatDouble (buffer + length, vertex->y);
+	buffer[length++] = '\t';
+	length += formatDouble (buffer + length, vertex->z);
+	buffer[length++] = '\n';
+
+	return (length);
+}
+
+
+// Write the line for a face, with the new indices of its vertices.
+// Deleted faces are skipped.
+static int format_off_face (char* buffer, int index, void* data)
+{
+	meshWriterDataPtr	writer_data = (meshWriterDataPtr) data;
+	facePtr				face = &writer_data->object_data->faceArray[index];
+	int					length = 0;
+	int					i;
+
+	if (face->faceId < 0)
+		return (0);
+
+	length += formatInteger (buffer + length, face->faceVertices);
+	// Substract 1 from the indexes of the vertices,
+	//  since Geomview indexes them from 0.
+	for (i=0; i<face->faceVertices; i++)
+	{
+		buffer[length++] = '\t';
+		length += formatInteger (buffer + length, writer_data->vertex_remap[face->vertex[i]] - 1);
+	}
+	buffer[length++] = '\n';
+
+	return (length);
+}
+
+
 // Output the contents of an objectStruct
 //  into an off file (Geomview).
+// The vertices and faces that were deleted (with negative ids)
+//  are not written, and the vertices are numbered again.
 void write_off_file (objectStruct object_data, char* filename)
 {
-	FILE*           OFF_FD = NULL;
-	int             num_vertices;
-	int             num_faces;
-	int             i;
-	time_t          start;
-	time_t          stop;
-	vertexStruct    vertex;
-	faceStruct      face;
+	FILE*					OFF_FD = NULL;
+	int						num_vertices;
+	int						num_faces;
+	int						total;
+	time_t					start;
+	time_t					stop;
+	meshWriterDataStruct	writer_data;
 
 	printf ("\n[EXTRA STAGE] -- WRITING OFF FILE: %s\n", filename); fflush (stdout);
 	(void) time (&start);
 
-	num_vertices = object_data.numVertices;
-	num_faces = object_data.numFaces;
+	writer_data.object_data = &object_data;
+	writer_data.vertex_remap = build_vertex_remap (object_data, &num_vertices);
+	num_faces = count_valid_faces (object_data);
+	total = object_data.numVertices + object_data.numFaces;
 
 	OFF_FD = xfopen (filename, "w");
+	setvbuf (OFF_FD, NULL, _IOFBF, 1 << 20);
 
 	// Write the OFF file header.
 	fprintf (OFF_FD, "    OFF\n");
 	fprintf (OFF_FD, "%d %d %d\n", num_vertices, num_faces, 0);
 
 	//Write the coordinates for the vertices.
-	for (i=1; i<=num_vertices; i++)
-	{
-		vertex = object_data.vertexArray[i];
-		fprintf (OFF_FD, "%lf\t%lf\t%lf\n", vertex.x, vertex.y, vertex.z);
-		printProgressStar (i, num_vertices + num_faces);
-
-	}
+	write_records (OFF_FD, format_off_vertex, &writer_data, 1, object_data.numVertices, OFF_MAX_LINE, 0, total);
 
 	// Write the faces.
-	for (i=1; i<=num_faces; i++)
-	{
-		face = object_data.faceArray[i];
-		// Substract 1 from the indexes of the vertices,
-		//  since Geomview indexes them from 0.
-		fprintf (OFF_FD, "%d\t%d\t%d\t%d\n", face.faceVertices, face.vertex[0]-1, face.vertex[1]-1, face.vertex[2]-1);
-		printProgressStar (num_vertices + i, num_vertices + num_faces);
-	}
+	write_records (OFF_FD, format_off_face, &writer_data, 1, object_data.numFaces, OFF_MAX_LINE, object_data.numVertices, total);
 
 	fclose (OFF_FD);
 
+	free (writer_data.vertex_remap);
+
 	(void) time (&stop);
 	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
 }
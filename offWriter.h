@@ -1,3 +1,4 @@
 // Output the contents of an objectStruct
 //  into an off file (Geomview).
+// Deleted vertices and faces are skipped.
 void write_off_file (objectStruct object_data, char* filename);
@@ -7,6 +7,7 @@
 #include "geometry.h"
 #include "faces.h"
 #include "object3D.h"
+#include "adjacency.h"
 #include "vertexGeometry.h"
 #include "pathFinder.h"
 
@@ -26,7 +27,6 @@ nodePtr find_short_path (objectStruct ObjectData, vertexDataPtr VertexDataArray,
 	int				current_index;
 	int				close_index;
 	int				close_region_index;
-	int*			face_index;
 	int*			vertex_index = NULL;
 	faceStruct		face;
 	vertexStruct	start_vertex;
@@ -62,11 +62,8 @@ nodePtr find_short_path (objectStruct ObjectData, vertexDataPtr VertexDataArray,
 		// For each of the neighbours around the current vertex
 		for (i=0; i<ObjectData.facesPerVertex[current_index]; i++)
 		{
-			// Get the index of one of the faces.
-			face_index = (int*) getNodeData (ObjectData.vertexFaceArray[current_index], i);
-
-			// Get the face itself.
-			face = ObjectData.faceArray[*face_index];
+			// Get one of the faces.
+			face = ObjectData.faceArray[ get_vertex_face_indices (&ObjectData, current_index)[i] ];
 			reorderFace (&face, current_index);
 
 			// Get the vertex appearing as the second vertex of the face.
@@ -0,0 +1,539 @@
+#include "tools.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "faces.h"
+#include "object3D.h"
+#include "objParser.h"
+#include "plyParser.h"
+
+#define PLY_NAME_LENGTH		64
+#define PLY_MAX_PROPERTIES	32
+#define PLY_MAX_ELEMENTS	16
+
+typedef enum {PLY_ASCII, PLY_BINARY_LITTLE_ENDIAN, PLY_BINARY_BIG_ENDIAN}	plyFormat;
+
+typedef enum {PLY_CHAR, PLY_UCHAR, PLY_SHORT, PLY_USHORT, PLY_INT, PLY_UINT, PLY_FLOAT, PLY_DOUBLE, PLY_INVALID}	plyType;
+
+// A property of an element, as declared in the header.
+typedef struct
+{
+	char		name[PLY_NAME_LENGTH];
+	plyType		type;
+	boolean		list;
+	plyType		countType;
+} plyPropertyStruct;
+
+// An element declared in the header, with its properties.
+typedef struct
+{
+	char				name[PLY_NAME_LENGTH];
+	int					count;
+	int					numProperties;
+	plyPropertyStruct	properties[PLY_MAX_PROPERTIES];
+} plyElementStruct;
+
+// The information in the header of a ply file.
+typedef struct
+{
+	plyFormat			format;
+	boolean				swap;
+	int					numElements;
+	plyElementStruct	elements[PLY_MAX_ELEMENTS];
+	char*				filename;
+} plyHeaderStruct;
+
+typedef plyHeaderStruct* plyHeaderPtr;
+
+
+// Print an error about the ply file being read.
+// Returns NULL, to be returned in turn by the function
+//  that found the error.
+static char* plyError (plyHeaderPtr header, char* message)
+{
+	printf ("Error reading ply file '%s': %s.\n", header->filename, message);
+
+	return (NULL);
+}
+
+
+// Get the type corresponding to the name used in the header.
+static plyType plyTypeFromName (char* name)
+{
+	if (!strcmp (name, "char") || !strcmp (name, "int8"))
+		return (PLY_CHAR);
+	if (!strcmp (name, "uchar") || !strcmp (name, "uint8"))
+		return (PLY_UCHAR);
+	if (!strcmp (name, "short") || !strcmp (name, "int16"))
+		return (PLY_SHORT);
+	if (!strcmp (name, "ushort") || !strcmp (name, "uint16"))
+		return (PLY_USHORT);
+	if (!strcmp (name, "int") || !strcmp (name, "int32"))
+		return (PLY_INT);
+	if (!strcmp (name, "uint") || !strcmp (name, "uint32"))
+		return (PLY_UINT);
+	if (!strcmp (name, "float") || !strcmp (name, "float32"))
+		return (PLY_FLOAT);
+	if (!strcmp (name, "double") || !strcmp (name, "float64"))
+		return (PLY_DOUBLE);
+
+	return (PLY_INVALID);
+}
+
+
+// Number of bytes used by a type in the binary formats.
+static int plyTypeSize (plyType type)
+{
+	switch (type)
+	{
+		case PLY_CHAR:
+		case PLY_UCHAR:
+			return (1);
+		case PLY_SHORT:
+		case PLY_USHORT:
+			return (2);
+		case PLY_INT:
+		case PLY_UINT:
+		case PLY_FLOAT:
+			return (4);
+		case PLY_DOUBLE:
+			return (8);
+		default:
+			return (0);
+	}
+}
+
+
+// Read the header of a ply file, up to the 'end_header' line.
+// Returns a pointer to the beginning of the data,
+//  or NULL if the header is not valid.
+static char* readPlyHeader (char* data, char* end, plyHeaderPtr header)
+{
+	char				line[256];
+	char				keyword[PLY_NAME_LENGTH];
+	char				word1[PLY_NAME_LENGTH];
+	char				word2[PLY_NAME_LENGTH];
+	char				word3[PLY_NAME_LENGTH];
+	char*				cursor = data;
+	char*				next;
+	size_t				length;
+	int					count;
+	unsigned short		one = 1;
+	boolean				little_endian_host = (*(unsigned char*) &one == 1);
+	boolean				format_found = FALSE;
+	plyElementStruct*	element = NULL;
+	plyPropertyStruct*	property = NULL;
+
+	header->numElements = 0;
+
+	if ( (end - cursor < 3) || strncmp (cursor, "ply", 3) )
+		return (plyError (header, "not a ply file"));
+
+	cursor = skipLine (cursor, end);
+
+	while (cursor < end)
+	{
+		next = skipLine (cursor, end);
+
+		// Copy the line, to read it as a string.
+		length = next - cursor;
+		if (length > sizeof (line) - 1)
+			length = sizeof (line) - 1;
+		memcpy (line, cursor, length);
+		line[length] = '\0';
+
+		cursor = next;
+
+		if (sscanf (line, "%63s", keyword) != 1)
+			continue;
+
+		if (!strcmp (keyword, "end_header"))
+		{
+			if (!format_found)
+				return (plyError (header, "missing format line"));
+			return (cursor);
+		}
+		else if (!strcmp (keyword, "format"))
+		{
+			if (sscanf (line, "%*s %63s", word1) != 1)
+				return (plyError (header, "invalid format line"));
+
+			if (!strcmp (word1, "ascii"))
+				header->format = PLY_ASCII;
+			else if (!strcmp (word1, "binary_little_endian"))
+				header->format = PLY_BINARY_LITTLE_ENDIAN;
+			else if (!strcmp (word1, "binary_big_endian"))
+				header->format = PLY_BINARY_BIG_ENDIAN;
+			else
+				return (plyError (header, "unknown format"));
+
+			header->swap = (header->format == PLY_BINARY_LITTLE_ENDIAN && !little_endian_host) ||
+						   (header->format == PLY_BINARY_BIG_ENDIAN && little_endian_host);
+			format_found = TRUE;
+		}
+		else if (!strcmp (keyword, "element"))
+		{
+			if (sscanf (line, "%*s %63s %d", word1, &count) != 2 || count < 0)
+				return (plyError (header, "invalid element line"));
+			if (header->numElements == PLY_MAX_ELEMENTS)
+				return (plyError (header, "too many elements"));
+
+			element = &header->elements[header->numElements];
+			header->numElements++;
+
+			strcpy (element->name, word1);
+			element->count = count;
+			element->numProperties = 0;
+		}
+		else if (!strcmp (keyword, "property"))
+		{
+			if (element == NULL)
+				return (plyError (header, "property declared before any element"));
+			if (element->numProperties == PLY_MAX_PROPERTIES)
+				return (plyError (header, "too many properties"));
+
+			property = &element->properties[element->numProperties];
+			element->numProperties++;
+
+			if (sscanf (line, "%*s %63s", word1) != 1)
+				return (plyError (header, "invalid property line"));
+
+			if (!strcmp (word1, "list"))
+			{
+				if (sscanf (line, "%*s %*s %63s %63s %63s", word2, word3, property->name) != 3)
+					return (plyError (header, "invalid list property line"));
+				property->list = TRUE;
+				property->countType = plyTypeFromName (word2);
+				property->type = plyTypeFromName (word3);
+				if (property->countType == PLY_INVALID || property->countType == PLY_FLOAT || property->countType == PLY_DOUBLE)
+					return (plyError (header, "invalid type for a list count"));
+			}
+			else
+			{
+				if (sscanf (line, "%*s %*s %63s", property->name) != 1)
+					return (plyError (header, "invalid property line"));
+				property->list = FALSE;
+				property->type = plyTypeFromName (word1);
+			}
+
+			if (property->type == PLY_INVALID)
+				return (plyError (header, "unknown property type"));
+		}
+		// Other keywords ('comment', 'obj_info') are ignored.
+	}
+
+	return (plyError (header, "missing 'end_header'"));
+}
+
+
+// Read a single value of the given type.
+// Returns a pointer to the data following the value,
+//  or NULL if there is no valid value.
+static char* readPlyValue (char* cursor, char* end, plyHeaderPtr header, plyType type, double* value)
+{
+	unsigned char	bytes[8];
+	char*			next;
+	int				size;
+	int				i;
+
+	if (header->format == PLY_ASCII)
+	{
+		// Values may be separated by any whitespace.
+		while ( (cursor < end) && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') )
+			cursor++;
+
+		next = scanDouble (cursor, end, value);
+		if (next == cursor)
+			return (plyError (header, "invalid or missing value"));
+
+		return (next);
+	}
+
+	size = plyTypeSize (type);
+	if (end - cursor < size)
+		return (plyError (header, "unexpected end of file"));
+
+	// Copy the bytes in the order of this machine.
+	if (header->swap)
+		for (i=0; i<size; i++)
+			bytes[i] = cursor[size - 1 - i];
+	else
+		memcpy (bytes, cursor, size);
+
+	switch (type)
+	{
+		case PLY_CHAR:		{ signed char		v; memcpy (&v, bytes, 1); *value = v; break; }
+		case PLY_UCHAR:		{ unsigned char		v; memcpy (&v, bytes, 1); *value = v; break; }
+		case PLY_SHORT:		{ short				v; memcpy (&v, bytes, 2); *value = v; break; }
+		case PLY_USHORT:	{ unsigned short	v; memcpy (&v, bytes, 2); *value = v; break; }
+		case PLY_INT:		{ int				v; memcpy (&v, bytes, 4); *value = v; break; }
+		case PLY_UINT:		{ unsigned int		v; memcpy (&v, bytes, 4); *value = v; break; }
+		case PLY_FLOAT:		{ float				v; memcpy (&v, bytes, 4); *value = v; break; }
+		case PLY_DOUBLE:	{ double			v; memcpy (&v, bytes, 8); *value = v; break; }
+		default:			*value = 0; break;
+	}
+
+	return (cursor + size);
+}
+
+
+// Read all the properties of one item of an element.
+// The scalar values are stored in 'values', and the list
+//  named 'listName' is stored in 'listValues', up to
+//  'maxListValues' items.
+// Returns a pointer to the data following the item,
+//  or NULL if it is not valid.
+static char* readPlyItem (char* cursor, char* end, plyHeaderPtr header, plyElementStruct* element, double* values, char* listName, int* listValues, int maxListValues, int* listLength)
+{
+	plyPropertyStruct*	property = NULL;
+	double				value;
+	int					count;
+	int					i;
+	int					j;
+
+	*listLength = 0;
+
+	for (i=0; i<element->numProperties; i++)
+	{
+		property = &element->properties[i];
+
+		if (!property->list)
+		{
+			cursor = readPlyValue (cursor, end, header, property->type, &values[i]);
+			if (cursor == NULL)
+				return (NULL);
+			continue;
+		}
+
+		cursor = readPlyValue (cursor, end, header, property->countType, &value);
+		if (cursor == NULL)
+			return (NULL);
+		count = (int) value;
+		if (count < 0)
+			return (plyError (header, "invalid list length"));
+
+		for (j=0; j<count; j++)
+		{
+			cursor = readPlyValue (cursor, end, header, property->type, &value);
+			if (cursor == NULL)
+				return (NULL);
+			if ( (listName != NULL) && !strcmp (property->name, listName) && (j < maxListValues) )
+				listValues[j] = (int) value;
+		}
+
+		if ( (listName != NULL) && !strcmp (property->name, listName) )
+			*listLength = count;
+	}
+
+	return (cursor);
+}
+
+
+// Find the position of a property in an element.
+// Returns -1 if the element has no such property.
+static int findPlyProperty (plyElementStruct* element, char* name)
+{
+	int		i;
+
+	for (i=0; i<element->numProperties; i++)
+		if (!strcmp (element->properties[i].name, name))
+			return (i);
+
+	return (-1);
+}
+
+
+
+// Parse a ply file and create the arrays with the vertices
+//  and faces.
+// The program is stopped if the file can not be read.
+objectStruct readPlyFile (char* filename)
+{
+	objectStruct	objectData;
+
+	if (!read_ply_file (filename, &objectData))
+	{
+		printf ("Exiting.\n");
+		exit (1);
+	}
+
+	return (objectData);
+}
+
+
+// Parse a ply file into an object structure.
+// Like obj files, it may be compressed with gzip or come
+//  from the standard input.
+// Returns FALSE, with a message, if the file can not be read
+//  or is not valid.
+boolean read_ply_file (char* filename, objectPtr object_data)
+{
+	char*			data = NULL;
+	size_t			length;
+	boolean			success;
+
+	if (!loadFile (filename, &data, &length))
+		return (FALSE);
+
+	success = readPlyBuffer (data, length, filename, object_data);
+
+	xunloadfile (filename, data, length);
+
+	return (success);
+}
+
+
+// Parse the contents of a ply file, already stored in memory.
+// The vertices are read from the 'x', 'y' and 'z' properties of
+//  the 'vertex' element, and the faces from the 'vertex_indices'
+//  list of the 'face' element.
+// As with obj files, faces may be triangles or quadrilaterals.
+// Larger polygons are split into a fan of triangles.
+// The vertex indices in the file start with 0, and are
+//  changed to start with 1, as used in the objectStruct.
+// Returns FALSE, with a message, if the data is not valid.
+boolean readPlyBuffer (char* data, size_t length, char* filename, objectPtr objectData)
+{
+	plyHeaderStruct		header;
+	plyElementStruct*	element = NULL;
+	char*				end = data + length;
+	char*				cursor;
+	char*				list_name = NULL;
+	double				values[PLY_MAX_PROPERTIES];
+	int*				indices = NULL;
+	int					max_indices = 64;
+	int					num_indices;
+	int					x_index = -1;
+	int					y_index = -1;
+	int					z_index = -1;
+	int					i;
+	int					j;
+	int					k;
+	int					vertex_counter = 0;
+	int					face_counter = 0;
+	int					face_capacity = 0;
+	vertexPtr			vertexArray = NULL;
+	facePtr				faceArray = NULL;
+
+	header.filename = filename;
+
+	cursor = readPlyHeader (data, end, &header);
+	if (cursor == NULL)
+		return (FALSE);
+
+	// Allocate the arrays, with the blank element at index 0.
+	for (i=0; i<header.numElements; i++)
+	{
+		element = &header.elements[i];
+		if (!strcmp (element->name, "vertex"))
+			vertexArray = (vertexPtr) xmalloc (sizeof (vertexStruct) * (element->count + 1));
+		else if (!strcmp (element->name, "face"))
+		{
+			face_capacity = element->count;
+			faceArray = (facePtr) xmalloc (sizeof (faceStruct) * (face_capacity + 1));
+		}
+	}
+
+	if (vertexArray == NULL)
+	{
+		plyError (&header, "no vertex element");
+		free (faceArray);
+		return (FALSE);
+	}
+	if (faceArray == NULL)
+		faceArray = (facePtr) xmalloc (sizeof (faceStruct));
+
+	memset (&vertexArray[0], 0, sizeof (vertexStruct));
+	memset (&faceArray[0], 0, sizeof (faceStruct));
+
+	indices = (int*) xmalloc (sizeof (int) * max_indices);
+
+	// Read the elements in the order they appear in the file.
+	// The reading stops at the first error, leaving the cursor
+	//  as NULL.
+	for (i=0; (i<header.numElements) && (cursor != NULL); i++)
+	{
+		element = &header.elements[i];
+
+		if (!strcmp (element->name, "vertex"))
+		{
+			x_index = findPlyProperty (element, "x");
+			y_index = findPlyProperty (element, "y");
+			z_index = findPlyProperty (element, "z");
+			if (x_index < 0 || y_index < 0 || z_index < 0)
+				cursor = plyError (&header, "missing vertex coordinates");
+			else if (element->properties[x_index].list || element->properties[y_index].list || element->properties[z_index].list)
+				cursor = plyError (&header, "invalid vertex coordinates");
+
+			for (j=0; (j<element->count) && (cursor != NULL); j++)
+			{
+				cursor = readPlyItem (cursor, end, &header, element, values, NULL, NULL, 0, &num_indices);
+				if (cursor == NULL)
+					break;
+
+				vertex_counter++;
+				vertexArray[vertex_counter].vertexId = vertex_counter;
+				vertexArray[vertex_counter].x = values[x_index];
+				vertexArray[vertex_counter].y = values[y_index];
+				vertexArray[vertex_counter].z = values[z_index];
+				vertexArray[vertex_counter].extra = 0;
+			}
+		}
+		else if (!strcmp (element->name, "face"))
+		{
+			if (findPlyProperty (element, "vertex_indices") >= 0)
+				list_name = "vertex_indices";
+			else if (findPlyProperty (element, "vertex_index") >= 0)
+				list_name = "vertex_index";
+			else
+				cursor = plyError (&header, "missing face vertex indices");
+
+			for (j=0; (j<element->count) && (cursor != NULL); j++)
+			{
+				cursor = readPlyItem (cursor, end, &header, element, values, list_name, indices, max_indices, &num_indices);
+				if (cursor == NULL)
+					break;
+
+				if (num_indices > max_indices)
+				{
+					cursor = plyError (&header, "face with too many vertices");
+					break;
+				}
+
+				// The indices in the file start with 0.
+				for (k=0; k<num_indices; k++)
+					indices[k]++;
+
+				faceArray = addPolygonToFaceArray (faceArray, &face_counter, &face_capacity, indices, num_indices);
+			}
+		}
+		else
+		{
+			// Skip any other element.
+			for (j=0; (j<element->count) && (cursor != NULL); j++)
+				cursor = readPlyItem (cursor, end, &header, element, values, NULL, NULL, 0, &num_indices);
+		}
+	}
+
+	free (indices);
+
+	// Validate the indices before using them.
+	for (i=1; (i<=face_counter) && (cursor != NULL); i++)
+		for (j=0; j<faceArray[i].faceVertices; j++)
+			if (faceArray[i].vertex[j] < 1 || faceArray[i].vertex[j] > vertex_counter)
+			{
+				cursor = plyError (&header, "face with an invalid vertex index");
+				break;
+			}
+
+	if (cursor == NULL)
+	{
+		free (vertexArray);
+		free (faceArray);
+		return (FALSE);
+	}
+
+	*objectData = buildObjectData (vertexArray, vertex_counter, faceArray, face_counter);
+
+	return (TRUE);
+}
@@ -0,0 +1,15 @@
+// Parse a ply file and create the arrays with the vertices
+//  and faces.
+// Accepts the 'ascii', 'binary_little_endian' and
+//  'binary_big_endian' formats.
+// The program is stopped if the file can not be read.
+objectStruct readPlyFile (char* filename);
+
+// Parse a ply file into an object structure.
+// Returns FALSE, with a message, if the file can not be read
+//  or is not valid.
+boolean read_ply_file (char* filename, objectPtr object_data);
+
+// Parse the contents of a ply file, already stored in memory.
+// Returns FALSE, with a message, if the data is not valid.
+boolean readPlyBuffer (char* data, size_t length, char* filename, objectPtr objectData);
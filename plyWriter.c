@@ -4,59 +4,281 @@
 #include "geometry.h"
 #include "faces.h"
 #include "object3D.h"
+#include "vertexGeometry.h"
+#include "meshWriter.h"
 #include "plyWriter.h"
 
-// Output the contents of an objectStruct
-//  into a ply file.
-void write_ply_file (objectStruct object_data, char* filename)
+// Size of the buffers used to write the file.
+#define PLY_BUFFER_SIZE		(1 << 20)
+
+// Number of vertices or faces written between
+//  calls to 'printProgressStar' in binary mode.
+#define PLY_PROGRESS_STEP	4096
+
+// Largest number of characters in a line of the file.
+#define PLY_MAX_LINE		128
+
+
+// Store a 32 bit value in little endian byte order.
+static void store_little_endian (unsigned char* destination, unsigned int value)
 {
-	FILE*			PLY_FD = NULL;
-	int				num_vertices;
-	int				num_faces;
+	destination[0] = value & 0xFF;
+	destination[1] = (value >> 8) & 0xFF;
+	destination[2] = (value >> 16) & 0xFF;
+	destination[3] = (value >> 24) & 0xFF;
+}
+
+
+// Store a double in little endian byte order.
+static void store_double (unsigned char* destination, double value)
+{
+	unsigned long long	bits;
+
+	memcpy (&bits, &value, sizeof (double));
+	store_little_endian (destination, (unsigned int) (bits & 0xFFFFFFFF));
+	store_little_endian (destination + 4, (unsigned int) (bits >> 32));
+}
+
+
+// Store a float in little endian byte order.
+static void store_float (unsigned char* destination, float value)
+{
+	unsigned int	bits;
+
+	memcpy (&bits, &value, sizeof (float));
+	store_little_endian (destination, bits);
+}
+
+
+// Write the vertex and face blocks in binary format.
+// If 'vertex_data_array' is not NULL, the results of the Gauss
+//  map are written after the coordinates of each vertex.
+// The data is collected in a large buffer, which is written
+//  to the file each time it fills.
+static void write_ply_binary_data (objectStruct object_data, vertexDataPtr vertex_data_array, int* vertex_remap, FILE* PLY_FD)
+{
+	unsigned char*	buffer = NULL;
+	unsigned char*	pointer = NULL;
+	unsigned char*	limit = NULL;
+	int				num_vertices = object_data.numVertices;
+	int				num_faces = object_data.numFaces;
 	int				i;
-	time_t			start;
-	time_t			stop;
-	vertexStruct	vertex;
-	faceStruct		face;
+	int				j;
+	vertexPtr		vertex = NULL;
+	facePtr			face = NULL;
 
-    printf ("\n[EXTRA STAGE] -- WRITING PLY FILE: %s\n", filename); fflush (stdout);
-	(void) time (&start);
+	buffer = (unsigned char*) xmalloc (PLY_BUFFER_SIZE);
+	// Leave room for the largest item.
+	limit = buffer + PLY_BUFFER_SIZE - 64;
+	pointer = buffer;
+
+	//Write the coordinates for the vertices.
+	for (i=1; i<=num_vertices; i++)
+	{
+		vertex = &object_data.vertexArray[i];
+		if (vertex->vertexId >= 0)
+		{
+			store_float (pointer, (float) vertex->x);
+			store_float (pointer + 4, (float) vertex->y);
+			store_float (pointer + 8, (float) vertex->z);
+			pointer += 12;
+
+			if (vertex_data_array != NULL)
+			{
+				store_double (pointer, vertex_data_array[i].curvature);
+				store_double (pointer + 8, vertex_data_array[i].angle_deficit);
+				pointer[16] = (unsigned char) vertex_data_array[i].type;
+				pointer[17] = (unsigned char) vertex_data_array[i].border_vertex;
+				pointer += 18;
+			}
+		}
+
+		if (pointer > limit)
+		{
+			fwrite (buffer, 1, pointer - buffer, PLY_FD);
+			pointer = buffer;
+		}
+		if (i % PLY_PROGRESS_STEP == 0 || i == num_vertices)
+			printProgressStar (i, num_vertices + num_faces);
+	}
+
+	// Write the faces.
+	for (i=1; i<=num_faces; i++)
+	{
+		face = &object_data.faceArray[i];
+		if (face->faceId >= 0)
+		{
+			*pointer = (unsigned char) face->faceVertices;
+			pointer++;
+			for (j=0; j<face->faceVertices; j++)
+			{
+				store_little_endian (pointer, (unsigned int) (vertex_remap[face->vertex[j]] - 1));
+				pointer += 4;
+			}
+		}
+
+		if (pointer > limit)
+		{
+			fwrite (buffer, 1, pointer - buffer, PLY_FD);
+			pointer = buffer;
+		}
+		if (i % PLY_PROGRESS_STEP == 0 || i == num_faces)
+			printProgressStar (num_vertices + i, num_vertices + num_faces);
+	}
+
+	fwrite (buffer, 1, pointer - buffer, PLY_FD);
+
+	free (buffer);
+}
+
+
+// Write the line for a vertex.
+// Deleted vertices are skipped.
+static int format_ply_vertex (char* buffer, int index, void* data)
+{
+	meshWriterDataPtr	writer_data = (meshWriterDataPtr) data;
+	vertexPtr			vertex = &writer_data->object_data->vertexArray[index];
+	int					length = 0;
+
+	if (vertex->vertexId < 0)
+		return (0);
+
+	length += formatDouble (buffer + length, vertex->x);
+	buffer[length++] = ' ';
+	length += formatDouble (buffer + length, vertex->y);
+	buffer[length++] = ' ';
+	length += formatDouble (buffer + length, vertex->z);
+	buffer[length++] = '\n';
+
+	return (length);
+}
 
-	num_vertices = object_data.numVertices;
-	num_faces = object_data.numFaces;
 
-	PLY_FD = xfopen (filename, "w");
+// Write the line for a face, with the new indices of its vertices.
+// Deleted faces are skipped.
+static int format_ply_face (char* buffer, int index, void* data)
+{
+	meshWriterDataPtr	writer_data = (meshWriterDataPtr) data;
+	facePtr				face = &writer_data->object_data->faceArray[index];
+	int					length = 0;
+	int					i;
+
+	if (face->faceId < 0)
+		return (0);
+
+	length += formatInteger (buffer + length, face->faceVertices);
+	for (i=0; i<face->faceVertices; i++)
+	{
+		buffer[length++] = ' ';
+		length += formatInteger (buffer + length, writer_data->vertex_remap[face->vertex[i]] - 1);
+	}
+	buffer[length++] = '\n';
+
+	return (length);
+}
+
 
-	// Write the header.
+// Write the header of the file.
+// The properties with the results of the Gauss map are
+//  declared only when 'curvature' is TRUE.
+static void write_ply_header (FILE* PLY_FD, boolean binary, int num_vertices, int num_faces, boolean curvature)
+{
 	fprintf (PLY_FD, "ply\n");
-	fprintf (PLY_FD, "format ascii 1.0\n");
+	if (binary)
+		fprintf (PLY_FD, "format binary_little_endian 1.0\n");
+	else
+		fprintf (PLY_FD, "format ascii 1.0\n");
 	fprintf (PLY_FD, "comment created by 'decimator'\n");
+	if (curvature)
+		fprintf (PLY_FD, "comment type: 0 flat, 1 positive, 2 negative, 3 mixed, 4 positive concave, 5 mixed concave\n");
 	fprintf (PLY_FD, "element vertex %d\n", num_vertices);
 	fprintf (PLY_FD, "property float x\n");
 	fprintf (PLY_FD, "property float y\n");
 	fprintf (PLY_FD, "property float z\n");
+	if (curvature)
+	{
+		fprintf (PLY_FD, "property double curvature\n");
+		fprintf (PLY_FD, "property double angle_deficit\n");
+		fprintf (PLY_FD, "property uchar type\n");
+		fprintf (PLY_FD, "property uchar border_vertex\n");
+	}
 	fprintf (PLY_FD, "element face %d\n", num_faces);
 	fprintf (PLY_FD, "property list uchar int vertex_indices\n");
 	fprintf (PLY_FD, "end_header\n");
+}
 
-	//Write the coordinates for the vertices.
-	for (i=1; i<=num_vertices; i++)
-	{
-		vertex = object_data.vertexArray[i];
-		fprintf (PLY_FD, "%lf %lf %lf\n", vertex.x, vertex.y, vertex.z);
-		printProgressStar (i, num_vertices + num_faces);
-	}
 
-	// Write the faces.
-	for (i=1; i<=num_faces; i++)
+// Write the whole file, with or without the
+//  per vertex results of the Gauss map.
+static void write_ply_data (objectStruct object_data, vertexDataPtr vertex_data_array, char* filename, boolean binary)
+{
+	FILE*					PLY_FD = NULL;
+	int						num_vertices;
+	int						num_faces;
+	int						total;
+	meshWriterDataStruct	writer_data;
+
+	writer_data.object_data = &object_data;
+	writer_data.vertex_remap = build_vertex_remap (object_data, &num_vertices);
+	num_faces = count_valid_faces (object_data);
+	total = object_data.numVertices + object_data.numFaces;
+
+	PLY_FD = xfopen (filename, binary ? "wb" : "w");
+	setvbuf (PLY_FD, NULL, _IOFBF, PLY_BUFFER_SIZE);
+
+	write_ply_header (PLY_FD, binary, num_vertices, num_faces, vertex_data_array != NULL);
+
+	if (binary)
+		write_ply_binary_data (object_data, vertex_data_array, writer_data.vertex_remap, PLY_FD);
+	else
 	{
-		face = object_data.faceArray[i];
-		fprintf (PLY_FD, "3 %d %d %d\n", face.vertex[0]-1, face.vertex[1]-1, face.vertex[2]-1);
-		printProgressStar (num_vertices + i, num_vertices + num_faces);
+		//Write the coordinates for the vertices.
+		write_records (PLY_FD, format_ply_vertex, &writer_data, 1, object_data.numVertices, PLY_MAX_LINE, 0, total);
+
+		// Write the faces.
+		write_records (PLY_FD, format_ply_face, &writer_data, 1, object_data.numFaces, PLY_MAX_LINE, object_data.numVertices, total);
 	}
 
 	fclose (PLY_FD);
 
+	free (writer_data.vertex_remap);
+}
+
+
+// Output the contents of an objectStruct
+//  into a ply file.
+// The vertices and faces that were deleted (with negative ids)
+//  are not written, and the vertices are numbered again.
+void write_ply_file (objectStruct object_data, char* filename, boolean binary)
+{
+	time_t					start;
+	time_t					stop;
+
+    printf ("\n[EXTRA STAGE] -- WRITING PLY FILE: %s\n", filename); fflush (stdout);
+	(void) time (&start);
+
+	write_ply_data (object_data, NULL, filename, binary);
+
+	(void) time (&stop);
+	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
+}
+
+
+// Output an objectStruct into a binary ply file, together with
+//  the curvature computed for each vertex.
+// Each vertex has the additional properties 'curvature',
+//  'angle_deficit', 'type' and 'border_vertex', taken from
+//  the array of vertex data, indexed like the vertices.
+void write_curvature_ply_file (objectStruct object_data, vertexDataPtr vertex_data_array, char* filename)
+{
+	time_t					start;
+	time_t					stop;
+
+    printf ("\n[EXTRA STAGE] -- WRITING CURVATURE PLY FILE: %s\n", filename); fflush (stdout);
+	(void) time (&start);
+
+	write_ply_data (object_data, vertex_data_array, filename, TRUE);
+
 	(void) time (&stop);
 	printf ("[done] (%ld seconds)\n", (int) stop - start); fflush (stdout);
 }
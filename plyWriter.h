@@ -1,3 +1,11 @@
 // Output the contents of an objectStruct
-//  into an obj file.
-void write_ply_file (objectStruct object_data, char* filename);
+//  into a ply file.
+// If 'binary' is TRUE, the file is written in the
+//  'binary_little_endian' format, otherwise in 'ascii'.
+// Deleted vertices and faces are skipped.
+void write_ply_file (objectStruct object_data, char* filename, boolean binary);
+
+// Output an objectStruct into a binary ply file, adding the
+//  'curvature', 'angle_deficit', 'type' and 'border_vertex'
+//  properties of each vertex, from the results of the Gauss map.
+void write_curvature_ply_file (objectStruct object_data, vertexDataPtr vertex_data_array, char* filename);
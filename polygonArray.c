@@ -0,0 +1,220 @@
+#include "tools.h"
+#include "arena.h"
+#include "lists.h"
+#include "vertices.h"
+#include "geometry.h"
+#include "polygonArray.h"
+
+
+// Make room in the array for at least the number
+//  of vectors indicated.
+static void reserve_polygon_array (polygonArrayPtr polygon, int capacity)
+{
+	vectorPtr*	vectors = NULL;
+
+	if (capacity <= polygon->capacity)
+		return;
+
+	if (capacity < 2 * polygon->capacity)
+		capacity = 2 * polygon->capacity;
+
+	vectors = (vectorPtr*) scratch_malloc (sizeof (vectorPtr) * capacity);
+	if (polygon->length > 0)
+		memcpy (vectors, polygon->vectors, sizeof (vectorPtr) * polygon->length);
+	scratch_free (polygon->vectors);
+
+	polygon->vectors = vectors;
+	polygon->capacity = capacity;
+}
+
+
+// Create an empty polygon, with space for the
+//  number of vectors indicated.
+polygonArrayStruct new_polygon_array (int capacity)
+{
+	polygonArrayStruct	polygon;
+
+	if (capacity < 4)
+		capacity = 4;
+
+	polygon.length = 0;
+	polygon.capacity = capacity;
+	polygon.vectors = (vectorPtr*) scratch_malloc (sizeof (vectorPtr) * capacity);
+
+	return (polygon);
+}
+
+
+// Create a polygon with the vectors of a list,
+//  in the same order.
+// The vectors are shared with the list.
+polygonArrayStruct list_to_polygon_array (nodePtr list)
+{
+	polygonArrayStruct	polygon;
+	nodePtr				pointer = NULL;
+
+	polygon = new_polygon_array (getListLength (list));
+
+	for (pointer=list; pointer!=NULL; pointer=pointer->next)
+		polygon.vectors[polygon.length++] = (vectorPtr) pointer->data;
+
+	return (polygon);
+}
+
+
+// Create a polygon with copies of the vectors of a list.
+polygonArrayStruct copy_list_to_polygon_array (nodePtr list)
+{
+	polygonArrayStruct	polygon;
+	nodePtr				pointer = NULL;
+
+	polygon = new_polygon_array (getListLength (list));
+
+	for (pointer=list; pointer!=NULL; pointer=pointer->next)
+		polygon.vectors[polygon.length++] = (vectorPtr) copyNode (pointer->data, sizeof (vectorStruct));
+
+	return (polygon);
+}
+
+
+// Create a list with the vectors of a polygon.
+nodePtr polygon_array_to_list (polygonArrayPtr polygon)
+{
+	nodePtr		list = NULL;
+	int			i;
+
+	for (i=polygon->length-1; i>=0; i--)
+		list = addFrontNode (list, polygon->vectors[i]);
+
+	return (list);
+}
+
+
+// Store the vectors of a polygon in an existing list,
+//  reusing its nodes.
+// Nodes are added or released at the end of the list
+//  to match the length of the polygon.
+void store_polygon_array_in_list (polygonArrayPtr polygon, nodePtr* list)
+{
+	nodePtr		pointer = *list;
+	nodePtr		tail = NULL;
+	nodePtr		next = NULL;
+	int			i;
+
+	for (i=0; i<polygon->length; i++)
+	{
+		if (pointer != NULL)
+		{
+			pointer->data = polygon->vectors[i];
+			tail = pointer;
+			pointer = pointer->next;
+		}
+		else
+		{
+			tail = addNode (tail, polygon->vectors[i]);
+			if (*list == NULL)
+				*list = tail;
+		}
+	}
+
+	// Release the nodes left over.
+	if (tail != NULL)
+		tail->next = NULL;
+	else
+		*list = NULL;
+
+	while (pointer != NULL)
+	{
+		next = pointer->next;
+		scratch_free (pointer);
+		pointer = next;
+	}
+}
+
+
+// Release the memory of the array.
+// The vectors are not freed.
+void free_polygon_array (polygonArrayPtr polygon)
+{
+	scratch_free (polygon->vectors);
+	polygon->vectors = NULL;
+	polygon->length = 0;
+	polygon->capacity = 0;
+}
+
+
+// Get the vector at a position of a polygon.
+// The position wraps around the ends, so -1 is the last vector.
+vectorPtr polygon_vector (polygonArrayPtr polygon, int index)
+{
+	index %= polygon->length;
+	if (index < 0)
+		index += polygon->length;
+
+	return (polygon->vectors[index]);
+}
+
+
+// Add a vector at the end of a polygon.
+void append_polygon_vector (polygonArrayPtr polygon, vectorPtr vector)
+{
+	reserve_polygon_array (polygon, polygon->length + 1);
+
+	polygon->vectors[polygon->length++] = vector;
+}
+
+
+// Insert a vector at a position of a polygon,
+//  moving the following vectors one place.
+void insert_polygon_vector (polygonArrayPtr polygon, int index, vectorPtr vector)
+{
+	reserve_polygon_array (polygon, polygon->length + 1);
+
+	memmove (&polygon->vectors[index+1], &polygon->vectors[index], sizeof (vectorPtr) * (polygon->length - index));
+	polygon->vectors[index] = vector;
+	polygon->length++;
+}
+
+
+// Remove the vector at a position of a polygon.
+// Returns the vector removed.
+vectorPtr remove_polygon_vector (polygonArrayPtr polygon, int index)
+{
+	vectorPtr	vector = polygon->vectors[index];
+
+	memmove (&polygon->vectors[index], &polygon->vectors[index+1], sizeof (vectorPtr) * (polygon->length - index - 1));
+	polygon->length--;
+
+	return (vector);
+}
+
+
+// Move the vectors in a range of positions of a polygon
+//  into a new polygon.
+// The range wraps around the end of the polygon.
+polygonArrayStruct split_polygon_array (polygonArrayPtr polygon, int begin, int count)
+{
+	polygonArrayStruct	part;
+	int					length = polygon->length;
+	int					kept = 0;
+	int					i;
+
+	part = new_polygon_array (count);
+
+	begin %= length;
+	if (begin < 0)
+		begin += length;
+
+	for (i=0; i<count; i++)
+		part.vectors[part.length++] = polygon->vectors[(begin + i) % length];
+
+	// Close the gap left in the original polygon.
+	for (i=0; i<length; i++)
+	{
+		if ( ((i - begin + length) % length) >= count )
+			polygon->vectors[kept++] = polygon->vectors[i];
+	}
+	polygon->length = kept;
+
+	return (part);
+}
@@ -0,0 +1,63 @@
+// Data structures
+
+// POLYGON OF VECTORS
+// Contiguous array with the vectors of a spherical
+//  polygon, in order.
+// The array holds pointers, so the vectors can be moved
+//  between polygons and lists without copying them.
+typedef struct polygonArrayStruct
+{
+	int			length;
+	int			capacity;
+	vectorPtr*	vectors;
+} polygonArrayStruct;
+
+typedef polygonArrayStruct* polygonArrayPtr;
+
+
+// Function declarations
+
+// Create an empty polygon, with space for the
+//  number of vectors indicated.
+polygonArrayStruct new_polygon_array (int capacity);
+
+// Create a polygon with the vectors of a list,
+//  in the same order.
+// The vectors are shared with the list.
+polygonArrayStruct list_to_polygon_array (nodePtr list);
+
+// Create a polygon with copies of the vectors of a list.
+polygonArrayStruct copy_list_to_polygon_array (nodePtr list);
+
+// Create a list with the vectors of a polygon.
+nodePtr polygon_array_to_list (polygonArrayPtr polygon);
+
+// Store the vectors of a polygon in an existing list,
+//  reusing its nodes.
+// Nodes are added or released at the end of the list
+//  to match the length of the polygon.
+void store_polygon_array_in_list (polygonArrayPtr polygon, nodePtr* list);
+
+// Release the memory of the array.
+// The vectors are not freed.
+void free_polygon_array (polygonArrayPtr polygon);
+
+// Get the vector at a position of a polygon.
+// The position wraps around the ends, so -1 is the last vector.
+vectorPtr polygon_vector (polygonArrayPtr polygon, int index);
+
+// Add a vector at the end of a polygon.
+void append_polygon_vector (polygonArrayPtr polygon, vectorPtr vector);
+
+// Insert a vector at a position of a polygon,
+//  moving the following vectors one place.
+void insert_polygon_vector (polygonArrayPtr polygon, int index, vectorPtr vector);
+
+// Remove the vector at a position of a polygon.
+// Returns the vector removed.
+vectorPtr remove_polygon_vector (polygonArrayPtr polygon, int index);
+
+// Move the vectors in a range of positions of a polygon
+//  into a new polygon.
+// The range wraps around the end of the polygon.
+polygonArrayStruct split_polygon_array (polygonArrayPtr polygon, int begin, int count);
@@ -2,34 +2,53 @@
 #include <math.h>
 
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 #include "vertices.h"
 #include "geometry.h"
 #include "faces.h"
+#include "polygonArray.h"
 #include "sphericalGeometry.h"
 #include "convexHull3D.h"
 
+// Polygons with fewer arcs test every pair of arcs
+//  for intersections, without sorting them first.
+#define MIN_ARCS_TO_SWEEP		32
+
+// Angle added to the bounds of the arcs, and distance from
+//  the plane of an arc, within which other arcs are still
+//  tested for intersections.
+// An intersection found by 'arcIntersection' is perpendicular
+//  to the normals of both arcs, as it is their cross product,
+//  and is within the tolerance of 'colinearVectors' (1E-4 for
+//  each coordinate) of a point of each arc. So an endpoint of
+//  each arc is at most about 2E-4 away from the plane of the
+//  other, or the endpoints are on both sides of it. This holds
+//  with any normal, even the imprecise one of an arc between
+//  almost equal vectors, since the same normal is used by the
+//  test and by 'arcIntersection'. Rounding in single precision
+//  adds about 1E-6.
+#define ARC_BOUND_MARGIN		1E-2
+
+// Range of angles, measured from a coordinate axis,
+//  that contains an arc.
+typedef struct
+{
+	double		lower;
+	double		upper;
+	int			arc;
+} arcBoundsStruct;
 
-extern nodePtr		PolygonTriangles;
+typedef arcBoundsStruct* arcBoundsPtr;
 
-// List for storing the pairs of intersecting vectors.
-// Each pair structure is an array of 6 integers.
-// [0] vector Id of intersection 1
-// [1] vector Id of intersection 2
-// [2] endpoint of arc 1
-// [3] endpoint of arc 1
-// [4] endpoint of arc 2
-// [5] endpoint of arc 2
-nodePtr				IntersectionPairs = NULL;
-nodePtr				IntersectionPairsCopy = NULL;
 
 
-// Extract the normals from a list of faces.
+// Extract the normals from an array of faces.
 // Return a list with only the normals of the faces.
-nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals, int vertex_index, nodePtr* feature_edge_list)
+nodePtr getFaceNormalList (int* faceIndices, int numFaces, facePtr faceArray, int* numNormals, int vertex_index, nodePtr* feature_edge_list)
 {
 	nodePtr			normalList = NULL;
-	nodePtr			normalListTail = NULL;
+	polygonArrayStruct	normals;
 	vectorPtr		vector = NULL;
 	vectorPtr		previousVector = NULL;
 	vectorPtr		nextVector = NULL;
@@ -37,9 +56,7 @@ nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals,
 	faceStruct		face;
 	spinType		orientation;
 	int				i;
-	int				numFaces = getListLength (faceList);
 	int				counter = 0;
-	int*			index = NULL;
 	int*			feature_edge = NULL;
 	static double	feature_threshold = 1.2;
 	double			angle_1;
@@ -47,25 +64,23 @@ nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals,
 
 	// Get the last face, and set its normal as
 	//  the 'previous' one.
-	index = (int*) getNodeData (faceList, numFaces-1);
-	face = faceArray[*index];
+	face = faceArray[faceIndices[numFaces-1]];
 	previousVector = face.faceNormal;
 
+	normals = new_polygon_array (numFaces);
+
 	for (i=0; i<numFaces; i++)
 	{
 		// Get the normal vector of the current face.
-		index = (int*) getNodeData (faceList, i);
-		face = faceArray[*index];
+		face = faceArray[faceIndices[i]];
 		vector = face.faceNormal;
 
 		// Skip vectors that are the same.
 		if ( !relaxedEqualVectors (vector, previousVector) || (numFaces == 1) )
 		{
-			newVector = (vectorPtr) xmalloc (sizeof (vectorStruct));
+			newVector = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 			memcpy (newVector, vector, sizeof (vectorStruct));
-			normalListTail = addNode (normalListTail, newVector);
-			if (normalList == NULL)
-				normalList = normalListTail;
+			append_polygon_vector (&normals, newVector);
 
 			// (used for decimation/triangulation).
 			if (angleBetweenVectors (previousVector, vector) > feature_threshold)
@@ -89,9 +104,9 @@ nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals,
 	{
 		for (i=0; i<counter; i++)
 		{
-			previousVector = (vectorPtr) getNodeData (normalList, i);
-			vector = (vectorPtr) getNodeData (normalList, (i+1)%counter);
-			nextVector = (vectorPtr) getNodeData (normalList, (i+2)%counter);
+			previousVector = polygon_vector (&normals, i);
+			vector = polygon_vector (&normals, (i+1)%counter);
+			nextVector = polygon_vector (&normals, (i+2)%counter);
 
 			// Remove coplanar contiguous arcs. (Both lie in a flat face)
 			orientation = sphereAngleOrientation (previousVector, vector, nextVector, 1);
@@ -101,10 +116,10 @@ nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals,
 				angle_2 = angleBetweenVectors (previousVector, nextVector);
 
 				if (angle_1 > angle_2)
-					newVector = removeNode (&normalList, (i+2)%counter);
+					newVector = remove_polygon_vector (&normals, (i+2)%counter);
 				else
-					newVector = removeNode (&normalList, (i+1)%counter);
-				free (newVector);
+					newVector = remove_polygon_vector (&normals, (i+1)%counter);
+				scratch_free (newVector);
 				i--;
 				counter--;
 			}
@@ -117,17 +132,19 @@ nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals,
 	if (counter == 0)
 	{
 		// Get the normal vector of the first face.
-		index = (int*) getNodeData (faceList, 0);
-		face = faceArray[*index];
+		face = faceArray[faceIndices[0]];
 		vector = face.faceNormal;
 
 		// Add the first normal to the list.
-		newVector = (vectorPtr) xmalloc (sizeof (vectorStruct));
+		newVector = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 		memcpy (newVector, vector, sizeof (vectorStruct));
-		normalList = addNode (normalListTail, newVector);
+		append_polygon_vector (&normals, newVector);
 		counter = 1;
 	}
 
+	normalList = polygon_array_to_list (&normals);
+	free_polygon_array (&normals);
+
 	*numNormals = counter;
 
 	return (normalList);
@@ -136,24 +153,28 @@ nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals,
 
 // Add extra vectors between pairs of opposite vectors.
 // When two faces lie on the same plane, but in contrary directions.
-void check_opposite_vectors (nodePtr normalList, facePtr faceArray, vertexPtr vertexArray, int* numNormals)
+// The faces are not changed, so they need not begin with the vertex.
+void check_opposite_vectors (nodePtr normalList, facePtr faceArray, vertexPtr vertexArray, int* numNormals, int vertex_index)
 {
 	int				i;
 	int				counter = *numNormals;
 	vectorPtr		vector = NULL;
 	vectorPtr		nextVector = NULL;
-	vectorPtr		edgeVector = NULL;
+	vectorStruct	edgeVector;
 	vectorPtr		newNormal = NULL;
 	faceStruct		face;
 	vertexStruct	vertex1;
 	vertexStruct	vertex2;
+	polygonArrayStruct	normals;
 
 	if (counter >=2)
 	{
+		normals = list_to_polygon_array (normalList);
+
 		for (i=0; i<counter; i++)
 		{
-			vector = (vectorPtr) getNodeData (normalList, i);
-			nextVector = (vectorPtr) getNodeData (normalList, (i+1)%counter);
+			vector = polygon_vector (&normals, i);
+			nextVector = polygon_vector (&normals, (i+1)%counter);
 
 			// There will be no two vectors facing the
 			//  same direction, so the next test will
@@ -161,22 +182,27 @@ void check_opposite_vectors (nodePtr normalList, facePtr faceArray, vertexPtr ve
 			if (colinearVectors (vector, nextVector))
 			{
 				face = faceArray[vector->vectorId];
+				reorderFace (&face, vertex_index);
 				vertex1 = vertexArray[face.vertex[0]];
 				vertex2 = vertexArray[face.vertex[2]];
 				// Create a vector along the edge joining
 				//  the two faces.
-				edgeVector = vectorFromVertices (&vertex1, &vertex2);
+				edgeVector = vector_from_vertices (&vertex1, &vertex2);
 				// Get the vector normal to the edge.
-				newNormal = crossProduct (vector, edgeVector);
+				newNormal = crossProduct (vector, &edgeVector);
 				newNormal->type = NORMAL;
-				// Add the new vector to the list.
-				insertDataAfterIndex (normalList, newNormal, i);
+				// Add the new vector after the current one.
+				insert_polygon_vector (&normals, i+1, newNormal);
 				counter++;
 				// Increase 'i' to skip over the vector just inserted.
 				i++;
-				free (edgeVector);
 			}
 		}
+
+		// The first vector does not change,
+		//  so the head of the list stays the same.
+		store_polygon_array_in_list (&normals, &normalList);
+		free_polygon_array (&normals);
 	}
 
 	// Update the number of vectors.
@@ -192,28 +218,116 @@ void remove_duplicate_normals (nodePtr* normal_list)
 	vectorPtr	previousVector = NULL;
 	vectorPtr	removed_vector = NULL;
 	int			i;
-	int			list_length = getListLength (*normal_list);
+	int			list_length;
+	polygonArrayStruct	normals;
+
+	normals = list_to_polygon_array (*normal_list);
+	list_length = normals.length;
+
+	if (list_length == 0)
+	{
+		free_polygon_array (&normals);
+		return;
+	}
 
 	// Get the last face, and set its normal as
 	//  the 'previous' one.
-	previousVector = (vectorPtr) getNodeData (*normal_list, list_length-1);
+	previousVector = polygon_vector (&normals, list_length-1);
 
 	for (i=0; i<list_length; i++)
 	{
 		// Get the normal vector of the current face.
-		vector = (vectorPtr) getNodeData (*normal_list, i);
+		vector = polygon_vector (&normals, i);
 
 		// Skip vectors that are the same.
 		if ( relaxedEqualVectors (vector, previousVector) && (list_length > 1) )
 		{
-			removed_vector = removeNode (normal_list, i);
-			free (removed_vector);
+			removed_vector = remove_polygon_vector (&normals, i);
+			scratch_free (removed_vector);
 			list_length--;
 			i--;
 		}
 		else
 			previousVector = vector;
 	}
+
+	store_polygon_array_in_list (&normals, normal_list);
+	free_polygon_array (&normals);
+}
+
+
+// Check whether a polygon of normals goes only once around
+//  'center', in CCW order, always moving forward.
+// All the vectors must be on the side of 'center'. Seen from
+//  the center, the arcs are then straight segments, and the
+//  polygon is star shaped around it.
+// Such a polygon is simple: its arcs do not intersect, it has no
+//  loops, and its area is the angle deficit of the vertex.
+boolean is_simple_spherical_polygon (nodePtr normalList, int numNormals, vectorPtr center)
+{
+	polygonArrayStruct	normals;
+	vectorPtr		vector = NULL;
+	vectorStruct	axis;
+	vectorStruct	axis_1;
+	vectorStruct	axis_2;
+	double			angle;
+	double			previous_angle = 0.0;
+	double			turn;
+	double			total_turn = 0.0;
+	boolean			simple = TRUE;
+	int				i;
+
+	if (numNormals < 3)
+		return (FALSE);
+
+	// Two directions perpendicular to the center, with
+	//  'axis_1' x 'axis_2' = 'center'.
+	// The axis used to build them is the one furthest
+	//  from the center.
+	axis.i = 0.0;
+	axis.j = 0.0;
+	axis.k = 0.0;
+	if ( (fabs (center->i) <= fabs (center->j)) && (fabs (center->i) <= fabs (center->k)) )
+		axis.i = 1.0;
+	else if (fabs (center->j) <= fabs (center->k))
+		axis.j = 1.0;
+	else
+		axis.k = 1.0;
+	axis_1 = cross_product (center, &axis);
+	axis_2 = cross_product (center, &axis_1);
+
+	normals = list_to_polygon_array (normalList);
+
+	// The first vector is visited again at the end,
+	//  to measure the turn that closes the polygon.
+	for (i=0; i<=numNormals && simple; i++)
+	{
+		vector = polygon_vector (&normals, i);
+
+		if ( (i < numNormals) && (dotProduct (vector, center) < EPSILON) )
+			simple = FALSE;
+
+		angle = atan2 (dotProduct (vector, &axis_2), dotProduct (vector, &axis_1));
+
+		// Each vector must be ahead of the previous one,
+		//  by less than half a turn.
+		if (i > 0)
+		{
+			turn = angle - previous_angle;
+			if (turn < 0.0)
+				turn += 2 * PI;
+			if ( (turn < EPSILON) || (turn > PI - EPSILON) )
+				simple = FALSE;
+			total_turn += turn;
+		}
+		previous_angle = angle;
+	}
+
+	free_polygon_array (&normals);
+
+	// The sum of the turns is a multiple of 2 PI, the number
+	//  of times that the polygon goes around the center.
+	return ( simple && (total_turn < 3 * PI) );
 }
 
 
@@ -227,6 +341,8 @@ nodePtr findLoopNormals (nodePtr normalList, int numNormals, int* numBasicPolygo
 {
 	nodePtr		newList = NULL;
 	nodePtr		independentPolygonsList = NULL;
+	polygonArrayStruct	normals;
+	polygonArrayStruct	loop;
 	vectorPtr	firstVector = NULL;
 	vectorPtr	vector1 = NULL;
 	vectorPtr	vector2 = NULL;
@@ -249,15 +365,17 @@ nodePtr findLoopNormals (nodePtr normalList, int numNormals, int* numBasicPolygo
 		return (independentPolygonsList);
 	}
 
-	repeatLocations = (int*) xmalloc (sizeof (int) * (numNormals / 3));
+	repeatLocations = (int*) scratch_malloc (sizeof (int) * (numNormals / 3));
 	memset (repeatLocations, 0, sizeof (int) * (numNormals / 3));
 
-	firstVector = (vectorPtr) getNodeData (normalList, 0);
+	normals = list_to_polygon_array (normalList);
+
+	firstVector = polygon_vector (&normals, 0);
 
 	// Compare each of the vectors with the first one.
 	for (i=1; i<numNormals; i++)
 	{
-		vector1 = (vectorPtr) getNodeData (normalList, i);
+		vector1 = polygon_vector (&normals, i);
 
 		// Any vectors that are similar are recorded, and 
 		//  the flag is set to continue with the process.
@@ -296,12 +414,12 @@ nodePtr findLoopNormals (nodePtr normalList, int numNormals, int* numBasicPolygo
 	// Check that all the elements in the loop are also repeated.
 	for (i=0; i<repeatLocations[0] && loopedPolygon; i++)
 	{
-		vector1 = (vectorPtr) getNodeData (normalList, i);
+		vector1 = polygon_vector (&normals, i);
 
 		// Check against all other remaining vectors.
 		for (j=1; j<=counter; j++)
 		{
-			vector2 = (vectorPtr) getNodeData (normalList, i + (loopSize * j));
+			vector2 = polygon_vector (&normals, i + (loopSize * j));
 
 			// If they are different, the loop is broken.
 			if (!equalVectors (vector1, vector2))
@@ -321,22 +439,24 @@ nodePtr findLoopNormals (nodePtr normalList, int numNormals, int* numBasicPolygo
 	// Split the list into several polygons, at the repeatLocations.
 	for (i=counter; i>0 && loopedPolygon; i--)
 	{
-		for (j=loopSize-1; j>=0; j--)
-		{
-			vector1 = (vectorPtr) removeNode (&normalList, (loopSize * i) + j);
-			newList = addFrontNode (newList, vector1);
+		loop = split_polygon_array (&normals, loopSize * i, loopSize);
+		newList = polygon_array_to_list (&loop);
+		free_polygon_array (&loop);
 
-		}
 		// Insert the new list into the list of lists.
 		independentPolygonsList = addFrontNode (independentPolygonsList, newList);
 	}
 
+	// Keep in the original list only the first loop.
+	store_polygon_array_in_list (&normals, &normalList);
+	free_polygon_array (&normals);
+
 	// Insert the remaining items as another polygon.
 	independentPolygonsList = addFrontNode (independentPolygonsList, normalList);
 
 	*numBasicPolygons = 1 + counter;
 
-	free (repeatLocations);
+	scratch_free (repeatLocations);
 
 	return (independentPolygonsList);
 }
@@ -344,7 +464,7 @@ nodePtr findLoopNormals (nodePtr normalList, int numNormals, int* numBasicPolygo
 
 // Compare a new intersection against those already
 //  stored in a list.
-void matchIntersectionPairs (int vectorId_1, int vectorId_2, int vectorId_3, int vectorId_4, int new_Id)
+void matchIntersectionPairs (sphericalContextPtr context, int vectorId_1, int vectorId_2, int vectorId_3, int vectorId_4, int new_Id)
 {
 	boolean		matched = FALSE;
 	int			num_pairs = 0;
@@ -353,11 +473,11 @@ void matchIntersectionPairs (int vectorId_1, int vectorId_2, int vectorId_3, int
 
 	// Try to match the intersection just found with
 	//  one of the previous ones.
-	num_pairs = getListLength (IntersectionPairs);
+	num_pairs = getListLength (context->intersection_pairs);
 	matched = FALSE;
 	for (i=0; i<num_pairs; i++)
 	{
-		currentPair = (int*) getNodeData (IntersectionPairs, i);
+		currentPair = (int*) getNodeData (context->intersection_pairs, i);
 
 		// If the intersection matches, then update the 
 		//  list of pairs, and delete the item with the
@@ -376,14 +496,14 @@ void matchIntersectionPairs (int vectorId_1, int vectorId_2, int vectorId_3, int
 	if (!matched)
 	{
 		// Add a new node to the list of intersectionPairs.
-		currentPair = (int*) xmalloc ( sizeof (int) * 6 );
+		currentPair = (int*) scratch_malloc ( sizeof (int) * 6 );
 		currentPair[0] = new_Id;
 		currentPair[1] = 0;
 		currentPair[2] = vectorId_1;
 		currentPair[3] = vectorId_2;
 		currentPair[4] = vectorId_3;
 		currentPair[5] = vectorId_4;
-		IntersectionPairs = addFrontNode (IntersectionPairs, currentPair);
+		context->intersection_pairs = addFrontNode (context->intersection_pairs, currentPair);
 	}
 
 # if (DEBUG >= 2)
@@ -400,12 +520,12 @@ void matchIntersectionPairs (int vectorId_1, int vectorId_2, int vectorId_3, int
 // Set the list of intersections of a single segment
 //  in the correct order. Add the new vector specified as
 //  'intersection' in the correct place.
-void orderIntersectionsList (nodePtr* tmpList, int tmpLength, vectorPtr vector1, vectorPtr intersection)
+void orderIntersectionsList (polygonArrayPtr segment, vectorPtr vector1, vectorPtr intersection)
 {
 	vectorPtr	previousIntersection = NULL;
 	double		angle = 0.0;
 	double		previousAngle = 0.0;
-	int			insertionPoint;
+	int			insertionPoint = 0;
 	int			i;
 
 	// If there are more than one intersections
@@ -415,14 +535,13 @@ void orderIntersectionsList (nodePtr* tmpList, int tmpLength, vectorPtr vector1,
 	// Starting at index 0 the initial vector is
 	//  also checked. This allows the intersections
 	//  to go before the vector.
-	if (tmpLength > 0)
+	if (segment->length > 0)
 	{
 		angle = angleBetweenVectors (vector1, intersection);
-		insertionPoint = 0;
 
-		for (i=0; i<tmpLength; i++)
+		for (i=0; i<segment->length; i++)
 		{
-			previousIntersection = (vectorPtr) getNodeData (*tmpList, i);
+			previousIntersection = segment->vectors[i];
 			previousAngle = angleBetweenVectors (vector1, previousIntersection);
 			// 13 / 01 / 2007
 			// For vertices as in: triceratops.obj 225
@@ -432,61 +551,50 @@ void orderIntersectionsList (nodePtr* tmpList, int tmpLength, vectorPtr vector1,
 			if (angle >= previousAngle)
 				insertionPoint++;
 		}
-
-		// If the angle is the smallest, insert at the front
-		//  of the temporary list.
-		if (insertionPoint == 0)
-			*tmpList = addFrontNode (*tmpList, intersection);
-		// Otherwise, insert at the correct location.
-		// The index of insertion is reduced by 1, for the function
-		//  'insertDataAfterIndex' to work correctly.
-		else
-			insertDataAfterIndex (*tmpList, intersection, insertionPoint-1);
-	}
-	// If this is the first intersection, just insert it directly.
-	else
-	{
-		*tmpList = addNode (*tmpList, intersection);
 	}
+
+	// Insert after all the vectors with a smaller angle.
+	// If this is the first intersection, it goes at the front.
+	insert_polygon_vector (segment, insertionPoint, intersection);
 }
 
 
 // Remove pairs which have not been matched.
 // Also remove the intersection vectors that were not matched.
-void prunePairsList (nodePtr* extendedNormalList)
+void prunePairsList (sphericalContextPtr context, polygonArrayPtr extendedNormals)
 {
 	int			i, j;
-	int			numPairs = getListLength (IntersectionPairs);
+	int			numPairs = getListLength (context->intersection_pairs);
 	int			badVector;
 	int*		currentPair = NULL;
 	vectorPtr	currentVector = NULL;
 
-	for (i=0; i<numPairs && IntersectionPairs; i++)
+	for (i=0; i<numPairs && context->intersection_pairs; i++)
 	{
-		currentPair = (int*) getNodeData (IntersectionPairs, i);
+		currentPair = (int*) getNodeData (context->intersection_pairs, i);
 
 		if (currentPair[1] == 0)
 		{
-			currentPair = (int*) removeNode (&IntersectionPairs, i);
+			currentPair = (int*) removeNode (&(context->intersection_pairs), i);
 			i--;
 			numPairs--;
 			// Get the Id of the unmatched vector.
 			badVector = currentPair[0];
 
-			for (j=0; j<getListLength(*extendedNormalList); j++)
+			for (j=0; j<extendedNormals->length; j++)
 			{
-				currentVector = (vectorPtr) getNodeData (*extendedNormalList, j);
+				currentVector = extendedNormals->vectors[j];
 				if (currentVector->vectorId == badVector)
 				{
 					// Remove the vector from the extended list.
-					currentVector = removeNode (extendedNormalList, j);
-					free (currentVector);
+					currentVector = remove_polygon_vector (extendedNormals, j);
+					scratch_free (currentVector);
 					printf ("\tPRUNING: Discarding intersection vector %d, between segments %d-%d and %d-%d\n",
 							badVector, currentPair[2], currentPair[3], currentPair[4], currentPair[5]);
 					break;
 				}
 			}
-			free (currentPair);
+			scratch_free (currentPair);
 		}
 	}
 }
@@ -494,10 +602,183 @@ void prunePairsList (nodePtr* extendedNormalList)
 
 // Free the memory used for the
 //  matching of intersection pairs.
-void free_pairs_list (void)
+void free_pairs_list (sphericalContextPtr context)
+{
+	freeList (context->intersection_pairs);
+	freeList (context->intersection_pairs_copy);
+	context->intersection_pairs = NULL;
+	context->intersection_pairs_copy = NULL;
+}
+
+
+// Comparison of the lower bounds of arcs for 'qsort'.
+static int compare_arc_bounds (const void* bounds_1, const void* bounds_2)
+{
+	double		lower_1 = ((arcBoundsPtr) bounds_1)->lower;
+	double		lower_2 = ((arcBoundsPtr) bounds_2)->lower;
+
+	if (lower_1 < lower_2)
+		return (-1);
+	if (lower_1 > lower_2)
+		return (1);
+	return (((arcBoundsPtr) bounds_1)->arc - ((arcBoundsPtr) bounds_2)->arc);
+}
+
+
+// Comparison of integers for 'qsort'.
+static int compare_arc_indices (const void* index_1, const void* index_2)
+{
+	return (*(int*) index_1 - *(int*) index_2);
+}
+
+
+// Find the pairs of arcs of a polygon that may intersect.
+// Each arc is inside a spherical cap around its middle point.
+//  The caps are sorted by the range of angles they cover from
+//  the coordinate axis along which the arcs are most spread,
+//  and only the arcs whose ranges overlap are paired.
+// 'arc_normals' has the cross product of the endpoints of each arc.
+// Returns the arcs paired with arc 'i' in increasing order,
+//  from 'candidates[offsets[i]]' to 'candidates[offsets[i+1]-1]'.
+int* find_candidate_arc_pairs (polygonArrayPtr polygon, vectorPtr arc_normals, int** offsets)
+{
+	arcBoundsPtr	bounds = NULL;
+	vectorPtr		vector1 = NULL;
+	vectorPtr		vector2 = NULL;
+	double*			middle = NULL;
+	double			sum[3];
+	double			length;
+	double			radius;
+	double			cosine;
+	double			low[3] = {1.0, 1.0, 1.0};
+	double			high[3] = {-1.0, -1.0, -1.0};
+	int*			candidates = NULL;
+	int*			counts = NULL;
+	int				numArcs = polygon->length;
+	int				axis = 0;
+	int				arc1, arc2;
+	int				i, j;
+
+	bounds = (arcBoundsPtr) scratch_malloc (sizeof (arcBoundsStruct) * numArcs);
+	middle = (double*) scratch_malloc (sizeof (double) * 3 * numArcs);
+	counts = (int*) scratch_malloc (sizeof (int) * (numArcs + 1));
+	memset (counts, 0, sizeof (int) * (numArcs + 1));
+
+	// The cap of each arc has its center in the middle of the
+	//  arc, and a radius of half the length of the arc.
+	for (i=0; i<numArcs; i++)
+	{
+		vector1 = polygon->vectors[i];
+		vector2 = polygon_vector (polygon, i+1);
+
+		sum[0] = (double) vector1->i + vector2->i;
+		sum[1] = (double) vector1->j + vector2->j;
+		sum[2] = (double) vector1->k + vector2->k;
+		length = sqrt (sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+
+		// An arc between almost opposite vectors may go anywhere.
+		// The normal of an arc is a unit vector, except for an arc
+		//  between equal vectors, where 'cross_product' leaves it
+		//  as a zero vector. Such an arc has no direction, and is
+		//  also paired with every other arc.
+		if ( (length < ARC_BOUND_MARGIN) || (vectorLength (&arc_normals[i]) < ARC_BOUND_MARGIN) )
+		{
+			radius = PI;
+			length = 1.0;
+		}
+		else
+			radius = angleBetweenVectors (vector1, vector2) / 2;
+
+		for (j=0; j<3; j++)
+		{
+			middle[3*i + j] = sum[j] / length;
+			if (middle[3*i + j] < low[j])
+				low[j] = middle[3*i + j];
+			if (middle[3*i + j] > high[j])
+				high[j] = middle[3*i + j];
+		}
+
+		bounds[i].lower = -radius - ARC_BOUND_MARGIN;
+		bounds[i].upper = radius + ARC_BOUND_MARGIN;
+		bounds[i].arc = i;
+	}
+
+	for (j=1; j<3; j++)
+		if (high[j] - low[j] > high[axis] - low[axis])
+			axis = j;
+
+	// Angle between the middle of each arc and the axis.
+	for (i=0; i<numArcs; i++)
+	{
+		cosine = middle[3*i + axis];
+		if (cosine > 1.0)
+			cosine = 1.0;
+		if (cosine < -1.0)
+			cosine = -1.0;
+
+		bounds[i].lower += acos (cosine);
+		bounds[i].upper += acos (cosine);
+	}
+
+	qsort (bounds, numArcs, sizeof (arcBoundsStruct), compare_arc_bounds);
+
+	// Count the pairs of each arc, and then store them.
+	for (i=0; i<numArcs; i++)
+	{
+		for (j=i+1; j<numArcs && bounds[j].lower <= bounds[i].upper; j++)
+		{
+			counts[bounds[i].arc]++;
+			counts[bounds[j].arc]++;
+		}
+	}
+
+	*offsets = (int*) scratch_malloc (sizeof (int) * (numArcs + 1));
+	(*offsets)[0] = 0;
+	for (i=0; i<numArcs; i++)
+		(*offsets)[i+1] = (*offsets)[i] + counts[i];
+
+	candidates = (int*) scratch_malloc (sizeof (int) * ((*offsets)[numArcs] + 1));
+	memset (counts, 0, sizeof (int) * (numArcs + 1));
+
+	for (i=0; i<numArcs; i++)
+	{
+		for (j=i+1; j<numArcs && bounds[j].lower <= bounds[i].upper; j++)
+		{
+			arc1 = bounds[i].arc;
+			arc2 = bounds[j].arc;
+			candidates[(*offsets)[arc1] + counts[arc1]++] = arc2;
+			candidates[(*offsets)[arc2] + counts[arc2]++] = arc1;
+		}
+	}
+
+	// The arcs are tested in the same order as without
+	//  the candidates, so the results do not change.
+	for (i=0; i<numArcs; i++)
+		qsort (&candidates[(*offsets)[i]], counts[i], sizeof (int), compare_arc_indices);
+
+	scratch_free (bounds);
+	scratch_free (middle);
+	scratch_free (counts);
+
+	return (candidates);
+}
+
+
+// Check whether the endpoints of an arc are on
+//  opposite sides of the plane of another arc.
+// Returns FALSE only when both endpoints are clearly
+//  on the same side, so the arcs can not intersect.
+boolean arc_crosses_plane (vectorPtr vector1, vectorPtr vector2, vectorPtr plane_normal)
 {
-	freeList (IntersectionPairs);
-	IntersectionPairs = NULL;
+	double		side1 = dotProduct (vector1, plane_normal);
+	double		side2 = dotProduct (vector2, plane_normal);
+
+	if ( (side1 > ARC_BOUND_MARGIN) && (side2 > ARC_BOUND_MARGIN) )
+		return (FALSE);
+	if ( (side1 < -ARC_BOUND_MARGIN) && (side2 < -ARC_BOUND_MARGIN) )
+		return (FALSE);
+
+	return (TRUE);
 }
 
 
@@ -505,11 +786,12 @@ void free_pairs_list (void)
 //  have self intersections.
 // Returns a list of vectors, containing both the face normals
 //  of the object, and the vectors where the arcs intersect.
-nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
+nodePtr findArcIntersections (sphericalContextPtr context, nodePtr normalList, boolean* arcsIntersect)
 {
 	nodePtr		extendedNormalList = NULL;
-	nodePtr		extendedNormalListTail = NULL;
-	nodePtr		tmpList = NULL;
+	polygonArrayStruct	normals;
+	polygonArrayStruct	extendedNormals;
+	polygonArrayStruct	segment;
 	vectorPtr	vector1 = NULL;
 	vectorPtr	vector2 = NULL;
 	vectorPtr	vector3 = NULL;
@@ -518,12 +800,15 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 	vectorPtr	vector3_1 = NULL;
 	vectorPtr	tmpVector = NULL;
 	vectorPtr	intersection = NULL;
+	vectorPtr	arc_normals = NULL;
 	boolean		intersect = FALSE;
+	int*		candidates = NULL;
+	int*		offsets = NULL;
 	int			numNormals = getListLength (normalList);
+	int			numCandidates;
 	int			endpoint = 0;
-	int			tmpLength = 0;
 	int			counter = 1;
-	int			i, j;
+	int			i, j, k;
 #if (DEBUG >= 2)
 	int*		currentPair = NULL;
 #endif
@@ -536,10 +821,10 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 // printVectorList (normalList);
 
 	// Clear the arrays for the intersection pairs.
-	freeList (IntersectionPairs);
-	freeList (IntersectionPairsCopy);
-	IntersectionPairs = NULL;
-	IntersectionPairsCopy = NULL;
+	freeList (context->intersection_pairs);
+	freeList (context->intersection_pairs_copy);
+	context->intersection_pairs = NULL;
+	context->intersection_pairs_copy = NULL;
 
 	// With 3 normals or less, there can be no intersections.
 	// All possible cases must have been eliminated in
@@ -548,35 +833,57 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 	if (numNormals < 4)
 		return ( copyList (normalList, sizeof (vectorStruct)) );
 
+	normals = list_to_polygon_array (normalList);
+	extendedNormals = new_polygon_array (2 * numNormals);
+	segment = new_polygon_array (numNormals);
+
+	// The vector perpendicular to each arc is used in all
+	//  of its tests.
+	arc_normals = (vectorPtr) scratch_malloc (sizeof (vectorStruct) * numNormals);
+	for (i=0; i<numNormals; i++)
+		arc_normals[i] = cross_product (polygon_vector (&normals, i), polygon_vector (&normals, (i+1)%numNormals));
+
+	// Long polygons only test the pairs of arcs that may intersect.
+	if (numNormals >= MIN_ARCS_TO_SWEEP)
+		candidates = find_candidate_arc_pairs (&normals, arc_normals, &offsets);
+
 	// For each face around the vertex,
 	//  test its normal vector.
 	for (i=0; i<numNormals; i++)
 	{
-		vector1 = (vectorPtr) getNodeData (normalList, i);
-		vector2 = (vectorPtr) getNodeData (normalList, (i+1)%numNormals);
+		vector1 = polygon_vector (&normals, i);
+		vector2 = polygon_vector (&normals, (i+1)%numNormals);
 
 		// Reset the values for the insertion of
 		//  intersection points.
-		tmpList = NULL;
-		tmpLength = 0;
+		segment.length = 0;
 
 		// Insert the vector into the new list.
-		tmpVector = (vectorPtr) xmalloc (sizeof (vectorStruct));
+		tmpVector = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 		memcpy (tmpVector, vector1, sizeof (vectorStruct));
-		tmpList = addNode (tmpList, tmpVector);
-		tmpLength++;
+		append_polygon_vector (&segment, tmpVector);
 
 		// Test against all other segments.
-		for (j=0; j<numNormals; j++)
+		numCandidates = (candidates != NULL) ? offsets[i+1] - offsets[i] : numNormals;
+		for (k=0; k<numCandidates; k++)
 		{
+			j = (candidates != NULL) ? candidates[offsets[i] + k] : k;
+
 			// Check that the segments are not contiguous.
 			// There can be no intersection of contiguous segments.
 			if ( (i != (j+1)%numNormals) && ((i+1)%numNormals != j) && (i != j) )
 			{
-				vector3 = (vectorPtr) getNodeData (normalList, j);
-				vector4 = (vectorPtr) getNodeData (normalList, (j+1)%numNormals);
+				vector3 = polygon_vector (&normals, j);
+				vector4 = polygon_vector (&normals, (j+1)%numNormals);
+
+				// In long polygons, skip the arcs that are clearly
+				//  on one side of the other. Shorter ones test
+				//  every pair, as they always did.
+				if ( (candidates != NULL) &&
+						(!arc_crosses_plane (vector1, vector2, &arc_normals[j]) || !arc_crosses_plane (vector3, vector4, &arc_normals[i])) )
+					continue;
 
-				intersection = arcIntersection (vector1, vector2, vector3, vector4, &intersect, &endpoint);
+				intersection = arc_intersection_from_normals (vector1, vector2, &arc_normals[i], vector3, vector4, &arc_normals[j], &intersect, &endpoint);
 
 				// If there was any intersection.
 				if (intersect)
@@ -598,11 +905,10 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 
 							// Prepare the list of intersections for this segment.
 							// Also inserts the new vector into the list.
-							orderIntersectionsList (&tmpList, tmpLength, vector1, intersection);
-							tmpLength++;
+							orderIntersectionsList (&segment, vector1, intersection);
 
 							// Check if the new intersection matches a previous one.
-							matchIntersectionPairs (vector1->vectorId, vector2->vectorId, vector3->vectorId, vector4->vectorId, intersection->vectorId);
+							matchIntersectionPairs (context, vector1->vectorId, vector2->vectorId, vector3->vectorId, vector4->vectorId, intersection->vectorId);
 							counter++;
 							break;
 
@@ -611,20 +917,17 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 							// Mark the first vector as an intersection vector.
 							// The vector is already inserted as the first
 							//  element in the temporary list.
-							free (intersection);
-							intersection = (vectorPtr) tmpList->data;
+							scratch_free (intersection);
+							intersection = segment.vectors[0];
 							intersection->type = INTER;
 							intersection->num_intersections += 1;
 
 							// Get the new segment endpoints for the matching.
-							if (i != 0)
-								vector1_1 = (vectorPtr) getNodeData (normalList, (i-1)%numNormals);
-							else
-								vector1_1 = (vectorPtr) getNodeData (normalList, numNormals-1);
+							vector1_1 = polygon_vector (&normals, i-1);
 
 							// Check if the new intersection matches a previous one.
 							// Using the new endpoints to match the pair.
-							matchIntersectionPairs (vector1_1->vectorId, vector2->vectorId, vector3->vectorId, vector4->vectorId, intersection->vectorId);
+							matchIntersectionPairs (context, vector1_1->vectorId, vector2->vectorId, vector3->vectorId, vector4->vectorId, intersection->vectorId);
 							counter++;
 							break;
 
@@ -636,19 +939,15 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 							intersection->num_intersections = 1;
 
 							// Get the new segment endpoints for the matching.
-							if (j != 0)
-								vector3_1 = (vectorPtr) getNodeData (normalList, (j-1)%numNormals);
-							else
-								vector3_1 = (vectorPtr) getNodeData (normalList, numNormals-1);
+							vector3_1 = polygon_vector (&normals, j-1);
 
 							// Prepare the list of intersections for this segment.
 							// Also inserts the new vector into the list.
-							orderIntersectionsList (&tmpList, tmpLength, vector1, intersection);
-							tmpLength++;
+							orderIntersectionsList (&segment, vector1, intersection);
 
 							// Check if the new intersection matches a previous one.
 							// Using the new endpoints to match the pair.
-							matchIntersectionPairs (vector1->vectorId, vector2->vectorId, vector3_1->vectorId, vector4->vectorId, intersection->vectorId);
+							matchIntersectionPairs (context, vector1->vectorId, vector2->vectorId, vector3_1->vectorId, vector4->vectorId, intersection->vectorId);
 							counter++;
 							break;
 
@@ -660,21 +959,14 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 							// Mark the first vector as an intersection vector.
 							// The vector is already inserted as the first
 							//  element in the temporary list.
-							free (intersection);
-							intersection = (vectorPtr) tmpList->data;
+							scratch_free (intersection);
+							intersection = segment.vectors[0];
 							intersection->type = INTER;
 							intersection->num_intersections += 1;
 
 							// Get the new segment endpoints for testing and matching.
-							if (i != 0)
-								vector1_1 = (vectorPtr) getNodeData (normalList, (i-1)%numNormals);
-							else
-								vector1_1 = (vectorPtr) getNodeData (normalList, numNormals-1);
-
-							if (j != 0)
-								vector3_1 = (vectorPtr) getNodeData (normalList, (j-1)%numNormals);
-							else
-								vector3_1 = (vectorPtr) getNodeData (normalList, numNormals-1);
+							vector1_1 = polygon_vector (&normals, i-1);
+							vector3_1 = polygon_vector (&normals, j-1);
 
 							// Test that there really is an intersection of the new
 							//  segments in between the new endpoints,
@@ -690,7 +982,7 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 
 							// Check if the new intersection matches a previous one.
 							// Using the new endpoints to match the pair.
-							matchIntersectionPairs (vector1_1->vectorId, vector2->vectorId, vector3_1->vectorId, vector4->vectorId, intersection->vectorId);
+							matchIntersectionPairs (context, vector1_1->vectorId, vector2->vectorId, vector3_1->vectorId, vector4->vectorId, intersection->vectorId);
 // printf ("MATCHING: %d, SEGMENTS %d-%d, %d-%d\n", intersection->vectorId, vector1_1->vectorId, vector2->vectorId, vector3_1->vectorId, vector4->vectorId);
 							counter++;
 							break;
@@ -699,21 +991,32 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 							// Just free the memory allocated
 							//  to the intersection vector.
 							if (intersection != NULL)
-								free (intersection);
+								scratch_free (intersection);
 							break;
 
 					}	// switch (endpoint)
 				}	// if (intersect)
 			}	// if ( (i != (j+1)%numNormals) && ((i+1)%numNormals != j) )
-		}	// for (j=0; j<numNormals; j++)
+		}	// for (k=0; k<numCandidates; k++)
 
-		// Insert the temporary list into the final list of normals.
-		joinLists (&extendedNormalList, tmpList);
-		// Update the tail of the list.
-		extendedNormalListTail = getListTail (extendedNormalList);
+		// Insert the vectors of the segment into the final list of normals.
+		for (j=0; j<segment.length; j++)
+			append_polygon_vector (&extendedNormals, segment.vectors[j]);
 	}	// for (i=0; i<numNormals; i++)
 
-	prunePairsList (&extendedNormalList);
+	prunePairsList (context, &extendedNormals);
+
+	if (candidates != NULL)
+	{
+		scratch_free (candidates);
+		scratch_free (offsets);
+	}
+	scratch_free (arc_normals);
+
+	extendedNormalList = polygon_array_to_list (&extendedNormals);
+	free_polygon_array (&normals);
+	free_polygon_array (&extendedNormals);
+	free_polygon_array (&segment);
 
 #if (DEBUG >= 2)
 	printf ("\n\tNEW list of normals has %d elements\n", getListLength (extendedNormalList));
@@ -723,13 +1026,13 @@ nodePtr findArcIntersections (nodePtr normalList, boolean* arcsIntersect)
 		printf ("\t%3d = %.4f\t%.4f\t%.4f\n", vector1->vectorId, vector1->i, vector1->j, vector1->k);
 	}
 	printf ("\n\tINTERSECTION PAIRS:\n");
-	for (j=0; j<getListLength (IntersectionPairs); j++)
+	for (j=0; j<getListLength (context->intersection_pairs); j++)
 	{
-		currentPair = getNodeData (IntersectionPairs, j);
+		currentPair = getNodeData (context->intersection_pairs, j);
 		printf ("\tPair: %3d, %3d\n", currentPair[0], currentPair[1]);
 	}
 
-	printf ("\t%d INTERSECTIONS FOUND\n", getListLength (IntersectionPairs));
+	printf ("\t%d INTERSECTIONS FOUND\n", getListLength (context->intersection_pairs));
 #endif
 
 #if (DEBUG >= 1)
@@ -785,7 +1088,7 @@ boolean double_check_intersection (vectorPtr vector1_1, vectorPtr vector1, vecto
 //  'splitSphericalPolygon' for each possibility
 // Return the list of polygons that contains the
 //  polygon with the longest perimeter.
-nodePtr	testPolygonSplit (nodePtr polygonList, nodePtr normalList)
+nodePtr	testPolygonSplit (sphericalContextPtr context, nodePtr polygonList, nodePtr normalList)
 {
 	vectorPtr	vector = NULL;
 	nodePtr		results_list = NULL;
@@ -811,7 +1114,7 @@ nodePtr	testPolygonSplit (nodePtr polygonList, nodePtr normalList)
 		// If it is a normal vector.
 		if (vector->vectorId > 0)
 		{
-			results_list = splitSphericalPolygon (NULL, normalListCopy);
+			results_list = splitSphericalPolygon (context, NULL, normalListCopy);
 			num_polygons = getListLength (results_list);
 
 			concave_angle_total = 0;
@@ -862,7 +1165,7 @@ printf ("=== GOING BACK TO INDEX %d\n", largest_index);
 
 	// Call the function to split the polygons
 	//  one last time.
-	polygonList = splitSphericalPolygon (NULL, normalListCopy);
+	polygonList = splitSphericalPolygon (context, NULL, normalListCopy);
 
 	return (polygonList);
 }
@@ -872,20 +1175,22 @@ printf ("=== GOING BACK TO INDEX %d\n", largest_index);
 //  spherical polygon.
 double measure_spherical_polygon_perimeter (nodePtr polygon_list)
 {
+	polygonArrayStruct	polygon = list_to_polygon_array (polygon_list);
 	int				i;
-	int				list_length = getListLength (polygon_list);
 	double			perimeter = 0.0;
 	vectorPtr		vector1 = NULL;
 	vectorPtr		vector2 = NULL;
 
-	for (i=0; i<list_length; i++)
+	for (i=0; i<polygon.length; i++)
 	{
-		vector1 = (vectorPtr) getNodeData (polygon_list, i);
-		vector2 = (vectorPtr) getNodeData (polygon_list, (i+1)%list_length);
+		vector1 = polygon.vectors[i];
+		vector2 = polygon_vector (&polygon, i+1);
 
 		perimeter += angleBetweenVectors (vector1, vector2);
 	}
 
+	free_polygon_array (&polygon);
+
 	return (perimeter);
 }
 
@@ -895,8 +1200,8 @@ double measure_spherical_polygon_perimeter (nodePtr polygon_list)
 //  orientation, in the curve that delimits its perimeter.
 angleType find_spherical_polygon_orientation (nodePtr polygon_list, int* concave_angle_total)
 {
+	polygonArrayStruct	polygon = list_to_polygon_array (polygon_list);
 	int			i;
-	int			list_length = getListLength (polygon_list);
 	int			convex_angle_count = 0;
 	int			concave_angle_count = 0;
 	int			orientation_changes = 0;
@@ -908,11 +1213,11 @@ angleType find_spherical_polygon_orientation (nodePtr polygon_list, int* concave
 	spinType	angle_orientation;
 	spinType	previous_orientation = COL;
 
-	for (i=0; i<list_length; i++)
+	for (i=0; i<polygon.length; i++)
 	{
-		vector1 = (vectorPtr) getNodeData (polygon_list, i);
-		vector2 = (vectorPtr) getNodeData (polygon_list, (i+1)%list_length);
-		vector3 = (vectorPtr) getNodeData (polygon_list, (i+2)%list_length);
+		vector1 = polygon.vectors[i];
+		vector2 = polygon_vector (&polygon, i+1);
+		vector3 = polygon_vector (&polygon, i+2);
 
 		angle_orientation = sphereAngleOrientation (vector1, vector2, vector3, 2);
 		
@@ -941,6 +1246,8 @@ angleType find_spherical_polygon_orientation (nodePtr polygon_list, int* concave
 			concave_angle_count++;
 	}
 
+	free_polygon_array (&polygon);
+
 	printf ("CONVEX: %d, CONCAVE %d\n", convex_angle_count, concave_angle_count);
 
 	if (convex_change > concave_change)
@@ -977,10 +1284,10 @@ angleType find_spherical_polygon_orientation (nodePtr polygon_list, int* concave
 //  simple ones, removing any self intersections.
 // Return a list of lists of normals. Each list will
 //  represent a simple polygon.
-nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
+nodePtr splitSphericalPolygon (sphericalContextPtr context, nodePtr polygonList, nodePtr normalList)
 {
 	nodePtr		tmpList = NULL;
-	nodePtr		normalListCopy = copyList (normalList, sizeof (vectorStruct) );
+	polygonArrayStruct	polygon = copy_list_to_polygon_array (normalList);
 	vectorPtr	vector = NULL;
 	vectorPtr	tmpVector = NULL;
 	vectorPtr	tmpVector2 = NULL;
@@ -989,8 +1296,8 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 	int*		currentPair = NULL;
 	int*		intersectionIndex = NULL;
 	int*		visitedVertices = NULL;
-	int			listLength = getListLength (normalList); 
-	int			pairsLength = getListLength (IntersectionPairs); 
+	int			listLength = polygon.length;
+	int			pairsLength = getListLength (context->intersection_pairs); 
 	int			remainingPairs = pairsLength;
 	int			active_intersections = 0;
 	int			match_end;
@@ -1006,7 +1313,7 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 
 	// Make a copy of the list of pairs, to be used
 	//  when relabelling the vectors.
-	IntersectionPairsCopy = copyList (IntersectionPairs, sizeof (int) * 6);
+	context->intersection_pairs_copy = copyList (context->intersection_pairs, sizeof (int) * 6);
 
 #if (DEBUG >= 1)
 	printf ("  ->POLYGON SPLITTING:\n"); fflush (stdout);
@@ -1015,21 +1322,21 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 	// Allocate memory for an array that will store
 	//  the indexes in the list of vectors where
 	//  the intersection vectors are found.
-	intersectionIndex = (int*) xmalloc ( sizeof (int) * pairsLength);
+	intersectionIndex = (int*) scratch_malloc ( sizeof (int) * pairsLength);
 	memset (intersectionIndex, 0, sizeof (int) * pairsLength);
 	// Memory for an array of the vertices visited,
 	//  between each pair.
-	visitedVertices = (int*) xmalloc ( sizeof (int) * pairsLength);
+	visitedVertices = (int*) scratch_malloc ( sizeof (int) * pairsLength);
 	memset (visitedVertices, 0, sizeof (int) * pairsLength);
 
 	i = 0;
 
-	while (IntersectionPairsCopy != NULL)
+	while (context->intersection_pairs_copy != NULL)
 	{
 		// Allow 'i' to loop around the list.
 		i = i % listLength;
 
-		vector = (vectorPtr) getNodeData (normalListCopy, i);
+		vector = split_polygon_vector (&polygon, i);
 
 		// Find an unvisited intersection vector.
 		if (vector->num_intersections > 0)
@@ -1041,13 +1348,13 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 			// Compare against the previously visited intersections.
 			for (j=0; j<active_intersections; j++)
 			{
-				tmpVector = (vectorPtr) getNodeData (normalListCopy, intersectionIndex[j]);
+				tmpVector = split_polygon_vector (&polygon, intersectionIndex[j]);
 
 				// If the loop has closed, by visiting an
 				//  intersection vector for the 2nd time.
 				for (k=0; k<remainingPairs; k++)
 				{
-					currentPair = (int*) getNodeData (IntersectionPairsCopy, k);
+					currentPair = (int*) getNodeData (context->intersection_pairs_copy, k);
 					if (	( (vector->vectorId == currentPair[0]) && (tmpVector->vectorId == currentPair[1]) ) ||
 							( (vector->vectorId == currentPair[1]) && (tmpVector->vectorId == currentPair[0]) )		)
 					{
@@ -1062,8 +1369,8 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 							matchIndex = j;
 							match_vector_id = tmpVector->vectorId;
 							// Remove the pair from the list.
-							removeNode (&IntersectionPairsCopy, k);
-							free (currentPair);
+							removeNode (&(context->intersection_pairs_copy), k);
+							scratch_free (currentPair);
 							remainingPairs--;
 						}
 						// Do not process this polygon, but note
@@ -1096,13 +1403,13 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 				// For each intersection vertex found.
 				for (j=matchIndex; j<active_intersections; j++)
 				{
-					tmpVector = (vectorPtr) getNodeData (normalListCopy, intersectionIndex[j]);
+					tmpVector = split_polygon_vector (&polygon, intersectionIndex[j]);
 					// For each of the remaining intersection
 					//  vectors in the input list.
 					for (k=match_end; k<listLength && (tmpVector->num_intersections > 0); k++)
 					// for (k=match_end; k<listLength && (tmpVector->type == INTER); k++)
 					{
-						tmpVector2 = (vectorPtr) getNodeData (normalListCopy, k);
+						tmpVector2 = split_polygon_vector (&polygon, k);
 
 						// For each of the pairs of intersections.
 						for (l=0; l<remainingPairs && (tmpVector2->num_intersections > 0); l++)
@@ -1113,7 +1420,7 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 						//  (case 5:) in findArcIntersections.
 						// for (l=0; l<remainingPairs && (tmpVector2->type == INTER) && ( !equalVectors (tmpVector2, vector) ); l++)
 						{
-							currentPair = (int*) getNodeData (IntersectionPairsCopy, l);
+							currentPair = (int*) getNodeData (context->intersection_pairs_copy, l);
 
 							if (	( (tmpVector->vectorId == currentPair[0]) && (tmpVector2->vectorId == currentPair[1]) ) ||
 									( (tmpVector->vectorId == currentPair[1]) && (tmpVector2->vectorId == currentPair[0]) )		)
@@ -1123,8 +1430,8 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 									tmpVector2->type = VISITED;
 								// Remove the pair from the list.
 // printf ("Removing intersection pair %d %d\n", currentPair[0], currentPair[1]);
-								removeNode (&IntersectionPairsCopy, l);
-								free (currentPair);
+								removeNode (&(context->intersection_pairs_copy), l);
+								scratch_free (currentPair);
 								remainingPairs--;
 								break;
 							}
@@ -1145,10 +1452,10 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 					nextElement = (listLength + k) % listLength;
 
 					// Skip vectors which are the same as the intersection vectors.
-					tmpVector = (vectorPtr) getNodeData (normalListCopy, nextElement);
+					tmpVector = polygon.vectors[nextElement];
 					if ( !equalVectors (tmpVector, vector) )
 					{
-						tmpVector = (vectorPtr) removeNode (&normalListCopy, nextElement);
+						tmpVector = remove_polygon_vector (&polygon, nextElement);
 						tmpList = addFrontNode (tmpList, tmpVector);
 						// Set the vector as no longer having intersections
 						tmpVector->num_intersections = 0;
@@ -1162,7 +1469,7 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 				//  the beginning of the loop just found.
 				//  k = match_begin
 				nextElement = (listLength + k) % listLength;
-				tmpVector = (vectorPtr) removeNode (&normalListCopy, nextElement);
+				tmpVector = remove_polygon_vector (&polygon, nextElement);
 				// Mark the vector as the match pair.
 				tmpVector->type = SPLIT;
 				tmpList = addFrontNode (tmpList, tmpVector);
@@ -1211,30 +1518,31 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 		}
 
 		// Check that all the vectors mentioned in
-		//  the pairs are still in 'normalListCopy'.
+		//  the pairs are still in the polygon.
 		// Otherwise, eliminate the pair.
-		discard_redundant_pairs (&remainingPairs, normalListCopy, listLength);
+		discard_redundant_pairs (context, &remainingPairs, &polygon);
 
 		i++;
-	}	// while (IntersectionPairsCopy != NULL)
+	}	// while (context->intersection_pairs_copy != NULL)
 
 #if (DEBUG >= 2)
-	printf ("\t** ADDING FINAL POLYGON OF %d VERTICES\n", getListLength (normalListCopy));
+	printf ("\t** ADDING FINAL POLYGON OF %d VERTICES\n", polygon.length);
 #endif
 #if (DEBUG >= 3)
-	printVectorList (normalListCopy);
+	printVectorList (polygon_array_to_list (&polygon));
 #endif
 	// Insert the remaining vectors into the list of lists.
 	// These will form another polygon.
-	polygonList = addFrontNode (polygonList, normalListCopy);
+	polygonList = addFrontNode (polygonList, polygon_array_to_list (&polygon));
 
 #if (DEBUG >= 2)
 	printf ("\t%d POLYGONS FOUND\n", getListLength (polygonList) );
 #endif
 
 	// Deallocate memory.
-	free (intersectionIndex);
-	free (visitedVertices);
+	scratch_free (intersectionIndex);
+	scratch_free (visitedVertices);
+	free_polygon_array (&polygon);
 
 #if (DEBUG >= 1)
 	printf ("  ->POLYGON SPLITTING - DONE!\n\n"); fflush (stdout);
@@ -1244,9 +1552,22 @@ nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList)
 }
 
 
+// Get a vector of the polygon being split.
+// Going back to the last intersection can leave the
+//  position before the beginning of the polygon. Those
+//  positions refer to the first vector.
+vectorPtr split_polygon_vector (polygonArrayPtr polygon, int index)
+{
+	if (index < 0)
+		index = 0;
+
+	return (polygon->vectors[index]);
+}
+
+
 // Delete from the list of pairs those for which the
 //  vectors involved are no longer present in the list.
-void discard_redundant_pairs (int* remainingPairs, nodePtr normalList, int listLength)
+void discard_redundant_pairs (sphericalContextPtr context, int* remainingPairs, polygonArrayPtr polygon)
 {
 	boolean		still_inside_0 = FALSE;
 	boolean		still_inside_1 = FALSE;
@@ -1259,11 +1580,11 @@ void discard_redundant_pairs (int* remainingPairs, nodePtr normalList, int listL
 		still_inside_0 = FALSE;
 		still_inside_1 = FALSE;
 
-		currentPair = (int*) getNodeData (IntersectionPairsCopy, i);
+		currentPair = (int*) getNodeData (context->intersection_pairs_copy, i);
 
-		for (j=0; j<listLength; j++)
+		for (j=0; j<polygon->length; j++)
 		{
-			vector = (vectorPtr) getNodeData (normalList, j);
+			vector = polygon->vectors[j];
 
 			if (vector->vectorId == currentPair[0])
 				still_inside_0 = TRUE;
@@ -1278,8 +1599,8 @@ void discard_redundant_pairs (int* remainingPairs, nodePtr normalList, int listL
 printf ("\tDiscarding pair of intersections %d and %d\n", currentPair[0], currentPair[1]);
 #endif
 			// Remove the pair from the list.
-			removeNode (&IntersectionPairsCopy, i);
-			free (currentPair);
+			removeNode (&(context->intersection_pairs_copy), i);
+			scratch_free (currentPair);
 			*remainingPairs -= 1;
 		}
 	}
@@ -1292,6 +1613,7 @@ printf ("\tDiscarding pair of intersections %d and %d\n", currentPair[0], curren
 // The normals are unit vectors, all beginning at the origin.
 double findSphericalPolygonArea (nodePtr normalList, spinType* orientation, boolean c_h_vertex, vertexPtr coneVertexArray, int coneVertexArrayLength)
 {
+	polygonArrayStruct	polygon;
 	vectorPtr	vector1 = NULL;
 	vectorPtr	vector2 = NULL;
 	vectorPtr	vector3 = NULL;
@@ -1337,14 +1659,16 @@ area = ( sumAngles - (numNormals-2) * PI ) ;// * radius * radius;		// Skip multi
 		return (0.0);
 	}
 
+	polygon = list_to_polygon_array (normalList);
+
 	// Find the area of the polygon, considering
 	//  a positive orientation.
 	*orientation = CCW;
 	for (i=0; i<numNormals; i++)
 	{
-		vector1 = (vectorPtr) getNodeData (normalList, i);
-		vector2 = (vectorPtr) getNodeData (normalList, (i+1)%numNormals);
-		vector3 = (vectorPtr) getNodeData (normalList, (i+2)%numNormals);
+		vector1 = polygon.vectors[i];
+		vector2 = polygon_vector (&polygon, i+1);
+		vector3 = polygon_vector (&polygon, i+2);
 
 		arcLength += angleBetweenVectors (vector1, vector2);
 
@@ -1359,6 +1683,7 @@ area = ( sumAngles - (numNormals-2) * PI ) ;// * radius * radius;		// Skip multi
 	// This is the case when several arcs intersect at the same place.
 	if ( arcLength < (0 + EPSILON) )
 	{
+		free_polygon_array (&polygon);
 		*orientation = COL;
 		return (0.0);
 	}
@@ -1393,9 +1718,9 @@ area = ( sumAngles - (numNormals-2) * PI ) ;// * radius * radius;		// Skip multi
 		// Recompute possible area.
 		for (i=0; i<numNormals; i++)
 		{
-			vector1 = (vectorPtr) getNodeData (normalList, i);
-			vector2 = (vectorPtr) getNodeData (normalList, (i+1)%numNormals);
-			vector3 = (vectorPtr) getNodeData (normalList, (i+2)%numNormals);
+			vector1 = polygon.vectors[i];
+			vector2 = polygon_vector (&polygon, i+1);
+			vector3 = polygon_vector (&polygon, i+2);
 
 			sumAngles += findSphericalAngle (vector1, vector2, vector3, *orientation, &angle_orientation);
 		}
@@ -1403,6 +1728,8 @@ area = ( sumAngles - (numNormals-2) * PI ) ;// * radius * radius;		// Skip multi
 		area = ( sumAngles - (numNormals-2) * PI ) ;// * radius * radius;		// Skip multiplications since radius = 1.0
 	}
 
+	free_polygon_array (&polygon);
+
 #if (DEBUG >= 2)
 	printf ("\tSum of angles: %f (%.2f PI) // Total Area: ", sumAngles, sumAngles/PI);
 
@@ -1423,9 +1750,9 @@ area = ( sumAngles - (numNormals-2) * PI ) ;// * radius * radius;		// Skip multi
 // Returns COL, CW or CCW.
 spinType sphereAngleOrientation (vectorPtr vector1, vectorPtr vector2, vectorPtr vector3, int type)
 {
-	vectorPtr	tangent1 = NULL;
-	vectorPtr	tangent2 = NULL;
-	vectorPtr	orientationVector = NULL;
+	vectorStruct	tangent1;
+	vectorStruct	tangent2;
+	vectorStruct	orientationVector;
 	double		product = 0;
 	spinType	spinOrientation;
 
@@ -1445,19 +1772,19 @@ spinType sphereAngleOrientation (vectorPtr vector1, vectorPtr vector2, vectorPtr
 	{
 		// Switch the direction of the first tangent, to preserve the
 		//  direction of the curve.
-		tangent1->i *= -1;
-		tangent1->j *= -1;
-		tangent1->k *= -1;
+		tangent1.i *= -1;
+		tangent1.j *= -1;
+		tangent1.k *= -1;
 	}
 
-	if ( equalVectors (tangent1, tangent2) )
+	if ( equalVectors (&tangent1, &tangent2) )
 		spinOrientation = COL;
 	else
 	{
 		// Get their cross product and normalise it.
-		orientationVector = crossProduct (tangent1, tangent2);
+		orientationVector = cross_product (&tangent1, &tangent2);
 
-		product = dotProduct (vector2, orientationVector);
+		product = dotProduct (vector2, &orientationVector);
 
 		// If the dot product is less than zero,
 		//  the orientation of the angle is Clockwise.
@@ -1467,11 +1794,6 @@ spinType sphereAngleOrientation (vectorPtr vector1, vectorPtr vector2, vectorPtr
 			spinOrientation = CCW;
 	}
 
-	// Deallocate the memory used.
-	free (tangent1);
-	free (tangent2);
-	free (orientationVector);
-
 	return (spinOrientation);
 }
 
@@ -1481,20 +1803,20 @@ spinType sphereAngleOrientation (vectorPtr vector1, vectorPtr vector2, vectorPtr
 //  at the middle vector. (vector2)
 double findSphericalAngle (vectorPtr vector1, vectorPtr vector2, vectorPtr vector3, spinType polygonOrientation, angleType* angleOrientation)
 {
-	vectorPtr	tangent1 = NULL;
-	vectorPtr	tangent2 = NULL;
+	vectorStruct	tangent1;
+	vectorStruct	tangent2;
 	double		angle;
 	double		finalAngle;
 	spinType	orientation;
 
 	// The angle between the normals of the planes is the same
 	//  as the angle between the tangent vectors to those planes.
-	tangent1 = crossProduct (vector1, vector2);
-	tangent2 = crossProduct (vector2, vector3);
+	tangent1 = cross_product (vector1, vector2);
+	tangent2 = cross_product (vector2, vector3);
 	// tangent1 = findSphereTangent (vector2, vector1);
 	// tangent2 = findSphereTangent (vector2, vector3);
 
-	angle = angleBetweenVectors (tangent1, tangent2);
+	angle = angleBetweenVectors (&tangent1, &tangent2);
 
 	// Find the orientation of the tangent vectors.
 	orientation = sphereAngleOrientation (vector1, vector2, vector3, 2);
@@ -1540,26 +1862,20 @@ double findSphericalAngle (vectorPtr vector1, vectorPtr vector2, vectorPtr vecto
 
 	// printf ("VECTOR %3d: ANGLE = %lf\tFINAL = %lf\tORIENT = %d\n", vector2->vectorId, angle, finalAngle, *angleOrientation);
 
-	free (tangent1);
-	free (tangent2);
-
 	return (finalAngle);
 }
 
 
 // Find a vector tangent to a sphere, that lies on the same plane
 //  as two radius vectors of the unit sphere.
-vectorPtr findSphereTangent (vectorPtr mainVector, vectorPtr referenceVector)
+// The tangent is returned by value.
+vectorStruct findSphereTangent (vectorPtr mainVector, vectorPtr referenceVector)
 {
-	vectorPtr	normalVector = NULL;
-	vectorPtr	tangentVector = NULL;
-
-	normalVector = crossProduct (mainVector, referenceVector);
-	tangentVector = crossProduct (normalVector, mainVector);
+	vectorStruct	normalVector;
 
-	free (normalVector);
+	normalVector = cross_product (mainVector, referenceVector);
 
-	return (tangentVector);
+	return (cross_product (&normalVector, mainVector));
 }
 
 
@@ -1570,40 +1886,46 @@ vectorPtr findSphereTangent (vectorPtr mainVector, vectorPtr referenceVector)
 //  arcs do not intersect.
 vectorPtr arcIntersection (vectorPtr arc1vector1, vectorPtr arc1vector2, vectorPtr arc2vector1, vectorPtr arc2vector2, boolean* intersect, int* endpoint)
 {
-	vectorPtr		arc1_normal = NULL;
-	vectorPtr		arc2_normal = NULL;
-	vectorPtr		cross1_i = NULL;
-	vectorPtr		crossi_2 = NULL;
-	vectorPtr		cross3_i = NULL;
-	vectorPtr		crossi_4 = NULL;
-	vectorPtr		intersectionArc1 = NULL;
-	vectorPtr		intersectionArc2 = NULL;
+	vectorStruct	arc1_normal;
+	vectorStruct	arc2_normal;
+
+	// Get the vectors perpendicular to the arcs.
+	arc1_normal = cross_product (arc1vector1, arc1vector2);
+	arc2_normal = cross_product (arc2vector1, arc2vector2);
+
+	return (arc_intersection_from_normals (arc1vector1, arc1vector2, &arc1_normal, arc2vector1, arc2vector2, &arc2_normal, intersect, endpoint));
+}
+
+
+// Same as 'arcIntersection', with the vectors perpendicular
+//  to the arcs already computed.
+vectorPtr arc_intersection_from_normals (vectorPtr arc1vector1, vectorPtr arc1vector2, vectorPtr arc1_normal, vectorPtr arc2vector1, vectorPtr arc2vector2, vectorPtr arc2_normal, boolean* intersect, int* endpoint)
+{
+	vectorStruct	cross1_i;
+	vectorStruct	crossi_2;
+	vectorStruct	cross3_i;
+	vectorStruct	crossi_4;
+	vectorStruct	intersectionArc1;
+	vectorStruct	intersectionArc2;
+	vectorPtr		intersection = NULL;
+	boolean			inside_arc1 = FALSE;
+	boolean			inside_arc2 = FALSE;
 	double			dotArc1;
 	double			dotArc2;
 
 	*intersect = FALSE;
 	*endpoint = 0;
 
-	// Get the vectors perpendicular to the arcs.
-	arc1_normal = crossProduct (arc1vector1, arc1vector2);
-	arc2_normal = crossProduct (arc2vector1, arc2vector2);
-
 	// The intersection points are given by the cross product of the
 	//  "normals" to the arcs.
-	intersectionArc1 = crossProduct (arc1_normal, arc2_normal);
-	intersectionArc2 = crossProduct (arc1_normal, arc2_normal);
+	intersectionArc1 = cross_product (arc1_normal, arc2_normal);
+	intersectionArc2 = intersectionArc1;
 
 	// If the vector for the intersection is equal to zero,
 	//  don't do anything else.
 	// Happens if the two arcs lie on the same plane.
-	if ( (intersectionArc1->i == 0) && (intersectionArc1->j == 0) && (intersectionArc1->k == 0) )
-	{
-		free (arc1_normal);
-		free (arc2_normal);
-		free (intersectionArc1);
-		free (intersectionArc2);
+	if ( (intersectionArc1.i == 0) && (intersectionArc1.j == 0) && (intersectionArc1.k == 0) )
 		return (NULL);
-	}
 
 	// Trial solution for PROGRAM_ERROR: 016 (01 / 08 / 2006)
 	// Two arcs that are coplanar should not have
@@ -1611,118 +1933,87 @@ vectorPtr arcIntersection (vectorPtr arc1vector1, vectorPtr arc1vector2, vectorP
 	//  when there are two or more independent areas
 	//  in the gauss map.
 	if ( colinearVectors (arc1_normal, arc2_normal) )
-	{
-		free (arc1_normal);
-		free (arc2_normal);
-		free (intersectionArc1);
-		free (intersectionArc2);
 		return (NULL);
-	}
 
 
 	// Get the cross products of the intersections and the
 	//  endpoints of the arcs.
-	cross1_i = crossProduct (arc1vector1, intersectionArc1);
-	crossi_2 = crossProduct (intersectionArc1, arc1vector2);
-	cross3_i = crossProduct (arc2vector1, intersectionArc2);
-	crossi_4 = crossProduct (intersectionArc2, arc2vector2);
+	cross1_i = cross_product (arc1vector1, &intersectionArc1);
+	crossi_2 = cross_product (&intersectionArc1, arc1vector2);
+	cross3_i = cross_product (arc2vector1, &intersectionArc2);
+	crossi_4 = cross_product (&intersectionArc2, arc2vector2);
 
 	// Check for special cases when the intersection may
 	//  occur at the endpoint of one of the segments.
-	if ( colinearVectors (arc1vector1, intersectionArc1) )
+	if ( colinearVectors (arc1vector1, &intersectionArc1) )
 	{
-		free (cross1_i);
-		cross1_i = (vectorPtr) xmalloc (sizeof (vectorStruct));
-		memcpy (cross1_i, crossi_2, sizeof (vectorStruct));
+		cross1_i = crossi_2;
 		*endpoint |= 1;		// Intersection at vector1
 	}
-	if ( colinearVectors (arc1vector2, intersectionArc1) )
+	if ( colinearVectors (arc1vector2, &intersectionArc1) )
 	{
-		free (crossi_2);
-		crossi_2 = (vectorPtr) xmalloc (sizeof (vectorStruct));
-		memcpy (crossi_2, cross1_i, sizeof (vectorStruct));
+		crossi_2 = cross1_i;
 		*endpoint |= 2;		// Intersection at vector2
 	}
-	if ( colinearVectors (arc2vector1, intersectionArc2) )
+	if ( colinearVectors (arc2vector1, &intersectionArc2) )
 	{
-		free (cross3_i);
-		cross3_i = (vectorPtr) xmalloc (sizeof (vectorStruct));
-		memcpy (cross3_i, crossi_4, sizeof (vectorStruct));
+		cross3_i = crossi_4;
 		*endpoint |= 4;		// Intersection at vector3
 	}
-	if ( colinearVectors (arc2vector2, intersectionArc1) )
+	if ( colinearVectors (arc2vector2, &intersectionArc1) )
 	{
-		free (crossi_4);
-		crossi_4 = (vectorPtr) xmalloc (sizeof (vectorStruct));
-		memcpy (crossi_4, cross3_i, sizeof (vectorStruct));
+		crossi_4 = cross3_i;
 		*endpoint |= 8;		// Intersection at vector4
 	}
 
 	// The intersection lies within the arc, only if the cross
 	//  products are equal.
-	if ( equalVectors(cross1_i, crossi_2) )
+	if ( equalVectors(&cross1_i, &crossi_2) )
 	{
+		inside_arc1 = TRUE;
+
 		// If the intersection vector is opposite of the arc.
-		dotArc1  = dotProduct (intersectionArc1, arc1vector1);
-		dotArc1 += dotProduct (intersectionArc1, arc1vector2);
+		dotArc1  = dotProduct (&intersectionArc1, arc1vector1);
+		dotArc1 += dotProduct (&intersectionArc1, arc1vector2);
 
 		if (dotArc1 < 0)
 		{
 			// Invert the direction of the vector.
-			intersectionArc1->i *= -1;
-			intersectionArc1->j *= -1;
-			intersectionArc1->k *= -1;
+			intersectionArc1.i *= -1;
+			intersectionArc1.j *= -1;
+			intersectionArc1.k *= -1;
 		}
 	}
-	else
-	{
-		free (intersectionArc1);
-		intersectionArc1 = NULL;
-	}
 
 	// The intersection lies within the arc, only if the cross
 	//  products are equal.
-	if ( equalVectors(cross3_i, crossi_4) )
+	if ( equalVectors(&cross3_i, &crossi_4) )
 	{
+		inside_arc2 = TRUE;
+
 		// If the intersection vector is opposite of the arc.
-		dotArc2  = dotProduct (intersectionArc2, arc2vector1);
-		dotArc2 += dotProduct (intersectionArc2, arc2vector2);
+		dotArc2  = dotProduct (&intersectionArc2, arc2vector1);
+		dotArc2 += dotProduct (&intersectionArc2, arc2vector2);
 
 		if (dotArc2 < 0)
 		{
 			// Invert the direction of the vector.
-			intersectionArc2->i *= -1;
-			intersectionArc2->j *= -1;
-			intersectionArc2->k *= -1;
+			intersectionArc2.i *= -1;
+			intersectionArc2.j *= -1;
+			intersectionArc2.k *= -1;
 		}
 	}
-	else
-	{
-		free (intersectionArc2);
-		intersectionArc2 = NULL;
-	}
-
-	// Free the memory allocated for the temporary vectors.
-	free (arc1_normal);
-	free (arc2_normal);
-	free (cross1_i);
-	free (crossi_2);
-	free (cross3_i);
-	free (crossi_4);
 
 	// Check that the two intersection vectors exist and are equal.
-	if ( intersectionArc1 && intersectionArc2 && equalVectors(intersectionArc1, intersectionArc2) )
+	// Only then is memory allocated for the vector returned.
+	if ( inside_arc1 && inside_arc2 && equalVectors(&intersectionArc1, &intersectionArc2) )
 	{
 		*intersect = TRUE;
-		free (intersectionArc2);
-		return (intersectionArc1);
-	}
-	else
-	{
-		free (intersectionArc1);
-		free (intersectionArc2);
-		return (NULL);
+		intersection = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
+		*intersection = intersectionArc1;
 	}
+
+	return (intersection);
 }
 
 
@@ -1732,6 +2023,7 @@ vectorPtr arcIntersection (vectorPtr arc1vector1, vectorPtr arc1vector2, vectorP
 //  the useless vertices.
 nodePtr remove_collinear_vertices (nodePtr polygonList)
 {
+	polygonArrayStruct	polygon = list_to_polygon_array (polygonList);
 	nodePtr		newList = NULL;
 	nodePtr		newListTail = NULL;
 	vectorPtr	vertex1 = NULL;
@@ -1740,40 +2032,43 @@ nodePtr remove_collinear_vertices (nodePtr polygonList)
 	vectorPtr	vertex4 = NULL;
 	vectorPtr	leanVertex = NULL;
 	spinType	orientation;
-	int			listLength = getListLength (polygonList);
+	int			listLength = polygon.length;
 	int			i;
 
 	// Insert the first element of a list.
-	vertex2 = (vectorPtr) getNodeData (polygonList, 0);
-	leanVertex = (vectorPtr) xmalloc (sizeof (vectorStruct));
+	vertex2 = polygon.vectors[0];
+	leanVertex = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 	memcpy (leanVertex, vertex2, sizeof (vectorStruct));
 	newListTail = addNode (newListTail, leanVertex);
 	newList = newListTail;
 
 	for (i=1; i<listLength; i++)
 	{
-		vertex1 = (vectorPtr) getNodeData (polygonList, (listLength-1+i)%listLength);
-		vertex2 = (vectorPtr) getNodeData (polygonList, i);
-		vertex3 = (vectorPtr) getNodeData (polygonList, (i+1)%listLength);
-		vertex4 = (vectorPtr) getNodeData (polygonList, (i+2)%listLength);
+		vertex1 = polygon_vector (&polygon, i-1);
+		vertex2 = polygon.vectors[i];
+		vertex3 = polygon_vector (&polygon, i+1);
+		vertex4 = polygon_vector (&polygon, i+2);
 
 		orientation = sphereAngleOrientation (vertex1, vertex2, vertex3, 2);
 
 		if ( (orientation != COL) || (!colinearVectors (vertex2, vertex4)) )
 		{
-			leanVertex = (vectorPtr) xmalloc (sizeof (vectorStruct));
+			leanVertex = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 			memcpy (leanVertex, vertex2, sizeof (vectorStruct));
 			newListTail = addNode (newListTail, leanVertex);
 		}
 	}
 
+	free_polygon_array (&polygon);
+
 	return (newList);
 }
 
 
 // Divide a spherical polygon into triangles,
 //  to facilitate its rendering.
-void triangulateSphericalPolygon (nodePtr polygonList, spinType polygonOrientation)
+// The triangles are added to the list of the context.
+void triangulateSphericalPolygon (sphericalContextPtr context, nodePtr polygonList, spinType polygonOrientation)
 {
 	nodePtr		part1List = NULL;
 	nodePtr		part2List = NULL;
@@ -1781,13 +2076,13 @@ void triangulateSphericalPolygon (nodePtr polygonList, spinType polygonOrientati
 
 	if (listLength <= 3)
 	{
-		PolygonTriangles = addFrontNode (PolygonTriangles, polygonList);
+		context->polygon_triangles = addFrontNode (context->polygon_triangles, polygonList);
 	}
 	else
 	{
 		divideSphericalPolygon (polygonList, &part1List, &part2List, polygonOrientation);
-		triangulateSphericalPolygon (part1List, polygonOrientation);
-		triangulateSphericalPolygon (part2List, polygonOrientation);
+		triangulateSphericalPolygon (context, part1List, polygonOrientation);
+		triangulateSphericalPolygon (context, part2List, polygonOrientation);
 	}
 }
 
@@ -1798,6 +2093,7 @@ void triangulateSphericalPolygon (nodePtr polygonList, spinType polygonOrientati
 //  belong to both of the polygons.
 void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* part2List, spinType polygonOrientation)
 {
+	polygonArrayStruct	polygon = list_to_polygon_array (polygonList);
 	vectorPtr		vertex1 = NULL;
 	vectorPtr		vertex2 = NULL;
 	vectorPtr		vertex3 = NULL;
@@ -1805,7 +2101,7 @@ void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* p
 	vectorPtr		tmpVertex = NULL;
 	vertexStruct	point1;
 	vertexStruct	point2;
-	int				listLength = getListLength (polygonList);
+	int				listLength = polygon.length;
 	int				i, j;
 	int				closest = 0;
 	spinType		orientation;
@@ -1815,9 +2111,9 @@ void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* p
 
 	for (i=0; i<listLength; i++)
 	{
-		vertex1 = (vectorPtr) getNodeData (polygonList, (listLength-1+i)%listLength);
-		vertex2 = (vectorPtr) getNodeData (polygonList, i);
-		vertex3 = (vectorPtr) getNodeData (polygonList, (i+1)%listLength);
+		vertex1 = polygon_vector (&polygon, i-1);
+		vertex2 = polygon.vectors[i];
+		vertex3 = polygon_vector (&polygon, i+1);
 
 		orientation = sphereAngleOrientation (vertex1, vertex2, vertex3, 2);
 
@@ -1828,7 +2124,7 @@ void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* p
 			//  formed by the 3 vertices.
 			for (j=0; j<listLength; j++)
 			{
-				vertex4 = (vectorPtr) getNodeData (polygonList, j);
+				vertex4 = polygon.vectors[j];
 
 				if ( !(	equalVectors(vertex1, vertex4) ||
 						equalVectors(vertex2, vertex4) ||
@@ -1867,8 +2163,8 @@ void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* p
 
 				// Copy one of the vertices that will belong to
 				//  both new polygons.
-				vertex4 = (vectorPtr) getNodeData (polygonList, closest);
-				tmpVertex = (vectorPtr) xmalloc (sizeof (vectorStruct));
+				vertex4 = polygon.vectors[closest];
+				tmpVertex = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 				memcpy (tmpVertex, vertex4, sizeof (vectorStruct));
 				*part2List = addFrontNode (*part2List, tmpVertex);
 
@@ -1883,7 +2179,7 @@ void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* p
 
 				// Copy the second of the vertices that will belong to
 				//  both new polygons.
-				tmpVertex = (vectorPtr) xmalloc (sizeof (vectorStruct));
+				tmpVertex = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 				memcpy (tmpVertex, vertex2, sizeof (vectorStruct));
 				*part2List = addFrontNode (*part2List, tmpVertex);
 			}
@@ -1891,13 +2187,13 @@ void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* p
 			{
 				// Copy one of the vertices that will belong to
 				//  both new polygons.
-				tmpVertex = (vectorPtr) xmalloc (sizeof (vectorStruct));
+				tmpVertex = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 				memcpy (tmpVertex, vertex1, sizeof (vectorStruct));
 				*part1List = addFrontNode (*part1List, tmpVertex);
 
 				// Copy the second of the vertices that will belong to
 				//  both new polygons.
-				tmpVertex = (vectorPtr) xmalloc (sizeof (vectorStruct));
+				tmpVertex = (vectorPtr) scratch_malloc (sizeof (vectorStruct));
 				memcpy (tmpVertex, vertex3, sizeof (vectorStruct));
 				*part1List = addFrontNode (*part1List, tmpVertex);
 
@@ -1912,6 +2208,9 @@ void divideSphericalPolygon (nodePtr polygonList, nodePtr* part1List, nodePtr* p
 			break;
 		}	// if ( (orientation == polygonOrientation) && (listLength > 3) )
 	}	// for (i=0; i<listLength; i++)
+
+	// The lists were changed, so the array is no longer valid.
+	free_polygon_array (&polygon);
 }
 
 
@@ -1,11 +1,40 @@
+// Data structures
+
+// SPHERICAL GEOMETRY CONTEXT
+// Intersections found between the arcs of a spherical polygon,
+//  used while the polygon is split into simple ones.
+// Each pair is an array of 6 integers:
+// [0] vector Id of intersection 1
+// [1] vector Id of intersection 2
+// [2] endpoint of arc 1
+// [3] endpoint of arc 1
+// [4] endpoint of arc 2
+// [5] endpoint of arc 2
+// Every polygon processed at the same time needs its own context.
+// A context filled with zeros is empty and ready to use.
+typedef struct sphericalContextStruct
+{
+	nodePtr		intersection_pairs;
+	// Copy of the pairs, consumed while splitting the polygon.
+	nodePtr		intersection_pairs_copy;
+	// Triangles of a polygon, for its display.
+	nodePtr		polygon_triangles;
+} sphericalContextStruct;
+
+typedef sphericalContextStruct* sphericalContextPtr;
+
+
+// Function declarations
+
 // Extract the normals from a list of faces.
 // Return a list with only the normals of the faces.
-nodePtr getFaceNormalList (nodePtr faceList, facePtr faceArray, int* numNormals, int vertex_index, nodePtr* feature_edge_list);
+nodePtr getFaceNormalList (int* faceIndices, int numFaces, facePtr faceArray, int* numNormals, int vertex_index, nodePtr* feature_edge_list);
 
 
 // Add extra vectors between pairs of opposite vectors.
 // When two faces lie on the same plane, but in contrary directions.
-void check_opposite_vectors (nodePtr normal_list, facePtr faceArray, vertexPtr vertexArray, int* numNormals);
+// The faces are not changed, so they need not begin with the vertex.
+void check_opposite_vectors (nodePtr normal_list, facePtr faceArray, vertexPtr vertexArray, int* numNormals, int vertex_index);
 
 
 // Delete normals from a list, whenever they are
@@ -13,6 +42,13 @@ void check_opposite_vectors (nodePtr normal_list, facePtr faceArray, vertexPtr v
 void remove_duplicate_normals (nodePtr* normal_list);
 
 
+// Check whether a polygon of normals goes only once around
+//  'center', in CCW order, always moving forward.
+// Such a polygon is simple and needs no splitting, and its
+//  area is the angle deficit of the vertex.
+boolean is_simple_spherical_polygon (nodePtr normalList, int numNormals, vectorPtr center);
+
+
 // Locate loops in the normal star of a vertex.
 // This will be the case mostly of saddle type vertices.
 // Test whether the pattern of vertices repeats itself
@@ -30,17 +66,31 @@ nodePtr findBasicIntersections (nodePtr normalList, int numNormals, int* numBasi
 
 // Compare a new intersection against those already
 //  stored in a list.
-void matchIntersectionPairs (int vectorId_1, int vectorId_2, int vectorId_3, int vectorId_4, int new_Id);
+void matchIntersectionPairs (sphericalContextPtr context, int vectorId_1, int vectorId_2, int vectorId_3, int vectorId_4, int new_Id);
 
 
 // Set the list of intersection of a single segment
 //  in the correct order.
-void orderIntersectionsList (nodePtr* tmpList, int tmpLength, vectorPtr vector1, vectorPtr intersection);
+void orderIntersectionsList (polygonArrayPtr segment, vectorPtr vector1, vectorPtr intersection);
 
 
 // Free the memory used for the
 //  matching of intersection pairs.
-void free_pairs_list (void);
+void free_pairs_list (sphericalContextPtr context);
+
+
+// Find the pairs of arcs of a polygon that may intersect,
+//  comparing the spherical caps around the arcs.
+// 'arc_normals' has the cross product of the endpoints of each arc.
+// Returns the arcs paired with arc 'i' in increasing order,
+//  from 'candidates[offsets[i]]' to 'candidates[offsets[i+1]-1]'.
+int* find_candidate_arc_pairs (polygonArrayPtr polygon, vectorPtr arc_normals, int** offsets);
+
+
+// Check whether the endpoints of an arc are on
+//  opposite sides of the plane of another arc.
+// Returns FALSE only when the arcs can not intersect.
+boolean arc_crosses_plane (vectorPtr vector1, vectorPtr vector2, vectorPtr plane_normal);
 
 
 // Divide a self intersecting spherical polygon into 
@@ -49,7 +99,7 @@ void free_pairs_list (void);
 //  have self intersections.
 // Returns a list of the normals of the object, plus
 //  the vectors where the arcs intersect.
-nodePtr findArcIntersections (nodePtr faceList, boolean* arcsIntersect);
+nodePtr findArcIntersections (sphericalContextPtr context, nodePtr faceList, boolean* arcsIntersect);
 
 
 // Do an extra check, to see if the neighbours are really
@@ -63,7 +113,7 @@ boolean double_check_intersection (vectorPtr vector1_1, vectorPtr vector1, vecto
 //  'splitSphericalPolygon' for each possibility
 // Return the list of polygons that contains the
 //  polygon with the longest perimeter.
-nodePtr testPolygonSplit (nodePtr polygonList, nodePtr normalList);
+nodePtr testPolygonSplit (sphericalContextPtr context, nodePtr polygonList, nodePtr normalList);
 
 
 // Measure the length of the arcs that delimit a
@@ -81,12 +131,16 @@ angleType find_spherical_polygon_orientation (nodePtr polygon_list, int* orienta
 //  simple ones, removing any self intersections.
 // Return a list of lists of normals. Each list will
 //  represent a simple polygon.
-nodePtr splitSphericalPolygon (nodePtr polygonList, nodePtr normalList);
+nodePtr splitSphericalPolygon (sphericalContextPtr context, nodePtr polygonList, nodePtr normalList);
+
 
+// Get a vector of the polygon being split.
+// Positions before the beginning refer to the first vector.
+vectorPtr split_polygon_vector (polygonArrayPtr polygon, int index);
 
 // Delete from the list of pairs those for which the
-//  vectors involved are no longer present in the list.
-void discard_redundant_pairs (int* remainingPairs, nodePtr normalList, int listLength);
+//  vectors involved are no longer present in the polygon.
+void discard_redundant_pairs (sphericalContextPtr context, int* remainingPairs, polygonArrayPtr polygon);
 
 
 // Compute the area of a polygon that lies on the surface of
@@ -110,7 +164,8 @@ double findSphericalAngle (vectorPtr vector1, vectorPtr vector2, vectorPtr vecto
 
 // Find a vector tangent to a sphere, that lies on the same plane
 //  as two radius vectors of the unit sphere.
-vectorPtr findSphereTangent (vectorPtr mainVector, vectorPtr referenceVector);
+// The tangent is returned by value.
+vectorStruct findSphereTangent (vectorPtr mainVector, vectorPtr referenceVector);
 
 
 // Determine the vector where two great circles of a sphere intersect.
@@ -121,6 +176,11 @@ vectorPtr findSphereTangent (vectorPtr mainVector, vectorPtr referenceVector);
 vectorPtr arcIntersection (vectorPtr arc1vector1, vectorPtr arc1vector2, vectorPtr arc2vector1, vectorPtr arc2vector2, boolean* intersect, int* endpoint);
 
 
+// Same as 'arcIntersection', with the cross products of the
+//  endpoints of each arc already computed.
+vectorPtr arc_intersection_from_normals (vectorPtr arc1vector1, vectorPtr arc1vector2, vectorPtr arc1_normal, vectorPtr arc2vector1, vectorPtr arc2vector2, vectorPtr arc2_normal, boolean* intersect, int* endpoint);
+
+
 // Remove the vertices from a polygon which are
 //  collinear with the adjacent vertices.
 // Returns a copy of the parameter list, minus
@@ -130,7 +190,8 @@ nodePtr remove_collinear_vertices (nodePtr polygonList);
 
 // Divide a spherical polygon into triangles,
 //  to facilitate its rendering.
-void triangulateSphericalPolygon (nodePtr polygonList, spinType polygonOrientation);
+// The triangles are added to the list of the context.
+void triangulateSphericalPolygon (sphericalContextPtr context, nodePtr polygonList, spinType polygonOrientation);
 
 
 // Divide a spherical polygon into two simpler polygons.
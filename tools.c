@@ -1,5 +1,20 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <math.h>
+#include <zlib.h>
+
 #include "tools.h"
 
+// Size of the blocks read from compressed files and pipes.
+#define STREAM_BLOCK_SIZE	(1 << 20)
+
+// Minimum time in seconds between updates of the progress display.
+#define PROGRESS_INTERVAL	0.25
+
 
 // Memory allocation with validation.
 void* xmalloc (size_t size)
@@ -29,6 +44,575 @@ FILE* xfopen (char* fileName, char* mode)
 }
 
 
+// Map a whole file into memory, for read only access.
+// The length of the file is returned in 'length'.
+// Empty files give NULL, with a length of 0.
+// Returns FALSE if the file can not be opened or mapped.
+static boolean mapFile (char* fileName, char** data, size_t* length)
+{
+	int				fileDescriptor;
+	struct stat		fileStatus;
+
+	*data = NULL;
+	*length = 0;
+
+	fileDescriptor = open (fileName, O_RDONLY);
+	if (fileDescriptor < 0)
+		return (FALSE);
+
+	if (fstat (fileDescriptor, &fileStatus) < 0)
+	{
+		close (fileDescriptor);
+		return (FALSE);
+	}
+
+	*length = (size_t) fileStatus.st_size;
+
+	if (*length > 0)
+	{
+		*data = (char*) mmap (NULL, *length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+		if (*data == MAP_FAILED)
+		{
+			*data = NULL;
+			close (fileDescriptor);
+			return (FALSE);
+		}
+
+		// The file will be read from beginning to end.
+		madvise (*data, *length, MADV_SEQUENTIAL);
+	}
+
+	close (fileDescriptor);
+
+	return (TRUE);
+}
+
+
+// Map a whole file into memory, for read only access.
+// The length of the file is returned in 'length'.
+// Empty files return NULL, with a length of 0.
+char* xmapfile (char* fileName, size_t* length)
+{
+	char*	data = NULL;
+
+	if (!mapFile (fileName, &data, length)) {
+		printf ("Unable to map file: '%s'. Exiting.\n", fileName);
+		exit (1);
+	}
+
+	return (data);
+}
+
+
+// Release a file mapped with 'xmapfile'.
+void xunmapfile (char* data, size_t length)
+{
+	if (data != NULL)
+		munmap (data, length);
+}
+
+
+// Check whether a file has to be read as a stream, instead of
+//  being mapped into memory.
+// This is the case for the standard input, given as '-', and
+//  for files compressed with gzip, whose suffix may be in any case.
+boolean isStreamFile (char* fileName)
+{
+	size_t		length = strlen (fileName);
+
+	if (!strcmp (fileName, "-"))
+		return (TRUE);
+
+	if ( (length > 3) && !strcasecmp (fileName + length - 3, ".gz") )
+		return (TRUE);
+
+	return (FALSE);
+}
+
+
+// Read a whole stream into memory, in large blocks.
+// Data compressed with gzip is decoded while it is read, and any
+//  other data is copied as it is.
+// The name '-' stands for the standard input.
+// The buffer must be released with 'free'.
+// Returns FALSE if the stream can not be opened or decoded.
+static boolean readStream (char* fileName, char** data, size_t* length)
+{
+	gzFile		stream;
+	size_t		capacity = STREAM_BLOCK_SIZE;
+	int			bytesRead;
+
+	*data = NULL;
+	*length = 0;
+
+	if (!strcmp (fileName, "-"))
+		stream = gzdopen (dup (STDIN_FILENO), "rb");
+	else
+		stream = gzopen (fileName, "rb");
+
+	if (stream == NULL)
+		return (FALSE);
+
+	gzbuffer (stream, STREAM_BLOCK_SIZE);
+
+	*data = (char*) xmalloc (capacity);
+
+	do
+	{
+		if (capacity - *length < STREAM_BLOCK_SIZE)
+		{
+			capacity *= 2;
+			*data = (char*) realloc (*data, capacity);
+			if (*data == NULL) {
+				printf ("Unable to allocate memory. Exiting.\n");
+				exit (1);
+			}
+		}
+
+		bytesRead = gzread (stream, *data + *length, STREAM_BLOCK_SIZE);
+
+		if (bytesRead < 0)
+		{
+			gzclose (stream);
+			free (*data);
+			*data = NULL;
+			*length = 0;
+			return (FALSE);
+		}
+
+		*length += bytesRead;
+	} while (bytesRead > 0);
+
+	gzclose (stream);
+
+	return (TRUE);
+}
+
+
+// Read a whole stream into memory, in large blocks.
+// The buffer returned must be released with 'free'.
+char* xreadstream (char* fileName, size_t* length)
+{
+	char*	data = NULL;
+
+	if (!readStream (fileName, &data, length)) {
+		printf ("Unable to read file: '%s'. Exiting.\n", fileName);
+		exit (1);
+	}
+
+	return (data);
+}
+
+
+// Get the contents of a file in memory.
+// Plain files are mapped, while compressed files and pipes
+//  are read as streams.
+// Returns FALSE, with a message, if the file can not be read.
+boolean loadFile (char* fileName, char** data, size_t* length)
+{
+	boolean		success;
+
+	if (isStreamFile (fileName))
+		success = readStream (fileName, data, length);
+	else
+		success = mapFile (fileName, data, length);
+
+	if (!success)
+		printf ("Unable to read file: '%s'.\n", fileName);
+
+	return (success);
+}
+
+
+// Get the contents of a file in memory, or stop the
+//  program if it can not be read.
+char* xloadfile (char* fileName, size_t* length)
+{
+	char*	data = NULL;
+
+	if (!loadFile (fileName, &data, length)) {
+		printf ("Exiting.\n");
+		exit (1);
+	}
+
+	return (data);
+}
+
+
+// Release the contents of a file obtained with 'xloadfile'.
+void xunloadfile (char* fileName, char* data, size_t length)
+{
+	if (isStreamFile (fileName))
+		free (data);
+	else
+		xunmapfile (data, length);
+}
+
+
+// Advance over spaces, tabs and carriage returns,
+//  without going past the end of the current line.
+char* skipBlanks (char* cursor, char* end)
+{
+	while ( (cursor < end) && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') )
+		cursor++;
+
+	return (cursor);
+}
+
+
+// Advance to the beginning of the next line.
+char* skipLine (char* cursor, char* end)
+{
+	cursor = (char*) memchr (cursor, '\n', end - cursor);
+
+	if (cursor == NULL)
+		return (end);
+
+	return (cursor + 1);
+}
+
+
+// Read an integer from a memory buffer.
+// Leading blanks are skipped.
+// Returns a pointer to the first character after the number,
+//  or the original position if no number was found, in
+//  which case 'value' is set to 0.
+char* scanInteger (char* cursor, char* end, int* value)
+{
+	char*	start = cursor;
+	int		sign = 1;
+	int		number = 0;
+
+	cursor = skipBlanks (cursor, end);
+
+	if ( (cursor < end) && (*cursor == '-' || *cursor == '+') )
+	{
+		if (*cursor == '-')
+			sign = -1;
+		cursor++;
+	}
+
+	if ( (cursor == end) || (*cursor < '0') || (*cursor > '9') )
+	{
+		*value = 0;
+		return (start);
+	}
+
+	while ( (cursor < end) && (*cursor >= '0') && (*cursor <= '9') )
+	{
+		number = number * 10 + (*cursor - '0');
+		cursor++;
+	}
+
+	*value = sign * number;
+
+	return (cursor);
+}
+
+
+// Read a floating point number from a memory buffer.
+// Leading blanks are skipped.
+// Numbers with up to 19 significant digits and small exponents
+//  are converted directly, using a single multiplication or
+//  division by an exact power of ten, which gives the same
+//  correctly rounded result as 'strtod'.
+// Any other number is passed on to 'strtod'.
+// Returns a pointer to the first character after the number,
+//  or the original position if no number was found, in
+//  which case 'value' is set to 0.
+char* scanDouble (char* cursor, char* end, double* value)
+{
+	static const double	powers_of_ten[] = {	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+											1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+											1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	char				token[64];
+	char*				start;
+	char*				token_end;
+	unsigned long long	mantissa = 0;
+	int					digits = 0;
+	int					exponent = 0;
+	int					exponent_value = 0;
+	int					exponent_sign = 1;
+	int					length;
+	boolean				negative = FALSE;
+	boolean				found = FALSE;
+	double				number;
+
+	start = cursor;
+	cursor = skipBlanks (cursor, end);
+
+	if ( (cursor < end) && (*cursor == '-' || *cursor == '+') )
+	{
+		negative = (*cursor == '-');
+		cursor++;
+	}
+
+	// Integer part.
+	while ( (cursor < end) && (*cursor >= '0') && (*cursor <= '9') )
+	{
+		found = TRUE;
+		if (mantissa != 0 || *cursor != '0')
+		{
+			mantissa = mantissa * 10 + (*cursor - '0');
+			digits++;
+			if (digits > 19)
+				break;
+		}
+		cursor++;
+	}
+
+	// Fractional part.
+	if ( (digits <= 19) && (cursor < end) && (*cursor == '.') )
+	{
+		cursor++;
+		while ( (cursor < end) && (*cursor >= '0') && (*cursor <= '9') )
+		{
+			found = TRUE;
+			if (mantissa != 0 || *cursor != '0')
+			{
+				mantissa = mantissa * 10 + (*cursor - '0');
+				digits++;
+				if (digits > 19)
+					break;
+			}
+			exponent--;
+			cursor++;
+		}
+	}
+
+	// Exponent.
+	if ( found && (digits <= 19) && (cursor < end) && (*cursor == 'e' || *cursor == 'E') )
+	{
+		cursor++;
+		if ( (cursor < end) && (*cursor == '-' || *cursor == '+') )
+		{
+			if (*cursor == '-')
+				exponent_sign = -1;
+			cursor++;
+		}
+		if ( (cursor == end) || (*cursor < '0') || (*cursor > '9') )
+			// Not a valid exponent, let 'strtod' decide.
+			digits = 20;
+		while ( (cursor < end) && (*cursor >= '0') && (*cursor <= '9') )
+		{
+			if (exponent_value < 10000)
+				exponent_value = exponent_value * 10 + (*cursor - '0');
+			cursor++;
+		}
+		exponent += exponent_sign * exponent_value;
+	}
+
+	// Fast conversion, exact when the mantissa fits in a double.
+	if ( found && (digits <= 19) && (mantissa <= (1ULL << 53)) && (exponent >= -22) && (exponent <= 22) )
+	{
+		number = (double) mantissa;
+		if (exponent < 0)
+			number /= powers_of_ten[-exponent];
+		else
+			number *= powers_of_ten[exponent];
+
+		*value = negative ? -number : number;
+
+		return (cursor);
+	}
+
+	// Slow conversion of the whole token.
+	cursor = skipBlanks (start, end);
+	length = 0;
+	while ( (cursor + length < end) && (length < 63) &&
+			(cursor[length] != ' ') && (cursor[length] != '\t') &&
+			(cursor[length] != '\r') && (cursor[length] != '\n') )
+		length++;
+	memcpy (token, cursor, length);
+	token[length] = '\0';
+
+	*value = strtod (token, &token_end);
+
+	// Nothing could be converted.
+	if (token_end == token)
+		return (start);
+
+	return (cursor + (token_end - token));
+}
+
+
+// Write an integer into a buffer, in decimal notation.
+// Returns the number of characters written.
+// The buffer is not terminated with a NUL character.
+int formatInteger (char* buffer, int value)
+{
+	char			digits[12];
+	unsigned int	number = (value < 0) ? -(unsigned int) value : (unsigned int) value;
+	int				length = 0;
+	int				count = 0;
+
+	do
+	{
+		digits[count++] = '0' + number % 10;
+		number /= 10;
+	} while (number > 0);
+
+	if (value < 0)
+		buffer[length++] = '-';
+	while (count > 0)
+		buffer[length++] = digits[--count];
+
+	return (length);
+}
+
+
+// Write a double into a buffer, with the shortest representation
+//  that is read back as exactly the same number.
+// Numbers that can be written with few decimals are converted
+//  directly, searching for the smallest number of decimals 'd'
+//  such that round(value * 10^d) / 10^d is equal to the value.
+// Other numbers are written with 'snprintf', using the smallest
+//  precision that gives back the same value.
+// Returns the number of characters written.
+// The buffer must have room for 32 characters, and it is not
+//  terminated with a NUL character.
+int formatDouble (char* buffer, double value)
+{
+	static const double				powers_of_ten[] = {	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+														1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+														1e16, 1e17 };
+	static const unsigned long long	integer_powers[] = {	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+															1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+															10000000000ULL, 100000000000ULL, 1000000000000ULL,
+															10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+															10000000000000000ULL, 100000000000000000ULL };
+	char				text[320];
+	double				magnitude = fabs (value);
+	double				scaled;
+	double				parsed;
+	unsigned long long	mantissa;
+	unsigned long long	integer_part;
+	unsigned long long	fraction;
+	int					decimals;
+	int					length = 0;
+	int					low;
+	int					high;
+	int					precision;
+	int					i;
+
+	// Fast path, for numbers with a short decimal representation.
+	if ( (magnitude < 1e15) && ((magnitude >= 1e-4) || (magnitude == 0.0)) )
+	{
+		for (decimals=0; decimals<=17; decimals++)
+		{
+			scaled = magnitude * powers_of_ten[decimals];
+			if (scaled >= 9007199254740992.0)
+				break;
+
+			mantissa = (unsigned long long) (scaled + 0.5);
+			if ((double) mantissa / powers_of_ten[decimals] != magnitude)
+				continue;
+
+			if (signbit (value))
+				buffer[length++] = '-';
+
+			integer_part = mantissa / integer_powers[decimals];
+			fraction = mantissa % integer_powers[decimals];
+
+			// Digits of the integer part.
+			i = 0;
+			do
+			{
+				text[i++] = '0' + integer_part % 10;
+				integer_part /= 10;
+			} while (integer_part > 0);
+			while (i > 0)
+				buffer[length++] = text[--i];
+
+			// Digits of the fraction, with the leading zeros.
+			if (decimals > 0)
+			{
+				buffer[length++] = '.';
+				for (i=decimals-1; i>=0; i--)
+				{
+					buffer[length + i] = '0' + fraction % 10;
+					fraction /= 10;
+				}
+				length += decimals;
+			}
+
+			return (length);
+		}
+	}
+
+	// Search for the smallest precision that gives
+	//  back the same number.
+	low = 1;
+	high = 17;
+	while (low < high)
+	{
+		precision = (low + high) / 2;
+		snprintf (text, sizeof (text), "%.*g", precision, value);
+		parsed = strtod (text, NULL);
+		if (parsed == value)
+			high = precision;
+		else
+			low = precision + 1;
+	}
+
+	length = snprintf (text, sizeof (text), "%.*g", low, value);
+	memcpy (buffer, text, length);
+
+	return (length);
+}
+
+
+// Number of worker threads to use.
+// Can be set with the environment variable 'GAUSSMAP_THREADS',
+//  otherwise it is the number of processors available.
+int getNumThreads (void)
+{
+	char*	variable = getenv ("GAUSSMAP_THREADS");
+	int		threads = 0;
+
+	if (variable != NULL)
+		threads = atoi (variable);
+
+	if (threads < 1)
+		threads = (int) sysconf (_SC_NPROCESSORS_ONLN);
+
+	if (threads < 1)
+		threads = 1;
+
+	return (threads);
+}
+
+
+// Call 'function' once for each of the 'count' elements in the
+//  array 'arguments', with one thread per element.
+// The first element is processed by the calling thread.
+void runInThreads (void* (*function)(void*), void* arguments, size_t argumentSize, int count)
+{
+	pthread_t*	threads = NULL;
+	char*		argument = (char*) arguments;
+	int			i;
+
+	threads = (pthread_t*) xmalloc (sizeof (pthread_t) * count);
+
+	for (i=1; i<count; i++)
+	{
+		if (pthread_create (&threads[i], NULL, function, argument + i * argumentSize) != 0)
+		{
+			printf ("Unable to create thread. Exiting.\n");
+			exit (1);
+		}
+	}
+
+	function (argument);
+
+	for (i=1; i<count; i++)
+		pthread_join (threads[i], NULL);
+
+	free (threads);
+}
+
+
 // Initialise the seed for the random numbers.
 void initRandom ()
 {
@@ -48,17 +632,39 @@ int randomInt (int max)
 
 
 // Print a spinning progress star and the percent completed.
+// To avoid slowing down long loops with output, the display
+//  is only updated a few times per second, and at the
+//  last steps of the loop.
+// Nothing is shown when there is nothing to count.
 void printProgressStar (int counter, int total)
 {
-	static char	progress_star[] = {'|', '/', '-', '\\'};
-	int			percent = counter * 100 / total;
+	static char				progress_star[] = {'|', '/', '-', '\\'};
+	static int				star = 0;
+	static int				printed_length = 0;
+	static struct timespec	last_update = {0, 0};
+	struct timespec			now;
+	double					elapsed;
+	int						percent;
+	int						i;
 
-	if (percent > 9) {
+	if (total <= 0)
+		return;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	elapsed = (now.tv_sec - last_update.tv_sec) + (now.tv_nsec - last_update.tv_nsec) / 1e9;
+
+	if ( (elapsed < PROGRESS_INTERVAL) && (counter < total - 1) )
+		return;
+
+	last_update = now;
+	percent = (int) ((long long) counter * 100 / total);
+
+	// Erase the previous output.
+	for (i=0; i<printed_length; i++)
 		printf ("\b");
-		fflush (stdout);
-	}
 
-	printf ("\b\b\b\b\b%c %d %%", progress_star[counter%4], percent);
+	printed_length = printf ("%c %d %%", progress_star[star], percent);
+	star = (star + 1) % 4;
 	fflush (stdout);
 }
 
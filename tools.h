@@ -9,9 +9,34 @@
 
 typedef enum {FALSE, TRUE}	boolean;
 
+// Type of the coordinates of vertices and the components of vectors.
+// Compiling with '-D SINGLE_PRECISION' stores them as float, to fit
+//  very large meshes in less memory. The computations with them, and
+//  the sums of angles and areas, are still done with doubles.
+#ifdef SINGLE_PRECISION
+typedef float	real;
+#else
+typedef double	real;
+#endif
+
 
 FILE* xfopen (char* fileName, char* mode);
 void* xmalloc (size_t size);
+char* xmapfile (char* fileName, size_t* length);
+void xunmapfile (char* data, size_t length);
+boolean isStreamFile (char* fileName);
+char* xreadstream (char* fileName, size_t* length);
+boolean loadFile (char* fileName, char** data, size_t* length);
+char* xloadfile (char* fileName, size_t* length);
+void xunloadfile (char* fileName, char* data, size_t length);
+char* skipBlanks (char* cursor, char* end);
+char* skipLine (char* cursor, char* end);
+char* scanInteger (char* cursor, char* end, int* value);
+char* scanDouble (char* cursor, char* end, double* value);
+int formatInteger (char* buffer, int value);
+int formatDouble (char* buffer, double value);
+int getNumThreads (void);
+void runInThreads (void* (*function)(void*), void* arguments, size_t argumentSize, int count);
 int randomInt (int max);
 void initRandom ();
 void printProgressStar (int counter, int total);
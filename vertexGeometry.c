@@ -18,6 +18,7 @@ void initializeVertexDataStructure (vertexDataStruct* vertex_data)
 	// Arrays and lists.
 	vertex_data->normals_around_vertex = NULL;
 	vertex_data->spherical_polygon_list = NULL;
+	vertex_data->num_polygons = 0;
 	vertex_data->spherical_polygon_orientation = NULL;
 
 	// Data for the projection of the star on a plane.
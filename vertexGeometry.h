@@ -10,6 +10,7 @@ typedef struct vertexDataStruct
 	// Arrays and lists.
 	nodePtr			normals_around_vertex;		// Normals of the faces around vertex
 	nodePtr			spherical_polygon_list;
+	int				num_polygons;				// Also known when read from the cache
 	spinType*		spherical_polygon_orientation;
 
 	// Data for the projection of the star on a plane.
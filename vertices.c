@@ -1,4 +1,5 @@
 #include "tools.h"
+#include "arena.h"
 #include "lists.h"
 #include "vertices.h"
 
@@ -8,7 +9,7 @@ int* createIntPointer (int data)
 {
 	int*    intPtr = NULL;
 
-	intPtr = (int*) xmalloc (sizeof (int));
+	intPtr = (int*) scratch_malloc (sizeof (int));
 	*intPtr = data;
 
 	return (intPtr);
@@ -20,7 +21,7 @@ vertexPtr createVertex (int id, double newX, double newY, double newZ)
 {
 	vertexPtr	newVertex = NULL;
 
-	newVertex = (vertexPtr) xmalloc (sizeof (vertexStruct));
+	newVertex = (vertexPtr) scratch_malloc (sizeof (vertexStruct));
 
 	newVertex->vertexId = id;
 	newVertex->x = newX;
@@ -1,13 +1,15 @@
 // Data structures
 
 // VERTEX
+// The two integers are kept together, so that the
+//  structure does not need padding.
 typedef struct vertexStruct
 {
 	int     vertexId;
-	double  x;
-	double  y;
-	double  z;
 	int     extra;
+	real    x;
+	real    y;
+	real    z;
 } vertexStruct;
 
 typedef vertexStruct* vertexPtr;